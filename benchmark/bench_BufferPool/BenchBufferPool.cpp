@@ -0,0 +1,121 @@
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include "CStringBufferPool.h"
+
+// 4 worker threads pass 2M log lines of ~80 characters in batches of 254 to an I/O thread
+constexpr int numThreads = 4;
+constexpr int batchesPerThread = 2000;
+constexpr const char *line = "2024-05-01T12:00:00.000Z INFO request handled: GET /api/v1/items/12345 200 OK";
+typedef CStringBuffer<32 * 1024, 254> Buffer;
+
+CStringBufferPool<Buffer, 16> pool;
+
+// baseline: each worker fills its own buffer and copies the strings into the I/O thread's buffer
+Buffer workerBuffers[numThreads];
+Buffer ioBuffer;
+std::mutex mutex;
+
+void fill(Buffer &buffer) {
+    while (buffer.push(line).isAllocated()) {
+    }
+}
+
+void produceCopying(int t, long &copied) {
+    Buffer &buffer = workerBuffers[t];
+    for (int i = 0; i < batchesPerThread; ++i) {
+        fill(buffer);
+        // wait until the I/O thread took the previous batch, then copy the whole batch at once
+        while (true) {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (ioBuffer.numstrings() == 0) {
+                for (int j = 0; j < buffer.numstrings(); ++j) {
+                    ioBuffer.push(buffer.getRawString(j));
+                    copied += buffer.getRawStringCapacity(j);
+                }
+                break;
+            }
+            lock.unlock();
+            std::this_thread::yield();
+        }
+        buffer.removeAll();
+    }
+}
+
+long consumeCopying(std::atomic<int> &running) {
+    long lines = 0;
+    while (true) {
+        bool done = running == 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            lines += ioBuffer.numstrings();
+            ioBuffer.removeAll();
+        }
+        if (done) {
+            return lines;
+        }
+        std::this_thread::yield();
+    }
+}
+
+void produceHandoff(int t, long &copied) {
+    for (int i = 0; i < batchesPerThread;) {
+        Buffer *buffer = pool.acquire();
+        if (buffer == nullptr) {
+            std::this_thread::yield();
+            continue;
+        }
+        fill(*buffer);
+        pool.handoff(buffer);
+        i++;
+    }
+}
+
+long consumeHandoff(std::atomic<int> &running) {
+    long lines = 0;
+    CStringBufferPool<Buffer, 16>::Batch batch;
+    while (true) {
+        bool done = running == 0;
+        while (pool.receive(batch)) {
+            lines += batch.last - batch.first;
+            pool.recycle(batch.buffer);
+        }
+        if (done) {
+            return lines;
+        }
+        std::this_thread::yield();
+    }
+}
+
+template<typename Produce, typename Consume>
+void measure(const char *name, Produce produce, Consume consume) {
+    std::atomic<int> running{numThreads};
+    long copied[numThreads]{};
+    auto start = std::chrono::steady_clock::now();
+    std::thread producers[numThreads];
+    for (int t = 0; t < numThreads; ++t) {
+        producers[t] = std::thread([&, t] {
+            produce(t, copied[t]);
+            running--;
+        });
+    }
+    long lines = consume(running);
+    for (std::thread &producer : producers) {
+        producer.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    long totalCopied = 0;
+    for (long bytes : copied) {
+        totalCopied += bytes;
+    }
+    double seconds = std::chrono::duration<double>(end - start).count();
+    printf("%-24s %8.2f M lines/s %8.2f bytes copied/line (%ld lines)\n", name, lines / seconds / 1e6,
+           (double)totalCopied / lines, lines);
+}
+
+int main() {
+    measure("push(raw()) copy", produceCopying, consumeCopying);
+    measure("pool handoff", produceHandoff, consumeHandoff);
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include <chrono>
+#include <new>
+#include <string>
+#include <vector>
+#include "CStringBufferResource.h"
+
+// per request: 20 header values kept in a vector of strings next to the CStrings of the request
+constexpr int numRequests = 200000;
+constexpr int numHeaders = 20;
+constexpr const char *value = "application/json; charset=utf-8; q=0.9";
+typedef CStringBuffer<8 * 1024, 64> Buffer;
+
+long heapCalls = 0;
+
+void *operator new(std::size_t size) {
+    heapCalls++;
+    void *p = malloc(size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void *p) noexcept {
+    free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+    free(p);
+}
+
+Buffer buffer;
+
+long handleHeap() {
+    long total = 0;
+    for (int i = 0; i < numRequests; ++i) {
+        CString path = buffer.push("/api/v1/items/12345");
+        std::vector<std::string> headers;
+        headers.reserve(numHeaders);
+        for (int j = 0; j < numHeaders; ++j) {
+            headers.emplace_back(value);
+        }
+        total += headers.size() + path.length();
+        buffer.removeAll();
+    }
+    return total;
+}
+
+long handleBuffer() {
+    long total = 0;
+    CStringBufferResource<Buffer> resource(buffer);
+    for (int i = 0; i < numRequests; ++i) {
+        CString path = buffer.push("/api/v1/items/12345");
+        {
+            std::pmr::vector<std::pmr::string> headers(&resource);
+            headers.reserve(numHeaders);
+            for (int j = 0; j < numHeaders; ++j) {
+                headers.emplace_back(value);
+            }
+            total += headers.size() + path.length();
+        }
+        buffer.removeAll();
+        resource.release();
+    }
+    return total;
+}
+
+void measure(const char *name, long (*fn)()) {
+    heapCalls = 0;
+    auto start = std::chrono::steady_clock::now();
+    long result = fn();
+    auto end = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    printf("%-28s %8.1f ns/request %6.2f heap calls/request (result %ld)\n", name, seconds * 1e9 / numRequests,
+           (double)heapCalls / numRequests, result);
+}
+
+int main() {
+    measure("std::vector<std::string>", handleHeap);
+    measure("CStringBufferResource", handleBuffer);
+    return 0;
+}
@@ -0,0 +1,60 @@
+#include <chrono>
+#include <stdlib.h>
+#include "CStringBufferView.h"
+
+// the same sequence of pushes, appends, searches, moves and removals of 64 short strings on the template buffer and
+// a view of equal size
+constexpr int numOperations = 5000000;
+constexpr int capacity = 16 * 1024;
+
+CStringBuffer<capacity, 64> templateBuffer;
+char data[capacity];
+alignas(4) char metadata[CStringBufferView::metadataSize(64)];
+CStringBufferView view(data, capacity, metadata, sizeof(metadata), 64);
+
+template<typename Buffer>
+long run(Buffer &buffer) {
+    CString strings[64];
+    long total = 0;
+    buffer.removeAll();
+    srand(1);
+    for (int i = 0; i < numOperations; ++i) {
+        CString &string = strings[rand() % 64];
+        switch (rand() % 4) {
+            case 0:
+                buffer.remove(string);
+                string = buffer.push("GET /api/v1/items");
+                break;
+            case 1:
+                if (string.length() > 64) {
+                    string.clear();
+                }
+                string.append("/12345");
+                break;
+            case 2:
+                total += string.indexOf('/');
+                break;
+            default:
+                buffer.moveToTop(string);
+        }
+    }
+    return total + buffer.allocatedBytes();
+}
+
+template<typename Buffer>
+void measure(const char *name, Buffer &buffer) {
+    auto start = std::chrono::steady_clock::now();
+    long result = run(buffer);
+    auto end = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    printf("%-24s %8.1f ns/operation (result %ld)\n", name, seconds * 1e9 / numOperations, result);
+}
+
+int main() {
+    for (int i = 0; i < 2; ++i) {
+        measure("CStringBuffer<16K, 64>", templateBuffer);
+        measure("CStringBufferView", view);
+    }
+    return 0;
+}
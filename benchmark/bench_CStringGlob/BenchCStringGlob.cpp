@@ -0,0 +1,93 @@
+#include <chrono>
+#include <regex>
+#include <string>
+#include "CStringGlob.h"
+
+// 1M path matches: 1000 request paths matched 1000 times, every third path matches
+constexpr int numPaths = 1000;
+constexpr int rounds = 1000;
+const char *pattern = "/api/*/items/?*";
+const char *regexPattern = "/api/.*/items/..*";
+
+CStringBuffer<numPaths * 32, 254> buffer;
+CString paths[numPaths];
+
+void preparePaths() {
+    char path[32];
+    for (int i = 0; i < numPaths; ++i) {
+        switch (i % 3) {
+            case 0:
+                snprintf(path, sizeof(path), "/api/v%d/items/%d", i % 4, i);
+                break;
+            case 1:
+                snprintf(path, sizeof(path), "/api/v%d/users/%d", i % 4, i);
+                break;
+            default:
+                snprintf(path, sizeof(path), "/static/img/%d.png", i);
+                break;
+        }
+
+        // more paths than strings per buffer: reuse the last ones
+        paths[i] = i < 254 ? buffer.push(path) : paths[i % 254];
+    }
+}
+
+// baseline: routing layer copying the path to a std::string and matching it with std::regex
+int regexMatch() {
+    static const std::regex regex(regexPattern);
+    int hits = 0;
+    for (const CString &path : paths) {
+        std::string copy(path.raw(), path.length());
+        hits += std::regex_match(copy, regex);
+    }
+    return hits;
+}
+
+int matchesGlob() {
+    int hits = 0;
+    for (const CString &path : paths) {
+        hits += path.matchesGlob(pattern);
+    }
+    return hits;
+}
+
+int precompiledGlob() {
+    static const CStringGlob<> glob(pattern);
+    int hits = 0;
+    for (const CString &path : paths) {
+        hits += glob.matches(path);
+    }
+    return hits;
+}
+
+int precompiledGlobWithCaptures() {
+    static const CStringGlob<> glob(pattern);
+    CStringGlobCapture captures[3];
+    int hits = 0;
+    for (const CString &path : paths) {
+        hits += glob.matches(path, captures);
+    }
+    return hits;
+}
+
+template<typename Fn>
+void measure(const char *name, Fn fn) {
+    int hits = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i) {
+        hits += fn();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double nsPerMatch = std::chrono::duration<double, std::nano>(end - start).count() / rounds / numPaths;
+    printf("%-24s %8.1f ns/match (hits: %d)\n", name, nsPerMatch, hits / rounds);
+}
+
+int main() {
+    preparePaths();
+    measure("std::regex on copy", regexMatch);
+    measure("matchesGlob", matchesGlob);
+    measure("precompiled glob", precompiledGlob);
+    measure("precompiled + captures", precompiledGlobWithCaptures);
+    return 0;
+}
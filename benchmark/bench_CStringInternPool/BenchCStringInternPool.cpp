@@ -0,0 +1,80 @@
+#include <chrono>
+#include "CStringInternPool.h"
+
+// 10k lookups with a 90% hit rate: 9 of 10 lookups refer to one of the preloaded header names
+constexpr int lookups = 10000;
+constexpr int rounds = 100;
+constexpr int numNames = 20;
+const char *names[numNames] = {
+        "Host", "Accept", "Accept-Encoding", "Accept-Language", "Cache-Control", "Connection", "Content-Length",
+        "Content-Type", "Cookie", "Date", "ETag", "Expires", "If-Modified-Since", "If-None-Match", "Last-Modified",
+        "Location", "Pragma", "Referer", "Server", "User-Agent"
+};
+
+char keys[lookups][24];
+
+void prepareKeys() {
+    for (int i = 0; i < lookups; ++i) {
+        if (i % 10 == 9) {
+            snprintf(keys[i], sizeof(keys[i]), "X-Miss-%d", i);
+        } else {
+            snprintf(keys[i], sizeof(keys[i]), "%s", names[(i * 7) % numNames]);
+        }
+    }
+}
+
+// baseline: push the key, compare it with all known strings and pop it again if found
+int pushAndCompare() {
+    CStringBuffer<1024, 32> buffer;
+    for (const char *name : names) {
+        buffer.push(name);
+    }
+
+    int hits = 0;
+    for (auto &key : keys) {
+        CString cur = buffer.push(key);
+        bool found = false;
+        for (int i = 0; i < numNames; ++i) {
+            if (cur.compare(buffer.getRawString(i)) == 0) {
+                found = true;
+                break;
+            }
+        }
+        buffer.pop();
+        hits += found;
+    }
+    return hits;
+}
+
+int internPoolFind() {
+    CStringInternPool<1024, 32> pool;
+    for (const char *name : names) {
+        pool.intern(name);
+    }
+
+    int hits = 0;
+    for (auto &key : keys) {
+        hits += pool.find(key) != INVALID_STRING_IDX;
+    }
+    return hits;
+}
+
+template<typename Fn>
+void measure(const char *name, Fn fn) {
+    int hits = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i) {
+        hits += fn();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double nsPerLookup = std::chrono::duration<double, std::nano>(end - start).count() / rounds / lookups;
+    printf("%-20s %8.1f ns/lookup (hits: %d)\n", name, nsPerLookup, hits / rounds);
+}
+
+int main() {
+    prepareKeys();
+    measure("push + compare", pushAndCompare);
+    measure("intern pool", internPoolFind);
+    return 0;
+}
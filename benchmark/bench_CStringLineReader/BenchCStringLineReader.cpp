@@ -0,0 +1,59 @@
+#include <chrono>
+#include <fcntl.h>
+#include "CStringLineReader.h"
+
+// counts the lines of the given file (e.g. created by `seq -f "line %g of a text file with some content" 1e7`)
+// compared to a `wc -l` like loop: read 64 KiB chunks and count line feeds using memchr
+static char chunk[64 * 1024];
+static CStringBuffer<1024 * 1024, 254> buffer;
+
+long countLikeWc(int fd) {
+    long lines = 0;
+    for (ssize_t count; (count = read(fd, chunk, sizeof(chunk))) > 0;) {
+        for (const char *c = chunk, *end = chunk + count; (c = (const char *)memchr(c, '\n', end - c)) != nullptr; ++c) {
+            lines++;
+        }
+    }
+    return lines;
+}
+
+long readLines(int fd) {
+    long lines = 0;
+    CStringLineReader<CStringBuffer<1024 * 1024, 254>> reader(buffer, fd);
+    while (true) {
+        if (reader.readLine().isAllocated()) {
+            lines++;
+        } else if (reader.isEof() || reader.isError() || buffer.numstrings() == 0) {
+            break;
+        } else {
+            buffer.removeAll();
+        }
+    }
+    buffer.removeAll();
+    return lines;
+}
+
+template<typename Fn>
+void measure(const char *name, const char *path, Fn fn) {
+    int fd = open(path, O_RDONLY);
+    auto start = std::chrono::steady_clock::now();
+    long lines = fn(fd);
+    auto end = std::chrono::steady_clock::now();
+    off_t size = lseek(fd, 0, SEEK_END);
+    close(fd);
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    printf("%-24s %8.2f GB/s (%ld lines)\n", name, size / seconds / 1e9, lines);
+}
+
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        printf("usage: %s <file>\n", argv[0]);
+        return 1;
+    }
+    measure("memchr count (wc -l)", argv[1], countLikeWc);
+    measure("CStringLineReader", argv[1], readLines);
+    measure("memchr count (wc -l)", argv[1], countLikeWc);
+    measure("CStringLineReader", argv[1], readLines);
+    return 0;
+}
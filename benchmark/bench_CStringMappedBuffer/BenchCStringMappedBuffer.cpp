@@ -0,0 +1,82 @@
+#include <chrono>
+#include "CStringLineReader.h"
+#include "CStringMappedBuffer.h"
+
+// startup time of a string table of the given size: opening a CStringMappedBuffer compared to reading the same
+// strings from a text file (one line per string) into a CStringBuffer
+static constexpr int tableSize = 500 * 1000 * 1000;
+static constexpr int numStrings = 254;
+static CStringBuffer<tableSize + 64 * 1024, numStrings> buffer;
+
+template<typename Fn>
+void measure(const char *name, Fn fn) {
+    auto start = std::chrono::steady_clock::now();
+    long result = fn();
+    auto end = std::chrono::steady_clock::now();
+    printf("%-32s %10.3f ms (%ld)\n", name, std::chrono::duration<double>(end - start).count() * 1e3, result);
+}
+
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        printf("usage: %s <path prefix>\n", argv[0]);
+        return 1;
+    }
+    char mappedPath[256];
+    char textPath[256];
+    snprintf(mappedPath, sizeof(mappedPath), "%s.bin", argv[1]);
+    snprintf(textPath, sizeof(textPath), "%s.txt", argv[1]);
+
+    measure("create mapped + sync", [&] {
+        CStringMappedBuffer mapped;
+        if (!mapped.create(mappedPath, tableSize, numStrings)) {
+            return -1L;
+        }
+        for (int i = 0; i < numStrings; ++i) {
+            CString string = mapped.allocate(tableSize / numStrings - 1);
+            memset(string.raw(), 'a' + i % 26, string.rawMaxLength());
+        }
+        mapped.sync();
+
+        int fd = open(textPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        long written = 0;
+        for (int i = 0; i < numStrings; ++i) {
+            written += write(fd, mapped.getRawString(i), mapped.getRawStringCapacity(i) - 1);
+            written += write(fd, "\n", 1);
+        }
+        close(fd);
+        return written;
+    });
+
+    for (int round = 0; round < 2; ++round) {
+        measure("open mapped", [&] {
+            CStringMappedBuffer mapped;
+            mapped.open(mappedPath);
+            return (long)mapped.getRawString(numStrings - 1)[0];
+        });
+
+        measure("open mapped + read all", [&] {
+            CStringMappedBuffer mapped;
+            mapped.open(mappedPath);
+            long length = 0;
+            for (int i = 0; i < mapped.numstrings(); ++i) {
+                length += strlen(mapped.getRawString(i));
+            }
+            return length;
+        });
+
+        measure("read text into CStringBuffer", [&] {
+            int fd = open(textPath, O_RDONLY);
+            CStringLineReader<decltype(buffer)> reader(buffer, fd);
+            while (reader.readLine().isAllocated()) {
+            }
+            close(fd);
+            long numstrings = buffer.numstrings();
+            buffer.removeAll();
+            return numstrings;
+        });
+    }
+
+    unlink(mappedPath);
+    unlink(textPath);
+    return 0;
+}
@@ -0,0 +1,114 @@
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include "CStringConcurrentBuffer.h"
+
+// 1 to 32 producer threads stage 2M log lines of ~80 characters, a single consumer drains them concurrently
+constexpr int totalLines = 2000000;
+constexpr const char *line = "2024-05-01T12:00:00.000Z INFO request handled: GET /api/v1/items/12345 200 OK";
+
+CStringConcurrentBuffer<256 * 1024, 2048> concurrentBuffer;
+
+// baseline: CStringBuffer guarded by a mutex, the consumer takes all strings and removes them
+CStringBuffer<32 * 1024, 254> lockedBuffer;
+std::mutex mutex;
+
+long produceConcurrent(int lines) {
+    for (int i = 0; i < lines;) {
+        if (concurrentBuffer.push(line)) {
+            i++;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    return 0;
+}
+
+long consumeConcurrent(std::atomic<int> &running) {
+    long bytes = 0;
+    auto consume = [&](const char *string, int length) { bytes += length; };
+    while (running > 0) {
+        if (concurrentBuffer.drain(consume) == 0) {
+            std::this_thread::yield();
+        }
+    }
+    while (concurrentBuffer.drain(consume) > 0) {
+    }
+    return bytes;
+}
+
+long produceLocked(int lines) {
+    for (int i = 0; i < lines;) {
+        bool pushed;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pushed = lockedBuffer.push(line).isAllocated();
+        }
+        if (pushed) {
+            i++;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    return 0;
+}
+
+long consumeLocked(std::atomic<int> &running) {
+    long bytes = 0;
+    auto consumeAll = [&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        int numstrings = lockedBuffer.numstrings();
+        for (int i = 0; i < numstrings; ++i) {
+            bytes += lockedBuffer.getRawStringCapacity(i) - 1;
+        }
+        lockedBuffer.removeAll();
+        return numstrings;
+    };
+    while (running > 0) {
+        if (consumeAll() == 0) {
+            std::this_thread::yield();
+        }
+    }
+    consumeAll();
+    return bytes;
+}
+
+// returns lines per second, printed relative to the single producer run of the same variant
+template<typename Produce, typename Consume>
+double measure(const char *name, int numThreads, double singleProducer, Produce produce, Consume consume) {
+    std::atomic<int> running{numThreads};
+    auto start = std::chrono::steady_clock::now();
+    std::thread producers[32];
+    for (int t = 0; t < numThreads; ++t) {
+        producers[t] = std::thread([&] {
+            produce(totalLines / numThreads);
+            running--;
+        });
+    }
+    long bytes = consume(running);
+    for (int t = 0; t < numThreads; ++t) {
+        producers[t].join();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    double linesPerSecond = totalLines / seconds;
+    printf("%-24s %2d producers %8.2f M lines/s %5.2fx (%ld bytes)\n", name, numThreads, linesPerSecond / 1e6,
+           singleProducer > 0 ? linesPerSecond / singleProducer : 1.0, bytes);
+    return linesPerSecond;
+}
+
+int main() {
+    printf("%u hardware threads\n", std::thread::hardware_concurrency());
+    double locked = 0;
+    double concurrent = 0;
+    for (int numThreads = 1; numThreads <= 32; numThreads *= 2) {
+        double l = measure("CStringBuffer + mutex", numThreads, locked, produceLocked, consumeLocked);
+        double c = measure("CStringConcurrentBuffer", numThreads, concurrent, produceConcurrent, consumeConcurrent);
+        if (numThreads == 1) {
+            locked = l;
+            concurrent = c;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,57 @@
+#include <chrono>
+#include "CString.h"
+
+// keeps the header names of a request as received and normalized for lookups (trimmed, lower case): most clients send
+// lower case names already, thus the normalized copy usually turns out identical
+constexpr int numRequests = 200000;
+constexpr const char *names[] = {
+    "host", "connection", "accept", "accept-encoding", "accept-language", "cache-control", "pragma", "dnt",
+    "upgrade-insecure-requests", "sec-fetch-dest", "sec-fetch-mode", "sec-fetch-site", "sec-fetch-user",
+    "content-length", "content-type", "x-request-id", "x-retry", "x-priority", "x-region", "x-tenant", "x-shard",
+    "x-trace", "x-debug", "x-api-version", "origin", "referer", "User-Agent", "Authorization", "cookie", "te",
+    "via", "forwarded", "x-forwarded-for", "x-forwarded-proto", "x-real-ip", "priority", "if-none-match",
+    "max-forwards", "expect", " Keep-Alive"
+};
+constexpr int numNames = sizeof(names) / sizeof(names[0]);
+
+CStringBuffer<4096, 100> buffer;
+
+template<bool shared>
+void normalize(int &normalized, int &bytesCopied) {
+    buffer.removeAll();
+    CString received[numNames];
+    for (int i = 0; i < numNames; ++i) {
+        received[i] = buffer.push(names[i]);
+    }
+
+    int allocated = buffer.allocatedBytes();
+    normalized = 0;
+    for (const CString &name : received) {
+        CString copy = shared ? name.cloneShared() : name.clone();
+        normalized += copy.trim().toLower().length() > 0;
+    }
+    bytesCopied = buffer.allocatedBytes() - allocated;
+}
+
+template<bool shared>
+void measure(const char *name) {
+    int normalized = 0;
+    int bytesCopied = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < numRequests; ++i) {
+        normalize<shared>(normalized, bytesCopied);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    printf("%-12s %8.1f ns/request %3d/%d names normalized %4d bytes copied/request\n", name,
+           seconds * 1e9 / numRequests, normalized, numNames, bytesCopied);
+}
+
+int main() {
+    for (int i = 0; i < 2; ++i) {
+        measure<false>("clone");
+        measure<true>("cloneShared");
+    }
+    return 0;
+}
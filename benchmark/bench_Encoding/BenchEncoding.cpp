@@ -0,0 +1,63 @@
+#include <chrono>
+#include "CString.h"
+
+// encodes a 64 KiB payload: hex needs 128 KiB, base64 ~86 KiB
+constexpr int payloadSize = 64 * 1024;
+
+uint8_t payload[payloadSize];
+uint8_t decoded[payloadSize];
+CStringBuffer<6 * payloadSize, 3> buffer;
+
+// baseline: one appendFormat per byte
+int appendFormatHex(CString &str) {
+    for (uint8_t b : payload) {
+        str.appendFormat("%02x", b);
+    }
+    return str.length();
+}
+
+int appendHex(CString &str) {
+    return str.appendHex(payload, payloadSize).length();
+}
+
+int appendBase64(CString &str) {
+    return str.appendBase64(payload, payloadSize).length();
+}
+
+int decodeHex(CString &str) {
+    static CString encoded = buffer.push("").appendHex(payload, payloadSize);
+    return encoded.decodeHex(decoded, payloadSize);
+}
+
+int decodeBase64(CString &str) {
+    static CString encoded = buffer.push("").appendBase64(payload, payloadSize);
+    return encoded.decodeBase64(decoded, payloadSize);
+}
+
+template<typename Fn>
+void measure(const char *name, Fn fn, int rounds = 200) {
+    CString str = buffer.push("");
+    int length = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i) {
+        length += fn(str.clear());
+    }
+    auto end = std::chrono::steady_clock::now();
+    str.deallocate();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    printf("%-24s %8.3f GB/s of payload (length: %d)\n", name, (double)payloadSize * rounds / seconds / 1e9,
+           length / rounds);
+}
+
+int main() {
+    for (int i = 0; i < payloadSize; ++i) {
+        payload[i] = i * 131 + 17;
+    }
+    measure("appendFormat(\"%02x\")", appendFormatHex, 2);
+    measure("appendHex", appendHex);
+    measure("appendBase64", appendBase64);
+    measure("decodeHex", decodeHex);
+    measure("decodeBase64", decodeBase64);
+    return 0;
+}
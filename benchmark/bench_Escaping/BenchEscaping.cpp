@@ -0,0 +1,80 @@
+#include <chrono>
+#include "CString.h"
+
+// escapes 1000 log fields of ~100 characters each, about 2% of the characters need escaping
+constexpr int numFields = 1000;
+constexpr int rounds = 200;
+
+char fields[numFields][128];
+CStringBuffer<256 * 1024, 2> buffer;
+
+void prepareFields() {
+    for (int i = 0; i < numFields; ++i) {
+        snprintf(fields[i], sizeof(fields[i]),
+                 "GET /api/v1/items/%d?filter=\"name\" HTTP/1.1 - user agent: Mozilla/5.0 (X11; Linux x86_64)\t%d", i,
+                 i * 7);
+    }
+}
+
+// baseline: one append per character
+int appendPerCharacter(CString &str) {
+    for (auto &field : fields) {
+        for (const char *c = field; *c != '\0'; ++c) {
+            switch (*c) {
+                case '"':
+                    str.append("\\\"");
+                    break;
+                case '\\':
+                    str.append("\\\\");
+                    break;
+                case '\t':
+                    str.append("\\t");
+                    break;
+                default:
+                    str.append(*c);
+                    break;
+            }
+        }
+        str.clear();
+    }
+    return str.length();
+}
+
+int appendJsonEscaped(CString &str) {
+    for (auto &field : fields) {
+        str.appendJsonEscaped(field);
+        str.clear();
+    }
+    return str.length();
+}
+
+int appendUrlEncoded(CString &str) {
+    for (auto &field : fields) {
+        str.appendUrlEncoded(field);
+        str.clear();
+    }
+    return str.length();
+}
+
+template<typename Fn>
+void measure(const char *name, Fn fn) {
+    CString str = buffer.push("");
+    int length = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i) {
+        length += fn(str);
+    }
+    auto end = std::chrono::steady_clock::now();
+    str.deallocate();
+
+    double nsPerField = std::chrono::duration<double, std::nano>(end - start).count() / rounds / numFields;
+    printf("%-24s %8.1f ns/field (%d)\n", name, nsPerField, length);
+}
+
+int main() {
+    prepareFields();
+    measure("append per character", appendPerCharacter);
+    measure("appendJsonEscaped", appendJsonEscaped);
+    measure("appendUrlEncoded", appendUrlEncoded);
+    return 0;
+}
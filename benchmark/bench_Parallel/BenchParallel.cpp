@@ -0,0 +1,52 @@
+#include <chrono>
+#include "CStringThreadPool.h"
+
+// 200 strings of ~1 MB mixed case text padded with whitespace, 200 MB in total
+constexpr int numStrings = 200;
+constexpr int stringLength = 1024 * 1024;
+typedef CStringBuffer<numStrings * (stringLength + 1), 254> Buffer;
+
+Buffer buffer;
+
+void fill() {
+    static const char text[] = "The Quick Brown Fox Jumps Over The Lazy Dog. ";
+    buffer.removeAll();
+    for (int i = 0; i < numStrings; ++i) {
+        char *area = buffer.unallocatedArea();
+        memset(area, ' ', stringLength);
+        for (int j = 8; j + (int)sizeof(text) < stringLength - 8; j += sizeof(text) - 1) {
+            memcpy(area + j, text, sizeof(text) - 1);
+        }
+        buffer.pushUnallocated(stringLength);
+    }
+}
+
+template<typename Fn>
+void measure(const char *name, int numThreads, Fn fn) {
+    fill();
+    CStringThreadPool<16> pool(numThreads);
+    auto start = std::chrono::steady_clock::now();
+    long result = fn(pool);
+    auto end = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    printf("%-16s %2d threads %8.2f GB/s (result %ld)\n", name, pool.numThreads(),
+           (double)numStrings * stringLength / seconds / 1e9, result);
+}
+
+int main() {
+    printf("%u hardware threads\n", std::thread::hardware_concurrency());
+    for (int numThreads = 1; numThreads <= 16; numThreads *= 2) {
+        measure("toLowerAll", numThreads, [](CStringThreadPool<16> &pool) {
+            buffer.toLowerAll(pool);
+            return 0L;
+        });
+        measure("countMatches", numThreads, [](CStringThreadPool<16> &pool) {
+            return (long)buffer.countMatches(pool, "Fox");
+        });
+        measure("trimAll", numThreads, [](CStringThreadPool<16> &pool) {
+            return (long)buffer.trimAll(pool);
+        });
+    }
+    return 0;
+}
@@ -0,0 +1,63 @@
+#include <chrono>
+#include "CStringRope.h"
+
+// builds a 1 MB response from 2048 fragments of 512 characters; after every 32nd fragment another string is pushed to
+// the same buffer and kept, e.g. a log entry: appending to a CString relocates the whole document above it, the rope
+// starts a new segment instead
+constexpr int numFragments = 2048;
+constexpr int fragmentLength = 512;
+constexpr int interleaveEvery = 32;
+constexpr int numRuns = 5;
+
+CStringBuffer<3 * 1024 * 1024, 254> buffer;
+char fragment[fragmentLength + 1];
+
+long buildCString() {
+    CString document = buffer.push("");
+    for (int i = 0; i < numFragments; ++i) {
+        document.append(fragment);
+        if (i % interleaveEvery == 0) {
+            buffer.pushFormat("fragment %d done", i);
+        }
+    }
+    long length = document.length();
+    buffer.removeAll();
+    return length;
+}
+
+template<bool flatten>
+long buildRope() {
+    CStringRope<128, 1> rope;
+    rope.addBuffer(buffer);
+    for (int i = 0; i < numFragments; ++i) {
+        rope.append(fragment);
+        if (i % interleaveEvery == 0) {
+            buffer.pushFormat("fragment %d done", i);
+        }
+    }
+    long length = flatten ? rope.flatten().length() : rope.length();
+    buffer.removeAll();
+    return length;
+}
+
+void measure(const char *name, long (*build)()) {
+    long result = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < numRuns; ++i) {
+        result += build();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    printf("%-24s %8.3f ms/document (result %ld)\n", name, seconds * 1e3 / numRuns, result);
+}
+
+int main() {
+    memset(fragment, 'x', fragmentLength);
+    for (int i = 0; i < 2; ++i) {
+        measure("CString append", buildCString);
+        measure("CStringRope append", buildRope<false>);
+        measure("CStringRope + flatten", buildRope<true>);
+    }
+    return 0;
+}
@@ -0,0 +1,53 @@
+#include <chrono>
+#include <stdlib.h>
+#include "CStringSegmentedBuffer.h"
+
+// 200 strings of ~400 characters on buffers of ~1 MB: moving a string to the top or removing one moves the bytes
+// following it, that is the rest of the whole buffer or only the rest of its chunk
+constexpr int numOperations = 200000;
+constexpr int numStrings = 200;
+
+CStringBuffer<1024 * 1024, 254> contiguousBuffer;
+CStringSegmentedBuffer<4096, 254, 254> segmentedBuffer;
+char line[4096];
+
+template<typename Buffer>
+long run(Buffer &buffer) {
+    CString strings[numStrings];
+    long total = 0;
+    buffer.removeAll();
+    for (CString &string : strings) {
+        string = buffer.push(line);
+    }
+    srand(1);
+    for (int i = 0; i < numOperations; ++i) {
+        CString &string = strings[rand() % numStrings];
+        if (rand() % 2 == 0) {
+            buffer.moveToTop(string);
+        } else {
+            buffer.remove(string);
+            string = buffer.push(line, 300 + rand() % 100);
+        }
+        total += string.length();
+    }
+    return total;
+}
+
+template<typename Buffer>
+void measure(const char *name, Buffer &buffer) {
+    auto start = std::chrono::steady_clock::now();
+    long result = run(buffer);
+    auto end = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    printf("%-36s %8.1f ns/operation (result %ld)\n", name, seconds * 1e9 / numOperations, result);
+}
+
+int main() {
+    memset(line, 'x', 399);
+    for (int i = 0; i < 2; ++i) {
+        measure("CStringBuffer<1M, 254>", contiguousBuffer);
+        measure("CStringSegmentedBuffer<4K, 254, 254>", segmentedBuffer);
+    }
+    return 0;
+}
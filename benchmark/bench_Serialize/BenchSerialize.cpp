@@ -0,0 +1,60 @@
+#include <chrono>
+#include "CString.h"
+
+// checkpoints and restores a full 64 KB buffer holding 254 strings
+constexpr int rounds = 100000;
+CStringBuffer<64 * 1024, 254> buffer;
+CStringBuffer<64 * 1024, 254> restored;
+char image[70 * 1024];
+int imageLength;
+
+int serialize() {
+    imageLength = 0;
+    return buffer.serialize([](const char *data, int length) {
+        memcpy(image + imageLength, data, length);
+        imageLength += length;
+        return true;
+    });
+}
+
+// baseline: push each string
+int pushAll() {
+    restored.removeAll();
+    for (int i = 0; i < buffer.numstrings(); ++i) {
+        restored.push(buffer.getRawString(i));
+    }
+    return restored.allocatedBytes();
+}
+
+int deserialize() {
+    return restored.deserialize(image, imageLength) ? restored.allocatedBytes() : 0;
+}
+
+template<typename Fn>
+void measure(const char *name, Fn fn) {
+    long total = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i) {
+        total += fn();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    printf("%-24s %8.2f us/op %8.2f GB/s\n", name, seconds * 1e6 / rounds, total / seconds / 1e9);
+}
+
+int main() {
+    char line[251];
+    for (int i = 0; i < 254; ++i) {
+        for (int length = 0; length < 250;) {
+            length += snprintf(line + length, sizeof(line) - length, "%d,", i);
+        }
+        buffer.push(line);
+    }
+
+    measure("serialize", serialize);
+    measure("push per string", pushAll);
+    measure("deserialize", deserialize);
+    printf("image: %d bytes for %d data bytes\n", imageLength, buffer.allocatedBytes());
+    return 0;
+}
@@ -0,0 +1,112 @@
+#include <chrono>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include "CStringSharedBuffer.h"
+
+// a worker process passes 2M log lines of ~80 characters to a collector process in batches of 254
+constexpr int numBatches = 8000;
+constexpr int batchSize = 254;
+constexpr const char *line = "2024-05-01T12:00:00.000Z INFO request handled: GET /api/v1/items/12345 200 OK";
+constexpr const char *name = "/BenchSharedBuffer";
+
+void readFully(int fd, char *dst, int length) {
+    for (int n; length > 0 && (n = read(fd, dst, length)) > 0; dst += n, length -= n) {
+    }
+}
+
+// baseline: lines separated by \n are written to a socket and read by the collector
+long sendSocket(int fd) {
+    static char batch[batchSize * 80];
+    int lineLength = strlen(line);
+    for (int i = 0; i < numBatches; ++i) {
+        int length = 0;
+        for (int j = 0; j < batchSize; ++j) {
+            memcpy(batch + length, line, lineLength);
+            batch[length + lineLength] = '\n';
+            length += lineLength + 1;
+        }
+        write(fd, &length, sizeof(length));
+        write(fd, batch, length);
+    }
+    return 0;
+}
+
+long receiveSocket(int fd) {
+    static char batch[batchSize * 80];
+    long lines = 0;
+    for (int i = 0; i < numBatches; ++i) {
+        int length;
+        readFully(fd, (char *)&length, sizeof(length));
+        readFully(fd, batch, length);
+        for (char *c = batch; (c = (char *)memchr(c, '\n', batch + length - c)) != nullptr; ++c) {
+            lines++;
+        }
+    }
+    return lines;
+}
+
+// shared memory: the socket only signals that a batch is ready or has been processed
+CStringSharedBuffer writer;
+
+long sendShared(int fd) {
+    char signal;
+    for (int i = 0; i < numBatches; ++i) {
+        readFully(fd, &signal, 1);
+        writer.beginWrite();
+        writer.removeAll();
+        for (int j = 0; j < batchSize; ++j) {
+            writer.push(line);
+        }
+        writer.endWrite();
+        write(fd, &signal, 1);
+    }
+    return 0;
+}
+
+long receiveShared(int fd) {
+    CStringSharedBuffer reader;
+    reader.open(name);
+    long lines = 0;
+    char signal = 0;
+    write(fd, &signal, 1);
+    for (int i = 0; i < numBatches; ++i) {
+        readFully(fd, &signal, 1);
+        int count = 0;
+        while (!reader.read([&](uint8_t index, const char *string, int length) { count++; })) {
+            count = 0;
+        }
+        lines += count;
+        if (i + 1 < numBatches) {
+            write(fd, &signal, 1);
+        }
+    }
+    return lines;
+}
+
+void measure(const char *name, long (*send)(int), long (*receive)(int)) {
+    int fds[2];
+    socketpair(AF_UNIX, SOCK_STREAM, 0, fds);
+    auto start = std::chrono::steady_clock::now();
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        send(fds[1]);
+        _exit(0);
+    }
+    close(fds[1]);
+    long lines = receive(fds[0]);
+    waitpid(pid, nullptr, 0);
+    auto end = std::chrono::steady_clock::now();
+    close(fds[0]);
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    printf("%-24s %8.2f M lines/s (%ld lines)\n", name, lines / seconds / 1e6, lines);
+}
+
+int main() {
+    writer.create(name, batchSize * 80, batchSize);
+    measure("socket", sendSocket, receiveSocket);
+    measure("CStringSharedBuffer", sendShared, receiveShared);
+    CStringSharedBuffer::unlink(name);
+    return 0;
+}
@@ -0,0 +1,47 @@
+#include <chrono>
+#include "CString.h"
+
+// validates 64 KiB messages, compared to memchr scanning the same data (memory bandwidth reference). The SIMD kernel
+// requires SSSE3 or NEON, e.g. compile using -mssse3 or -march=native
+constexpr int messageSize = 64 * 1024;
+constexpr int rounds = 20000;
+
+char ascii[messageSize];
+char mixed[messageSize];
+// prevents the compiler from evaluating memchr at compile time
+const char *volatile message = ascii;
+
+void prepareMessages() {
+    const char *text = "{\"name\": \"J\xC3\xBCrgen\", \"city\": \"K\xC3\xB6ln\", \"price\": \"12 \xE2\x82\xAC\"} ";
+    int textLength = strlen(text);
+    for (int i = 0; i < messageSize; ++i) {
+        ascii[i] = 'a' + i % 26;
+    }
+    for (int i = 0; i + textLength <= messageSize; i += textLength) {
+        memcpy(mixed + i, text, textLength);
+    }
+    for (int i = messageSize - messageSize % textLength; i < messageSize; ++i) {
+        mixed[i] = ' ';
+    }
+}
+
+template<typename Fn>
+void measure(const char *name, Fn fn) {
+    int valid = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i) {
+        valid += fn();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    printf("%-24s %8.2f GB/s (valid: %d)\n", name, (double)messageSize * rounds / seconds / 1e9, valid);
+}
+
+int main() {
+    prepareMessages();
+    measure("memchr (reference)", [] { return memchr(message, '\0', messageSize) == nullptr; });
+    measure("isValidUtf8 ascii", [] { return CString::isValidUtf8(ascii, messageSize); });
+    measure("isValidUtf8 mixed", [] { return CString::isValidUtf8(mixed, messageSize); });
+    return 0;
+}
@@ -0,0 +1,48 @@
+#include <chrono>
+#include <fcntl.h>
+#include "CString.h"
+
+// flushes 254 log lines of ~80 characters to /dev/null
+constexpr int rounds = 20000;
+CStringBuffer<32 * 1024, 254> buffer;
+
+// baseline: one write per line
+int writePerString(int fd) {
+    int total = 0;
+    for (int i = 0; i < buffer.numstrings(); ++i) {
+        CString line = buffer.getCString(i);
+        total += write(fd, line.raw(), line.length());
+        total += write(fd, "\n", 1);
+    }
+    return total;
+}
+
+int writeTo(int fd) {
+    return buffer.writeTo(fd, "\n");
+}
+
+template<typename Fn>
+void measure(const char *name, Fn fn, int fd) {
+    long total = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i) {
+        total += fn(fd);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double usPerFlush = std::chrono::duration<double, std::micro>(end - start).count() / rounds;
+    printf("%-24s %8.2f us/flush (%ld bytes/flush)\n", name, usPerFlush, total / rounds);
+}
+
+int main() {
+    for (int i = 0; i < 254; ++i) {
+        buffer.pushFormat("2024-05-01T12:00:%02d.%03dZ INFO request handled: GET /api/v1/items/%d 200 OK", i % 60, i,
+                          i);
+    }
+
+    int fd = open("/dev/null", O_WRONLY);
+    measure("write per string", writePerString, fd);
+    measure("writeTo (writev)", writeTo, fd);
+    close(fd);
+    return 0;
+}
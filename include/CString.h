@@ -1,7 +1,9 @@
 #pragma  once
 
 #include <algorithm>
+#include <cstddef>
 #include <functional>
+#include <iterator>
 #include <string_view>
 #include <ctype.h>
 #include <limits.h>
@@ -10,11 +12,27 @@
 #include <stdint.h>
 #include <string.h>
 
+#if __has_include(<sys/uio.h>)
+#include <errno.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#define CSTRING_HAS_WRITEV
+#endif
+
 #define INVALID_STRING_IDX UINT8_MAX
 
 typedef uint8_t CStringHandle;
 
 class CString;
+class CStringCodePointIterator;
+class CStringSearcher;
+struct CStringGlobCapture;
+template<int _maxTokens, int _maxClasses> class CStringGlob;
+class CStringSlice;
+struct CStringMatch;
+
+template<int _maxStates, int _maxClasses>
+class CStringMatcher;
 
 /// Stack based buffer for string content.
 class CStringBufferBase {
@@ -121,6 +139,28 @@ public:
     /// @returns `true` if move was successful, `false` otherwise.
     virtual bool moveToTop(const CString &cstring) noexcept = 0;
 
+    /// @brief Creates a CString sharing the buffer area of the given cstring, see CString#cloneShared(). Buffers that
+    /// do not support shared areas return a copy as CString#clone() does.
+    /// @returns The new CString or CString::INVALID if there's not enough capacity.
+    virtual CString share(const CString &cstring) noexcept;
+
+    /// @brief Makes the buffer area of the given cstring private to it: an area shared with other CStrings is copied
+    /// to the top of the buffer stack and assigned to the given cstring only.
+    /// @returns `true` if the area is not shared (anymore), `false` if there's not enough capacity for the copy.
+    virtual bool unshare(const CString &cstring) noexcept;
+
+    /// @brief Allocates a small string initialized with the given string, but at most limit characters, see
+    /// CStringBuffer#pushSmall(). Buffers not supporting small strings push the string as #push(const char*, int)
+    /// does.
+    /// @returns A CString. Will be invalid if remaining capacity is too low.
+    virtual CString pushSmall(const char *string, int limit) noexcept;
+
+    /// @brief Moves the given small string to a new buffer area on top of the buffer stack, see
+    /// CStringBuffer#pushSmall(). The cstring keeps its handle, thus all copies of it refer to the new area.
+    /// @returns `true` if moved, `false` if the cstring is not a small string of this buffer or there's not enough
+    /// capacity.
+    virtual bool spill(const CString &cstring) noexcept;
+
     /// @brief Unallocates/removes the CString associated with the given index.
     /// @details This results in moving/copying of buffer content if `index != numStrings() - 1`.
     /// @return `true` if the given CString was found, `false` otherwise.
@@ -180,14 +220,30 @@ public:
 /// Mutable string with variable length buffer area, allocated on the CStringBuffer.
 /// The only operation that allocates and returns a new string based on a newly allocated buffer area is `clone`.
 /// All other operations return the (modified) instance.
+///
+/// Modifying a string that shares its buffer area (see #cloneShared()) copies the area first. This requires buffer
+/// capacity, thus all modifying operations may fail and return an invalid CString in that case, even those that
+/// otherwise never need additional buffer (e.g. toLower(), trim(), clear()).
+///
+/// Small strings (see CStringBuffer#pushSmall()) store up to INLINE_MAX_LENGTH characters inline in a table of the
+/// buffer addressed by their handle instead of a buffer area, such that they neither take buffer capacity nor one of
+/// the buffer's strings. Such a string is moved to a buffer area (spilled) once it grows beyond the inline capacity.
+/// It keeps its handle, thus copies of a small string refer to the same string as for any other CString.
 class CString final {
-    template<int _capacity, int _maxstrings> friend
-    class CStringBuffer;
+    friend class CStringBufferCore;
+    friend class CStringSlice;
+    template<int _chunkSize, int _numChunks, int _maxstrings> friend
+    class CStringSegmentedBuffer;
+    template<int _maxSegments, int _maxBuffers> friend
+    class CStringRope;
 
 public:
     /// @brief an invalid CString
     static CString INVALID;
 
+    /// @brief Max length of a small string stored inline, see CStringBuffer#pushSmall().
+    static constexpr int INLINE_MAX_LENGTH = 14;
+
     constexpr CString() noexcept : CString(nullptr, INVALID_STRING_IDX) {};
 
     /// @brief Determines length of contained string by searching the terminating \0
@@ -195,9 +251,17 @@ public:
     /// no terminating \0 was found.
     int length() const noexcept;
 
-    /// @brief Retrieves current index within underlying stack-based buffer
+    /// @brief Determines the number of UTF-8 code points of the contained string, that is the number of bytes that are
+    /// no continuation bytes. Equals the number of code points returned by #codePoints() if the string is valid UTF-8.
+    /// @returns The number of code points or -1 if the string is invalid or unallocated.
+    int codePointLength() const noexcept;
+
+    /// @brief Retrieves current index within underlying stack-based buffer. Small strings stored inline have no index.
     uint8_t bufferIndex() const noexcept;
 
+    /// @brief Determines whether the string is a small string stored inline, that is not located in a buffer area.
+    bool isInline() const noexcept;
+
     /// @brief Pointer to the underlying buffer area. The returned pointer remains valid until next interaction
     /// with the underlying buffer or any CString allocated using this buffer.
     char *raw() const noexcept;
@@ -224,6 +288,14 @@ public:
     /// failed.
     bool isInvalid() const noexcept;
 
+    /// @brief Determines whether the contained string is well-formed UTF-8: no overlong encodings, surrogates or code
+    /// points above U+10FFFF. Runs of ASCII characters are validated 16 bytes at a time.
+    /// @returns `false` if the string is not valid UTF-8, invalid or unallocated.
+    bool isValidUtf8() const noexcept;
+
+    /// @brief Determines whether the given data is well-formed UTF-8. See #isValidUtf8().
+    static bool isValidUtf8(const char* data, int length) noexcept;
+
     /// @brief Appends the given character to the current CString.
     /// @returns The current CString if the operation was successful (enough buffer available) or an invalid CString
     /// otherwise. In the latter case, the current CString content remains unchanged.
@@ -249,6 +321,12 @@ public:
     /// otherwise. In the latter case, the current CString content remains unchanged.
     CString& append(const char *string, int limit) noexcept;
 
+    /// @brief Append the content of the given slice to the current CString. The slice may refer to a string allocated
+    /// using the same buffer (including the current CString itself).
+    /// @returns The current CString if the operation was successful (enough buffer available) or an invalid CString
+    /// otherwise. In the latter case, the current CString content remains unchanged.
+    CString& append(const CStringSlice &slice) noexcept;
+
     /// @brief Appends the result of the sprintf result.
     /// @returns The current CString if the operation was successful (enough buffer available) or an invalid CString
     ///  otherwise. In the latter case, the current CString content remains unchanged.
@@ -261,39 +339,140 @@ public:
 
     /// @brief Appends the given character to the current CString. If not enough buffer is available, appends as much as
     /// possible.
-    /// @returns The current CString (modified) with as much data appended as fits.
+    /// @returns The current CString (modified) with as much data appended as fits or an invalid CString if its buffer
+    /// area is shared (see #cloneShared()) and there's not enough buffer available to copy it. In the latter case, the
+    /// current CString content remains unchanged.
     CString& appendMost(const char c) noexcept;
 
     /// @brief Append another string to the current CString. If not enough buffer is available, appends as much as
     /// possible.
-    /// @returns The current CString (modified) with as much data appended as fits.
+    /// @returns The current CString (modified) with as much data appended as fits or an invalid CString if its buffer
+    /// area is shared (see #cloneShared()) and there's not enough buffer available to copy it. In the latter case, the
+    /// current CString content remains unchanged.
     CString& appendMost(const CString &other) noexcept;
 
     /// @brief Append another string to the current CString. If not enough buffer is available, appends as much as
     /// possible.
-    /// @returns The current CString (modified) with as much data appended as fits.
+    /// @returns The current CString (modified) with as much data appended as fits or an invalid CString if its buffer
+    /// area is shared (see #cloneShared()) and there's not enough buffer available to copy it. In the latter case, the
+    /// current CString content remains unchanged.
     CString& appendMost(const std::string_view &other) noexcept;
 
     /// @brief Append another string to the current CString. If not enough buffer is available, appends as much as
     /// possible.
-    /// @returns The current CString (modified) with as much data appended as fits.
+    /// @returns The current CString (modified) with as much data appended as fits or an invalid CString if its buffer
+    /// area is shared (see #cloneShared()) and there's not enough buffer available to copy it. In the latter case, the
+    /// current CString content remains unchanged.
     CString& appendMost(const char *string) noexcept;
 
     /// @brief Append another string to the current CString. If not enough buffer is available, appends as much as
     /// possible.
-    /// @returns The current CString (modified) with as much data appended as fits.
+    /// @returns The current CString (modified) with as much data appended as fits or an invalid CString if its buffer
+    /// area is shared (see #cloneShared()) and there's not enough buffer available to copy it. In the latter case, the
+    /// current CString content remains unchanged.
     CString& appendMost(const char *string, int limit) noexcept;
 
     /// @brief Appends the result of the sprintf result. If not enough buffer is available, appends as much as possible.
-    /// @returns The current CString (modified) with as much data appended as fits.
+    /// @returns The current CString (modified) with as much data appended as fits or an invalid CString if its buffer
+    /// area is shared (see #cloneShared()) and there's not enough buffer available to copy it. In the latter case, the
+    /// current CString content remains unchanged.
     CString& appendMostFormat(const char *format, ...) noexcept;
 
     /// @brief Appends the result of the sprintf result. If not enough buffer is available, appends as much as possible.
-    /// @returns The current CString (modified) with as much data appended as fits.
+    /// @returns The current CString (modified) with as much data appended as fits or an invalid CString if its buffer
+    /// area is shared (see #cloneShared()) and there's not enough buffer available to copy it. In the latter case, the
+    /// current CString content remains unchanged.
     CString& appendMostFormatV(const char *format, va_list args) noexcept;
 
+    /// @brief Append another UTF-8 string to the current CString. If not enough buffer is available, appends as much
+    /// as possible without splitting a multi-byte sequence.
+    /// @returns The current CString (modified) with as much data appended as fits or an invalid CString if its buffer
+    /// area is shared (see #cloneShared()) and there's not enough buffer available to copy it. In the latter case, the
+    /// current CString content remains unchanged.
+    CString& appendMostUtf8(const std::string_view &other) noexcept;
+
+    /// @brief Append another UTF-8 string to the current CString. If not enough buffer is available, appends as much
+    /// as possible without splitting a multi-byte sequence.
+    /// @returns The current CString (modified) with as much data appended as fits or an invalid CString if its buffer
+    /// area is shared (see #cloneShared()) and there's not enough buffer available to copy it. In the latter case, the
+    /// current CString content remains unchanged.
+    CString& appendMostUtf8(const char *string) noexcept;
+
+    /// @brief Appends the base64 encoding (standard alphabet, padded) of the given bytes. The buffer area is resized at
+    /// most once. The data must not point into a buffer area, as it might be relocated.
+    /// @returns The current CString if the operation was successful (enough buffer available) or an invalid CString
+    /// otherwise. In the latter case, the current CString content remains unchanged.
+    CString& appendBase64(const uint8_t *data, int length) noexcept;
+
+    /// @brief Appends the bytes encoded by the given base64 string (standard or url alphabet, padding optional). The
+    /// buffer area is resized at most once.
+    /// @returns The current CString if the operation was successful (enough buffer available, well-formed encoding not
+    /// containing \0 bytes) or an invalid CString otherwise. In the latter case, the current CString content remains
+    /// unchanged. The encoded data may refer to a string of the same buffer.
+    CString& appendBase64Decoded(const std::string_view &encoded) noexcept;
+
+    /// @brief Appends the base64url encoding (url alphabet, not padded) of the given bytes. The buffer area is resized
+    /// at most once. The data must not point into a buffer area, as it might be relocated.
+    /// @returns The current CString if the operation was successful (enough buffer available) or an invalid CString
+    /// otherwise. In the latter case, the current CString content remains unchanged.
+    CString& appendBase64Url(const uint8_t *data, int length) noexcept;
+
+    /// @brief Appends the given string escaped for a C string literal: `\"`, `\\`, `\n` and similar short escapes,
+    /// all other control characters and bytes >= 0x7F as 3 digit octal escapes. Runs of characters that need no
+    /// escaping are copied as a whole and the buffer area is resized at most once. The string must not point into a
+    /// buffer area, as it might be relocated.
+    /// @returns The current CString if the operation was successful (enough buffer available) or an invalid CString
+    /// otherwise. In the latter case, the current CString content remains unchanged.
+    CString& appendCEscaped(const std::string_view &str) noexcept;
+
+    /// @brief Appends the hex encoding (two digits per byte) of the given bytes. The buffer area is resized at most
+    /// once. The data must not point into a buffer area, as it might be relocated.
+    /// @returns The current CString if the operation was successful (enough buffer available) or an invalid CString
+    /// otherwise. In the latter case, the current CString content remains unchanged.
+    CString& appendHex(const uint8_t *data, int length, bool upperCase = false) noexcept;
+
+    /// @brief Appends the bytes encoded by the given hex string (upper or lower case digits). The buffer area is
+    /// resized at most once.
+    /// @returns The current CString if the operation was successful (enough buffer available, well-formed encoding not
+    /// containing \0 bytes) or an invalid CString otherwise. In the latter case, the current CString content remains
+    /// unchanged. The encoded data may refer to a string of the same buffer.
+    CString& appendHexDecoded(const std::string_view &encoded) noexcept;
+
+    /// @brief Appends the given string escaped for a JSON string: `\"`, `\\`, `\n` and similar short escapes, all
+    /// other control characters as `\u00XX`. Other characters, including UTF-8 sequences, are copied unchanged. Runs of
+    /// characters that need no escaping are copied as a whole and the buffer area is resized at most once. The string
+    /// must not point into a buffer area, as it might be relocated.
+    /// @returns The current CString if the operation was successful (enough buffer available) or an invalid CString
+    /// otherwise. In the latter case, the current CString content remains unchanged.
+    CString& appendJsonEscaped(const std::string_view &str) noexcept;
+
+    /// @brief Appends the given string percent-encoded: all characters except the unreserved ones (`A-Z a-z 0-9 - . _
+    /// ~`) are encoded as `%XX`. Runs of unreserved characters are copied as a whole and the buffer area is resized at
+    /// most once. The string must not point into a buffer area, as it might be relocated.
+    /// @returns The current CString if the operation was successful (enough buffer available) or an invalid CString
+    /// otherwise. In the latter case, the current CString content remains unchanged.
+    CString& appendUrlEncoded(const std::string_view &str) noexcept;
+
+    /// @brief Appends the given strings separated by the given delimiter. The required capacity is computed upfront,
+    /// such that the buffer area is resized at most once. Strings allocated using the same buffer (including the
+    /// current CString itself) are fine: they are resolved again after the buffer area has been resized. The
+    /// delimiter must not point into a buffer area, as it might be relocated.
+    /// @returns The current CString if the operation was successful (enough buffer available) or an invalid CString
+    /// otherwise. In the latter case, the current CString content remains unchanged.
+    CString& appendJoin(const CString *strings, int count, const char *delimiter) noexcept;
+
+    /// @brief Appends the given range of strings separated by the given delimiter. See
+    /// #appendJoin(const CString*, int, const char*).
+    /// @returns The current CString if the operation was successful (enough buffer available) or an invalid CString
+    /// otherwise. In the latter case, the current CString content remains unchanged.
+    template<typename Range>
+    CString& appendJoin(const Range &strings, const char *delimiter) noexcept {
+        return appendJoin(std::data(strings), (int)std::size(strings), delimiter);
+    }
+
     /// @briefs Clears all content without changing the capacity.
-    /// @returns The current CString.
+    /// @returns The current CString or an invalid CString if its buffer area is shared (see #cloneShared()) and there's
+    /// not enough buffer available to copy it. In the latter case, the current CString content remains unchanged.
     CString& clear() noexcept;
 
     /// @brief Clones the current CString, that is a independent copy is allocated using the current buffer.
@@ -321,6 +500,30 @@ public:
     /// otherwise.
     CString cloneWithLimit(int startIndex, int limit) const noexcept;
 
+    /// @brief Clones the current UTF-8 string, but at most `limit` bytes. A multi-byte sequence exceeding the limit is
+    /// omitted as a whole.
+    /// @returns The cloned CString if the operation was successful (enough buffer available) or an invalid CString
+    /// otherwise.
+    CString cloneWithLimitUtf8(int limit) const noexcept;
+
+    /// @brief Clones the current UTF-8 string starting at the given index, but at most `limit` bytes. A multi-byte
+    /// sequence exceeding the limit is omitted as a whole. The startIndex should refer to the beginning of a sequence.
+    /// @returns The cloned CString if the operation was successful (enough buffer available) or an invalid CString
+    /// otherwise.
+    CString cloneWithLimitUtf8(int startIndex, int limit) const noexcept;
+
+    /// @brief Clones the current CString without copying its content (copy-on-write): the clone shares the buffer area
+    /// with this CString until either of them is modified, which copies the area to the top of the buffer stack first.
+    /// Modifications not changing the content (e.g. `trim()` without whitespace) do not copy. Small strings and
+    /// buffers not supporting shared areas are copied as by clone(). The content of a shared area must not be modified
+    /// using `raw()` or buffer methods, e.g. CStringBuffer#appendToTopmost().
+    /// @returns The cloned CString if the operation was successful or an invalid CString otherwise.
+    CString cloneShared() const noexcept;
+
+    /// @brief Iterates the UTF-8 code points of the contained string starting at the given byte index. See
+    /// CStringCodePointIterator.
+    CStringCodePointIterator codePoints(int startIndex = 0) const noexcept;
+
     /// @brief Compares this string with the other string using `strcmp` semantic.
     int compare(const char* other) const noexcept;
 
@@ -330,6 +533,25 @@ public:
     /// @brief Compares this string with the other string using `strcmp` semantic.
     int compare(const CString &other) const noexcept;
 
+    /// @brief Compares this string with the content of the given slice using `strcmp` semantic.
+    int compare(const CStringSlice &other) const noexcept;
+
+    /// @brief Decodes the contained base64 string (standard or url alphabet, padding optional) into the given bytes.
+    /// @returns The number of decoded bytes or -1 if the string is invalid, unallocated, not well-formed or the given
+    /// capacity is too low.
+    int decodeBase64(uint8_t *dst, int dstCapacity) const noexcept;
+
+    /// @brief Decodes the given base64 data into the given bytes. See #decodeBase64(uint8_t*, int).
+    static int decodeBase64(const char *encoded, int length, uint8_t *dst, int dstCapacity) noexcept;
+
+    /// @brief Decodes the contained hex string (upper or lower case digits) into the given bytes.
+    /// @returns The number of decoded bytes or -1 if the string is invalid, unallocated, not well-formed or the given
+    /// capacity is too low.
+    int decodeHex(uint8_t *dst, int dstCapacity) const noexcept;
+
+    /// @brief Decodes the given hex data into the given bytes. See #decodeHex(uint8_t*, int).
+    static int decodeHex(const char *encoded, int length, uint8_t *dst, int dstCapacity) noexcept;
+
     /// @brief Determines whether the string starts with the given character.
     bool endsWith(const char c) const noexcept;
 
@@ -342,6 +564,72 @@ public:
     /// @brief Determines whether the string starts with the given string.
     bool endsWith(const CString& str) const noexcept;
 
+    /// @brief Determines whether the string ends with the content of the given slice.
+    bool endsWith(const CStringSlice& str) const noexcept;
+
+    /// @brief Computes a 64bit non-cryptographic hash of the contained string. See #hash(const char*, int).
+    /// @returns The hash or 0 if the string is unallocated.
+    uint64_t hash() const noexcept;
+
+    /// @brief Computes a 64bit non-cryptographic hash of the given string (wyhash). The result does not depend on the
+    /// platform, and is equal to the hash of a CString with the same content. Can be evaluated at compile time, e.g.
+    /// to dispatch on `hash()` using `switch`.
+    static constexpr uint64_t hash(const char *str) noexcept {
+        return hash(str, (int)std::char_traits<char>::length(str));
+    }
+
+    /// @brief See #hash(const char*).
+    static constexpr uint64_t hash(const std::string_view &str) noexcept {
+        return hash(str.data(), (int)str.length());
+    }
+
+    /// @brief See #hash(const char*).
+    static constexpr uint64_t hash(const char *str, int length) noexcept {
+        uint64_t seed = _hashMix(_hashSecret0, _hashSecret1);
+        uint64_t a = 0;
+        uint64_t b = 0;
+
+        if (length <= 16) {
+            if (length >= 4) {
+                int offset = (length >> 3) << 2;
+                a = (_hashRead4(str) << 32) | _hashRead4(str + offset);
+                b = (_hashRead4(str + length - 4) << 32) | _hashRead4(str + length - 4 - offset);
+            } else if (length > 0) {
+                a = ((uint64_t)(uint8_t)str[0] << 16) | ((uint64_t)(uint8_t)str[length >> 1] << 8)
+                    | (uint8_t)str[length - 1];
+            }
+        } else {
+            int remaining = length;
+            if (remaining > 48) {
+                // three independent lanes per 48 byte block
+                uint64_t seed1 = seed;
+                uint64_t seed2 = seed;
+                do {
+                    seed = _hashMix(_hashRead8(str) ^ _hashSecret1, _hashRead8(str + 8) ^ seed);
+                    seed1 = _hashMix(_hashRead8(str + 16) ^ _hashSecret2, _hashRead8(str + 24) ^ seed1);
+                    seed2 = _hashMix(_hashRead8(str + 32) ^ _hashSecret3, _hashRead8(str + 40) ^ seed2);
+                    str += 48;
+                    remaining -= 48;
+                } while (remaining > 48);
+                seed ^= seed1 ^ seed2;
+            }
+
+            while (remaining > 16) {
+                seed = _hashMix(_hashRead8(str) ^ _hashSecret1, _hashRead8(str + 8) ^ seed);
+                str += 16;
+                remaining -= 16;
+            }
+
+            a = _hashRead8(str + remaining - 16);
+            b = _hashRead8(str + remaining - 8);
+        }
+
+        a ^= _hashSecret1;
+        b ^= seed;
+        _hashMultiply(a, b);
+        return _hashMix(a ^ _hashSecret0 ^ (uint64_t)length, b ^ _hashSecret1);
+    }
+
     /// @brief Reports the index of the first occurrence of the given character or -1 if not found. Search starts at the
     /// given startIndex. The whole buffer area is searched, therefore results after the end of the contained string
     /// might be returned, if the allocated capacity is bigger than the contained string.
@@ -362,6 +650,16 @@ public:
     /// might be returned, if the allocated capacity is bigger than the contained string.
     int indexOf(const CString& str, int startIndex = 0) const noexcept;
 
+    /// @brief Reports the index of the first occurrence of the content of the given slice or -1 if not found. Search
+    /// starts at the given startIndex. The whole buffer area is searched, therefore results after the end of the
+    /// contained string might be returned, if the allocated capacity is bigger than the contained string.
+    int indexOf(const CStringSlice& str, int startIndex = 0) const noexcept;
+
+    /// @brief Reports the index of the first occurrence of the searcher's needle or -1 if not found. Search starts at
+    /// the given startIndex. The whole buffer area is searched, therefore results after the end of the contained string
+    /// might be returned, if the allocated capacity is bigger than the contained string. Requires CStringSearcher.h.
+    int indexOf(const CStringSearcher& searcher, int startIndex = 0) const noexcept;
+
     /// @brief Reports the index of the first occurrence of any of the given characters or -1 if not found. Search
     /// starts at the given startIndex. The whole buffer area is searched, therefore results after the end of the contained string
     /// might be returned, if the allocated capacity is bigger than the contained string.
@@ -377,6 +675,18 @@ public:
     /// might be returned, if the allocated capacity is bigger than the contained string.
     int indexOfAny(std::function<bool(const char)> predicate, int startIndex = 0) const noexcept;
 
+    /// @brief Reports the index of the first occurrence of any of the matcher's patterns or -1 if not found. Search
+    /// starts at the given startIndex and stops at the end of the contained string. All patterns are searched in a
+    /// single pass. Requires CStringMatcher.h.
+    template<int _maxStates, int _maxClasses>
+    int indexOfAnyPattern(const CStringMatcher<_maxStates, _maxClasses> &matcher, int startIndex = 0) const noexcept;
+
+    /// @brief Reports the index of the first occurrence of any of the matcher's patterns or -1 if not found. Details
+    /// of the match are stored to the given match. See #indexOfAnyPattern(const CStringMatcher&, int).
+    template<int _maxStates, int _maxClasses>
+    int indexOfAnyPattern(const CStringMatcher<_maxStates, _maxClasses> &matcher, int startIndex,
+                          CStringMatch &match) const noexcept;
+
     /// @brief Reports the index of the last occurrence of the given character or -1 if not found. Search starts at the
     /// end of the contained string. The whole buffer area is searched, therefore results after the end of the contained string
     /// might be returned, if the allocated capacity is bigger than the contained string.
@@ -437,25 +747,63 @@ public:
     /// contained string might be returned, if the allocated capacity is bigger than the contained string.
     int lastIndexOfAny(std::function<bool(const char)> predicate, int startIndex) const noexcept;
 
+    /// @brief Determines whether the contained string matches the given glob pattern: `*` matches any sequence of
+    /// characters, `?` any single character, `[a-z]` any listed character, `[!a-z]` any character not listed and `\`
+    /// escapes the next character. The pattern is compiled on each call, see CStringGlob for repeated matching.
+    /// Patterns are limited to 255 tokens (characters, wildcards and character classes) and 32 character classes,
+    /// use `CStringGlob<UINT8_MAX, 32>::isInvalid()` to tell a pattern exceeding them from a non-matching one. Requires
+    /// CStringGlob.h.
+    /// @returns `false` if the string is invalid, does not match or the pattern is invalid (malformed or exceeding
+    /// the limits).
+    bool matchesGlob(const char* pattern) const noexcept;
+
+    /// @brief Determines whether the contained string matches the given precompiled glob. The spans matched by the
+    /// glob's wildcards are stored to the given captures (if not nullptr), see CStringGlob#matches. Requires
+    /// CStringGlob.h.
+    template<int _maxTokens, int _maxClasses>
+    bool matchesGlob(const CStringGlob<_maxTokens, _maxClasses>& glob,
+                     CStringGlobCapture* captures = nullptr) const noexcept;
+
     /// @brief Resizes the current CString buffer area by setting the new capacity to `maxLength + 1`.
     /// @returns The current CString if the operation was successful (enough buffer available) or an invalid CString
     /// otherwise. In the latter case, the current CString content remains unchanged.
     CString& resize(int maxLength) noexcept;
 
+    /// @brief Resizes the current CString buffer area like #resize(int). If the contained UTF-8 string is truncated,
+    /// a multi-byte sequence exceeding `maxLength` is removed as a whole.
+    /// @returns The current CString if the operation was successful (enough buffer available) or an invalid CString
+    /// otherwise. In the latter case, the current CString content remains unchanged.
+    CString& resizeUtf8(int maxLength) noexcept;
+
     /// @brief Resizes the current CString using the current `length()` as new maxLength.
-    /// @returns The current CString (modified).
+    /// @returns The current CString (modified) or an invalid CString if its buffer area is shared (see
+    /// #cloneShared()) and there's not enough buffer available to copy it. In the latter case, the current CString
+    /// content remains unchanged.
     CString& shrinkToFit() noexcept;
 
     /// @brief Truncates the string such that only the given substring is retained. Use `clone` to retrieve a copy of
     /// the identified substring.
-    /// @returns Reference to the current string (modified).
+    /// @returns Reference to the current string (modified) or an invalid CString if the range exceeds the buffer area
+    /// or the buffer area is shared (see #cloneShared()) and there's not enough buffer available to copy it. In the
+    /// latter case, the current CString content remains unchanged.
     CString& substring(int startIndex) noexcept;
 
     /// @brief Truncates the string such that only the given substring is retained. Use `clone` to retrieve a copy of
     /// the identified substring.
-    /// @returns Reference to the current string (modified).
+    /// @returns Reference to the current string (modified) or an invalid CString if the range exceeds the buffer area
+    /// or the buffer area is shared (see #cloneShared()) and there's not enough buffer available to copy it. In the
+    /// latter case, the current CString content remains unchanged.
     CString& substring(int startIndex, int length) noexcept;
 
+    /// @brief Creates a slice referring to the given part of the buffer area, starting at the given index up to the
+    /// end of the contained string. No content is copied. See CStringSlice.
+    /// @returns The slice or an invalid slice if the current string is unallocated or the index is out of range.
+    CStringSlice slice(int startIndex) const noexcept;
+
+    /// @brief Creates a slice referring to the given part of the buffer area. No content is copied. See CStringSlice.
+    /// @returns The slice or an invalid slice if the current string is unallocated or the range exceeds the buffer area.
+    CStringSlice slice(int startIndex, int length) const noexcept;
+
     /// @brief Determines whether the string starts with the given character.
     bool startsWith(const char c) const noexcept;
 
@@ -468,81 +816,126 @@ public:
     /// @brief Determines whether the string starts with the given string.
     bool startsWith(const CString& str) const noexcept;
 
+    /// @brief Determines whether the string starts with the content of the given slice.
+    bool startsWith(const CStringSlice& str) const noexcept;
+
     /// @brief Changes all characters of the current string to lower case. Only ASCII characters are changed.
-    /// @returns The current CString (modified).
+    /// @returns The current CString (modified) or an invalid CString if its buffer area is shared (see
+    /// #cloneShared()) and there's not enough buffer available to copy it. In the latter case, the current CString
+    /// content remains unchanged.
     CString& toLower() noexcept;
 
     /// @brief Changes all characters of the current string to upper case. Only ASCII characters are changed.
-    /// @returns The current CString (modified).
+    /// @returns The current CString (modified) or an invalid CString if its buffer area is shared (see
+    /// #cloneShared()) and there's not enough buffer available to copy it. In the latter case, the current CString
+    /// content remains unchanged.
     CString& toUpper() noexcept;
 
+    /// @brief Decodes the percent-encoded current string in place. If plusAsSpace is set, `+` is decoded as space
+    /// (form encoding).
+    /// @returns The current CString if the operation was successful or an invalid CString if the string is not
+    /// well-formed (e.g. incomplete `%` sequence or `%00`) or its buffer area is shared (see #cloneShared()) and
+    /// there's not enough buffer available to copy it. In the latter case, the current CString content remains
+    /// unchanged.
+    CString& urlDecode(bool plusAsSpace = false) noexcept;
+
     /// @brief Trims the current CString, that is removes all leading and trailing whitespace.
-    /// @returns The current CString (modified).
+    /// @returns The current CString (modified) or an invalid CString if its buffer area is shared (see
+    /// #cloneShared()) and there's not enough buffer available to copy it. In the latter case, the current CString
+    /// content remains unchanged.
     CString& trim() noexcept;
 
     /// @brief Trims the current CString by removing leading and trailing occurrences of the given character.
-    /// @returns The current CString (modified).
+    /// @returns The current CString (modified) or an invalid CString if its buffer area is shared (see
+    /// #cloneShared()) and there's not enough buffer available to copy it. In the latter case, the current CString
+    /// content remains unchanged.
     CString& trim(char c) noexcept;
 
     /// @brief Trims the current CString, that is removes all leading and trailing characters that are contained in the
     /// given string (excluding \0).
-    /// @returns The current CString (modified).
+    /// @returns The current CString (modified) or an invalid CString if its buffer area is shared (see
+    /// #cloneShared()) and there's not enough buffer available to copy it. In the latter case, the current CString
+    /// content remains unchanged.
     CString& trim(const char *chars) noexcept;
 
     /// @brief Trims the current CString, that is removes all leading and trailing characters that are contained in the
     /// given string (excluding \0).
-    /// @returns The current CString (modified).
+    /// @returns The current CString (modified) or an invalid CString if its buffer area is shared (see
+    /// #cloneShared()) and there's not enough buffer available to copy it. In the latter case, the current CString
+    /// content remains unchanged.
     CString& trim(const char *chars, int charsLengthExcludingNull) noexcept;
 
     /// @brief Trims the current CString, that is removes all leading and trailing characters that are matched by the
     /// provided predicate.
-    /// @returns The current CString (modified).
+    /// @returns The current CString (modified) or an invalid CString if its buffer area is shared (see
+    /// #cloneShared()) and there's not enough buffer available to copy it. In the latter case, the current CString
+    /// content remains unchanged.
     CString& trim(std::function<bool(const char)> isCharToRemove) noexcept;
 
     /// @brief Trims the beginning of the current CString, that is removes all leading whitespace.
-    /// @returns The current CString (modified).
+    /// @returns The current CString (modified) or an invalid CString if its buffer area is shared (see
+    /// #cloneShared()) and there's not enough buffer available to copy it. In the latter case, the current CString
+    /// content remains unchanged.
     CString& trimStart() noexcept;
 
     /// @brief Trims the beginning of the current CString by removing leading occurrences of the given character.
-    /// @returns The current CString (modified).
+    /// @returns The current CString (modified) or an invalid CString if its buffer area is shared (see
+    /// #cloneShared()) and there's not enough buffer available to copy it. In the latter case, the current CString
+    /// content remains unchanged.
     CString& trimStart(char c) noexcept;
 
     /// @brief Trims the beginning of the current CString, that is removes all leading characters that are contained
     /// in the given string (excluding \0).
-    /// @returns The current CString (modified).
+    /// @returns The current CString (modified) or an invalid CString if its buffer area is shared (see
+    /// #cloneShared()) and there's not enough buffer available to copy it. In the latter case, the current CString
+    /// content remains unchanged.
     CString& trimStart(const char *chars) noexcept;
 
     /// @brief Trims the beginning of the current CString, that is removes all leading characters that are contained
     /// in the given string (excluding \0).
-    /// @returns The current CString (modified).
+    /// @returns The current CString (modified) or an invalid CString if its buffer area is shared (see
+    /// #cloneShared()) and there's not enough buffer available to copy it. In the latter case, the current CString
+    /// content remains unchanged.
     CString& trimStart(const char *chars, int charsLengthExcludingNull) noexcept;
 
     /// @brief Trims the beginning of the current CString, that is removes all leading characters that are matched by
     /// the provided predicate.
-    /// @returns The current CString (modified).
+    /// @returns The current CString (modified) or an invalid CString if its buffer area is shared (see
+    /// #cloneShared()) and there's not enough buffer available to copy it. In the latter case, the current CString
+    /// content remains unchanged.
     CString& trimStart(std::function<bool(const char)> isCharToRemove) noexcept;
 
     /// @brief Trims the end of the current CString, that is removes all trailing whitespace.
-    /// @returns The current CString (modified).
+    /// @returns The current CString (modified) or an invalid CString if its buffer area is shared (see
+    /// #cloneShared()) and there's not enough buffer available to copy it. In the latter case, the current CString
+    /// content remains unchanged.
     CString& trimEnd() noexcept;
 
     /// @brief Trims the end of the current CString by removing trailing occurrences of the given character.
-    /// @returns The current CString (modified).
+    /// @returns The current CString (modified) or an invalid CString if its buffer area is shared (see
+    /// #cloneShared()) and there's not enough buffer available to copy it. In the latter case, the current CString
+    /// content remains unchanged.
     CString& trimEnd(char c) noexcept;
 
     /// @brief Trims the end of the current CString, that is removes all trailing characters that are contained
     /// in the given string (excluding \0).
-    /// @returns The current CString (modified).
+    /// @returns The current CString (modified) or an invalid CString if its buffer area is shared (see
+    /// #cloneShared()) and there's not enough buffer available to copy it. In the latter case, the current CString
+    /// content remains unchanged.
     CString& trimEnd(const char *chars) noexcept;
 
     /// @brief Trims the end of the current CString, that is removes all trailing characters that are contained
     /// in the given string (excluding \0).
-    /// @returns The current CString (modified).
+    /// @returns The current CString (modified) or an invalid CString if its buffer area is shared (see
+    /// #cloneShared()) and there's not enough buffer available to copy it. In the latter case, the current CString
+    /// content remains unchanged.
     CString& trimEnd(const char *chars, int charsLengthExcludingNull) noexcept;
 
     /// @brief Trims the end of the current CString, that is removes all trailing characters that are matched by the
     /// provided predicate.
-    /// @returns The current CString (modified).
+    /// @returns The current CString (modified) or an invalid CString if its buffer area is shared (see
+    /// #cloneShared()) and there's not enough buffer available to copy it. In the latter case, the current CString
+    /// content remains unchanged.
     CString& trimEnd(std::function<bool(const char)> isCharToRemove) noexcept;
 
     /// @brief Deallocates the current string. Might involve moving of other CStrings allocated using the same buffer.
@@ -608,8 +1001,16 @@ public:
     /// @brief compares content
     bool operator !=(const std::string_view &str) const noexcept;
 
+    /// @brief compares content
+    bool operator ==(const CStringSlice &str) const noexcept;
+
+    /// @brief compares content
+    bool operator !=(const CStringSlice &str) const noexcept;
+
     /// @brief Retrieves the char at the given index.
-    /// @returns A reference to the char at the given index or an reference to \0 if index is invalid.
+    /// @returns A reference to the char at the given index or a reference to a dummy \0 if the index is invalid or
+    /// the buffer area is shared (see #cloneShared()) and there's not enough buffer available to copy it. In the
+    /// latter case, the current CString content remains unchanged.
     char& operator [](int index) noexcept;
 
     /// @brief see std::string_view
@@ -621,20 +1022,238 @@ private:
 
     constexpr CString(CStringBufferBase *buf, CStringHandle handle) noexcept : _buf(buf), _handle(handle) {}
 
+    inline bool _isInline() const noexcept;
+
     inline int _lengthUnchecked() const noexcept;
     inline int _bufferIndexUnchecked() const noexcept;
     inline char *_rawUnchecked() const noexcept;
     inline int _rawCapacityUnchecked() const noexcept;
     inline int _rawMaxLengthUnchecked() const noexcept;
 
+    /// @brief Moves the buffer area to the top of the buffer. Small strings are spilled to a new buffer area.
     CString& _moveToTop() noexcept;
+
+    /// @brief Copies a buffer area shared by cloneShared() before it is modified, see CStringBufferBase#unshare().
+    /// @returns `true` if the buffer area may be modified, `false` if there's not enough buffer for the copy.
+    bool _unshare() noexcept;
+
+    /// @brief Determines the number of characters that can be appended, at most: the buffer's unallocated bytes, less
+    /// the bytes needed to spill a small string.
+    int _appendLimit() const noexcept;
+
+    /// @brief Copies the given string like CStringBufferBase#push(const char*, int): small strings are copied as small
+    /// strings if the copy fits.
+    CString _pushCopy(const char *string, int limit) const noexcept;
+
+    /// @brief Determines whether appending `appendLength` characters relocates buffer areas of other strings, that is
+    /// whether the buffer area needs to be resized and is not the topmost one.
+    bool _appendRelocates(int appendLength) const noexcept;
+
+    /// @brief Ensures that `appendLength` characters can be appended, resizing the buffer area at most once.
+    /// @returns Pointer to the current end of string (resolved after resize) or nullptr if not enough buffer is
+    /// available. The terminating \0 must be written by the caller.
+    char* _reserveAppend(int appendLength) noexcept;
+
+    static constexpr uint64_t _hashSecret0 = 0x2d358dccaa6c78a5ull;
+    static constexpr uint64_t _hashSecret1 = 0x8bb84b93962eacc9ull;
+    static constexpr uint64_t _hashSecret2 = 0x4b33a62ed433d4a3ull;
+    static constexpr uint64_t _hashSecret3 = 0x4d5a2da51de1aa47ull;
+
+    /// @brief 64x64 => 128bit multiplication: a = low 64bit, b = high 64bit
+    static constexpr void _hashMultiply(uint64_t &a, uint64_t &b) noexcept {
+#ifdef __SIZEOF_INT128__
+        __uint128_t r = (__uint128_t)a * b;
+        a = (uint64_t)r;
+        b = (uint64_t)(r >> 64);
+#else
+        uint64_t ha = a >> 32, hb = b >> 32, la = (uint32_t)a, lb = (uint32_t)b;
+        uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+        uint64_t t = rl + (rm0 << 32);
+        uint64_t c = t < rl;
+        uint64_t lo = t + (rm1 << 32);
+        c += lo < t;
+        a = lo;
+        b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+    }
+
+    static constexpr uint64_t _hashMix(uint64_t a, uint64_t b) noexcept {
+        _hashMultiply(a, b);
+        return a ^ b;
+    }
+
+    /// @brief little endian read, independent of the platform's byte order
+    static constexpr uint64_t _hashRead4(const char *p) noexcept {
+        return (uint64_t)(uint8_t)p[0] | (uint64_t)(uint8_t)p[1] << 8 | (uint64_t)(uint8_t)p[2] << 16
+               | (uint64_t)(uint8_t)p[3] << 24;
+    }
+
+    static constexpr uint64_t _hashRead8(const char *p) noexcept {
+        return _hashRead4(p) | _hashRead4(p + 4) << 32;
+    }
 };
 
-template<int _capacity, int _maxstrings = 10>
-class CStringBuffer final : CStringBufferBase {
-    static_assert(_capacity > 0 && _maxstrings > 0 && _maxstrings < UINT8_MAX);
+/// Part of a CString's buffer area identified by the string's handle, a start index and a length. No content is
+/// copied. In contrast to a std::string_view, the slice remains valid if the string's buffer area is relocated within
+/// the buffer, as the slice's content is resolved using the handle on each access. The slice becomes invalid if the
+/// string is unallocated or its buffer area shrinks below the end of the slice.
+class CStringSlice final {
+    friend class CString;
+
 public:
-    constexpr CStringBuffer() noexcept : CStringBuffer(std::make_index_sequence<_maxstrings>{}) {}
+    constexpr CStringSlice() noexcept : _string(), _startIndex(0), _length(0) {}
+
+    /// @brief Retrieves the string the slice refers to.
+    const CString& string() const noexcept;
+
+    /// @brief Retrieves the index of the first character of the slice within the string's buffer area.
+    int startIndex() const noexcept;
+
+    /// @brief Retrieves the number of characters of the slice, or -1 if the slice is invalid.
+    int length() const noexcept;
+
+    /// @brief Pointer to the first character of the slice. The content is not \0 terminated. The returned pointer
+    /// remains valid until next interaction with the underlying buffer or any CString allocated using this buffer.
+    /// @returns The pointer or nullptr if the slice is invalid.
+    const char *raw() const noexcept;
+
+    /// @brief Determines whether the slice is invalid, that is the string was unallocated or has been resized such that
+    /// the slice exceeds the buffer area.
+    bool isInvalid() const noexcept;
+
+    /// @brief Determines whether the slice is valid and empty.
+    bool isEmpty() const noexcept;
+
+    /// @brief Creates a slice of this slice, starting at the given index relative to this slice.
+    /// @returns The slice or an invalid slice if the given range exceeds this slice.
+    CStringSlice slice(int startIndex, int length) const noexcept;
+
+    /// @brief Allocates a new CString with the content of this slice using the string's buffer.
+    /// @returns The cloned CString if the operation was successful (enough buffer available) or an invalid CString
+    /// otherwise.
+    CString clone() const noexcept;
+
+    /// @brief Compares this slice with the other string using `strcmp` semantic.
+    int compare(const char *other) const noexcept;
+
+    /// @brief Compares this slice with the other string using `strcmp` semantic.
+    int compare(const char *other, int otherLengthExcludingNull) const noexcept;
+
+    /// @brief Compares this slice with the other slice using `strcmp` semantic.
+    int compare(const CStringSlice &other) const noexcept;
+
+    /// @brief Determines whether the slice starts with the given string.
+    bool startsWith(const char *str) const noexcept;
+
+    /// @brief Determines whether the slice starts with the given string.
+    bool startsWith(const char *str, int strLengthExcludingNull) const noexcept;
+
+    /// @brief Determines whether the slice ends with the given string.
+    bool endsWith(const char *str) const noexcept;
+
+    /// @brief Determines whether the slice ends with the given string.
+    bool endsWith(const char *str, int strLengthExcludingNull) const noexcept;
+
+    /// @brief Computes the hash of the slice's content. See CString#hash(const char*, int).
+    /// @returns The hash or 0 if the slice is invalid.
+    uint64_t hash() const noexcept;
+
+    /// @brief Reports the index (relative to the slice) of the first occurrence of the given character or -1 if not
+    /// found. Search starts at the given startIndex.
+    int indexOf(const char c, int startIndex = 0) const noexcept;
+
+    /// @brief Reports the index (relative to the slice) of the first occurrence of the given string or -1 if not
+    /// found. Search starts at the given startIndex.
+    int indexOf(const char *str, int startIndex = 0) const noexcept;
+
+    /// @brief Reports the index (relative to the slice) of the first occurrence of the given string or -1 if not
+    /// found. Search starts at the given startIndex.
+    int indexOf(const char *str, int startIndex, int strLenExcludingNull) const noexcept;
+
+    /// @brief Creates a string view of the slice's content.
+    /// @returns A std::string_view that remains valid at least until the next interaction with any of the strings
+    /// allocated on the underlying buffer.
+    const std::string_view asStringView() const noexcept;
+
+    /// @brief Retrieves the char at the given index (relative to the slice).
+    /// @returns The char at the given index or \0 if the index or the slice is invalid.
+    char operator [](int index) const noexcept;
+
+    /// @brief compares content
+    bool operator ==(const char *str) const noexcept;
+
+    /// @brief compares content
+    bool operator ==(const std::string_view &str) const noexcept;
+
+    /// @brief compares content
+    bool operator ==(const CStringSlice &str) const noexcept;
+
+    /// @brief compares content
+    bool operator !=(const char *str) const noexcept;
+
+    /// @brief compares content
+    bool operator !=(const std::string_view &str) const noexcept;
+
+    /// @brief compares content
+    bool operator !=(const CStringSlice &str) const noexcept;
+
+    /// @brief see std::string_view
+    operator const std::string_view() const noexcept;
+
+private:
+    CString _string;
+    int _startIndex;
+    int _length;
+
+    CStringSlice(const CString &string, int startIndex, int length) noexcept
+            : _string(string), _startIndex(startIndex), _length(length) {}
+};
+
+/// Iterates the UTF-8 code points of a CString. Ill-formed sequences are reported as U+FFFD, one per byte that does not
+/// start a well-formed sequence. The string is referred to by pointer and must not be modified or relocated during
+/// iteration.
+class CStringCodePointIterator final {
+    friend class CString;
+public:
+    /// @brief Retrieves the next code point.
+    /// @returns `true` if a code point was decoded, `false` if the end of the string has been reached.
+    bool next(char32_t &codePoint) noexcept;
+
+    /// @brief Retrieves the byte index of the next code point.
+    int index() const noexcept;
+
+private:
+    const char *_data;
+    int _length;
+    int _index;
+
+    CStringCodePointIterator(const char *data, int length, int startIndex) noexcept;
+};
+
+namespace std {
+    template<>
+    struct hash<CString> {
+        size_t operator()(const CString &str) const noexcept {
+            return (size_t)str.hash();
+        }
+    };
+
+    template<>
+    struct hash<CStringSlice> {
+        size_t operator()(const CStringSlice &str) const noexcept {
+            return (size_t)str.hash();
+        }
+    };
+}
+
+/// Allocator shared by CStringBuffer and CStringBufferView: string data is placed in a data region, the string table
+/// (offsets relative to the data region), the handles, the number of handles sharing each buffer area and the small
+/// string table in a metadata region. CStringBuffer embeds both regions, CStringBufferView attaches to regions provided
+/// by the caller. Holds at most 254 strings and small strings in total (see CStringHandle).
+class CStringBufferCore : CStringBufferBase {
+public:
+    CStringBufferCore(const CStringBufferCore &) = delete;
+    CStringBufferCore &operator=(const CStringBufferCore &) = delete;
 
     virtual CString allocate() noexcept override {
         return push('\0');
@@ -656,10 +1275,11 @@ public:
     }
 
     virtual CString allocateRemaining() noexcept override {
-        if (_remaining < 1) {
+        int remaining = _remaining();
+        if (remaining < 1) {
             return CString::INVALID;
         }
-        return allocate(_remaining - 1);
+        return allocate(remaining - 1);
     }
 
     virtual CString push() noexcept override {
@@ -682,6 +1302,45 @@ public:
         return _pushOrAppendToLast(string, limit, false);
     }
 
+    /// @brief Allocates an empty small string, see #pushSmall(const char*, int).
+    CString allocateSmall() noexcept {
+        return pushSmall("", 0);
+    }
+
+    /// @brief Pushes the given string as small string. See #pushSmall(const char*, int).
+    CString pushSmall(const char *string) noexcept {
+        return pushSmall(string, INT_MAX);
+    }
+
+    /// @brief Pushes the given string, but at most limit characters, as small string: up to CString::INLINE_MAX_LENGTH
+    /// characters are stored in one of the maxsmall entries of the small string table, such that the string takes
+    /// neither capacity nor one of the maxstrings strings of this buffer until it grows beyond that length (see
+    /// #spill()). A spilled string keeps its table entry until it is removed. Longer strings, and all strings once the
+    /// table is full, are pushed like #push(const char*, int). Small strings have no index: they are neither part of
+    /// index based operations, e.g. #getCString(), #serialize() or #forEachParallel(), nor moved by #moveToTop().
+    /// @returns A CString. Will be invalid if a longer string does not fit.
+    virtual CString pushSmall(const char *string, int limit) noexcept override {
+        if (string == nullptr || limit < 0) {
+            return CString::INVALID;
+        }
+
+        int length = 0;
+        for (int maxLength = std::min(limit, CString::INLINE_MAX_LENGTH + 1); length < maxLength && string[length]; ) {
+            length++;
+        }
+        CStringHandle handle = length > CString::INLINE_MAX_LENGTH ? INVALID_STRING_IDX : _nextUnallocatedSmallHandle();
+        if (handle == INVALID_STRING_IDX) {
+            return push(string, limit);
+        }
+
+        // the entry may hold a former string: clear the whole capacity as for a new buffer area
+        char *small = _smallStrings[handle - _maxStrings];
+        memcpy(small, string, length);
+        memset(small + length, '\0', CString::INLINE_MAX_LENGTH + 1 - length);
+        _handleToStringIdxMap[handle] = _smallStringIdx;
+        return CString(this, handle);
+    }
+
     virtual CString pushFormat(const char *format, ...) noexcept override {
         va_list args;
         va_start(args, format);
@@ -695,18 +1354,398 @@ public:
         return appendToTopmostFormatV(format, args);
     }
 
+    /// @brief Allocates a CString at the end of the buffer and initializes it with the given strings separated by
+    /// the given delimiter. The buffer area is allocated at once. The strings may be allocated using this buffer.
+    /// @returns A CString. Will be invalid if remaining capacity is too low.
+    CString pushJoin(const CString *strings, int count, const char *delimiter) noexcept {
+        CString result = allocate();
+        if (result.isInvalid()) {
+            return CString::INVALID;
+        }
+
+        if (result.appendJoin(strings, count, delimiter).isInvalid()) {
+            pop();
+            return CString::INVALID;
+        }
+        return result;
+    }
+
+    /// @brief Allocates a CString at the end of the buffer and initializes it with the given range of strings
+    /// separated by the given delimiter. See #pushJoin(const CString*, int, const char*).
+    /// @returns A CString. Will be invalid if remaining capacity is too low.
+    template<typename Range>
+    CString pushJoin(const Range &strings, const char *delimiter) noexcept {
+        return pushJoin(std::data(strings), (int)std::size(strings), delimiter);
+    }
+
+    /// @brief Registers the first `length` bytes of the unallocated area (see #unallocatedArea()) as a new string,
+    /// e.g. after reading data into it. No data is copied: the byte following them is overwritten by the terminating
+    /// \0, thus `length + 1` bytes are allocated.
+    /// @returns A CString. Will be invalid if remaining capacity is too low.
+    CString pushUnallocated(int length) noexcept {
+        uint8_t numstrings = _metadata->numstrings;
+        CStringHandle handle = _nextUnallocatedHandle();
+        if (length < 0 || length >= _remaining() || handle == INVALID_STRING_IDX) {
+            return CString::INVALID;
+        }
+
+        _string(numstrings)[length] = '\0';
+        _offsets[numstrings + 1] = _offsets[numstrings] + length + 1;
+
+        _handleToStringIdxMap[handle] = numstrings;
+        _metadata->curHandle = handle;
+        _metadata->numstrings++;
+        return CString(this, handle);
+    }
+
+    /// @brief Pointer to the unallocated area following the topmost string, which provides #unallocatedBytes() bytes.
+    /// Data written to it is retained until the next allocation, resize or `moveToTop`. Popping or removing strings
+    /// moves the beginning of the unallocated area.
+    char *unallocatedArea() noexcept {
+        return _string(_metadata->numstrings);
+    }
+
+    /// @brief Reserves size bytes at the end of the buffer for other uses than strings, e.g. the containers of
+    /// CStringBufferResource. Reservations are placed below each other, starting at the end of the buffer. Their
+    /// bytes are taken from the unallocated area, thus strings cannot grow into them. Sizes are rounded up to a
+    /// multiple of `alignof(std::max_align_t)`.
+    /// @param alignment Alignment of the returned pointer, a power of two.
+    /// @returns Pointer to the reserved bytes or nullptr if too few unallocated bytes remain or the alignment is
+    /// invalid. At least 1 byte of the buffer remains available to strings.
+    void *reserveTail(int size, int alignment = alignof(std::max_align_t)) noexcept {
+        if (_data == nullptr || size < 0 || alignment <= 0 || (alignment & (alignment - 1)) != 0) {
+            return nullptr;
+        }
+
+        char *bottom = std::max(_string(_metadata->numstrings), _data + 1);
+        char *top = _data + _dataCapacity - _metadata->reservedTail;
+        int roundedSize = _roundTailSize(size);
+        if (top - bottom < roundedSize) {
+            return nullptr;
+        }
+
+        uintptr_t mask = std::max(alignment, (int)alignof(std::max_align_t)) - 1;
+        char *start = (char *)(((uintptr_t)(top - roundedSize)) & ~mask);
+        if (start < bottom) {
+            return nullptr;
+        }
+
+        _metadata->reservedTail = _data + _dataCapacity - start;
+        return start;
+    }
+
+    /// @brief Returns the given reservation to the unallocated area. Reservations are released in reverse order:
+    /// only the most recent one, which is placed lowest, can be released. Padding inserted above a reservation for an
+    /// alignment beyond `alignof(std::max_align_t)` is not released with it, thus the reservations preceding it can
+    /// no longer be released individually, but only all at once by #releaseTail().
+    /// @returns `true` if released, `false` if it was not the most recent reservation.
+    bool releaseTail(void *reserved, int size) noexcept {
+        char *start = (char *)reserved;
+        int reservedTail = _metadata->reservedTail;
+        if (_data == nullptr || start != _data + _dataCapacity - reservedTail || size < 0
+            || _roundTailSize(size) > reservedTail) {
+            return false;
+        }
+
+        _metadata->reservedTail -= _roundTailSize(size);
+        return true;
+    }
+
+    /// @brief Releases all reservations. See #reserveTail().
+    void releaseTail() noexcept {
+        _metadata->reservedTail = 0;
+    }
+
+    /// @brief Determines the number of bytes reserved at the end of the buffer including padding. See
+    /// #reserveTail().
+    int reservedTailBytes() const noexcept {
+        return _metadata->reservedTail;
+    }
+
+    /// @brief Serializes all strings into a compact binary image: a header (magic, format version, number of strings
+    /// and number of data bytes as varints), the length prefixed table of string capacities as varints and the raw
+    /// buffer areas. The image can be restored using #deserialize() by buffers of any size providing enough capacity.
+    /// @param writer Callable `bool(const char *data, int length)` invoked twice: for header and table, and for the
+    /// data. Returns `false` to abort serialization.
+    /// @returns The size of the image or -1 if the writer failed.
+    template<typename Writer>
+    int serialize(Writer &&writer) const noexcept {
+        uint8_t numstrings = _metadata->numstrings;
+        uint32_t dataLength = _offsets[numstrings];
+        uint8_t header[_serializedHeaderSize + 5 * (INVALID_STRING_IDX - 1)];
+        uint8_t *table = header + _serializedHeaderSize;
+        uint8_t *tableEnd = table;
+        for (int i = 0; i < numstrings; ++i) {
+            _writeVarint(tableEnd, _offsets[i + 1] - _offsets[i]);
+        }
+
+        uint8_t *headerEnd = header;
+        memcpy(headerEnd, _serializedMagic, sizeof(_serializedMagic));
+        headerEnd += sizeof(_serializedMagic);
+        _writeVarint(headerEnd, numstrings);
+        _writeVarint(headerEnd, dataLength);
+        _writeVarint(headerEnd, tableEnd - table);
+
+        // table follows the header without gap
+        memmove(headerEnd, table, tableEnd - table);
+        int headerLength = headerEnd - header + (tableEnd - table);
+        if (!writer((const char *)header, headerLength) || !writer(_data, dataLength)) {
+            return -1;
+        }
+        return headerLength + dataLength;
+    }
+
+    /// @brief Replaces all strings by the strings of the given image created by #serialize(). Restoring takes a single
+    /// copy of the data and two passes over the string table: the image is checked to be within bounds and each
+    /// buffer area to end with \0, but its content is not parsed. Strings are assigned handles in index order, thus
+    /// CStrings allocated before must not be used anymore (as after #removeAll()).
+    /// @returns `true` on success, `false` if the image is invalid, truncated or exceeds the capacity of this buffer.
+    /// In this case, the buffer remains unchanged.
+    bool deserialize(const char *image, int length) noexcept {
+        const uint8_t *cur = (const uint8_t *)image;
+        const uint8_t *end = cur + (image == nullptr || length < 0 ? 0 : length);
+        uint32_t numstrings;
+        uint32_t dataLength;
+        uint32_t tableLength;
+        if (_data == nullptr || end - cur < (int)sizeof(_serializedMagic)
+            || memcmp(cur, _serializedMagic, sizeof(_serializedMagic)) != 0
+            || !_readVarint(cur += sizeof(_serializedMagic), end, numstrings) || !_readVarint(cur, end, dataLength)
+            || !_readVarint(cur, end, tableLength) || numstrings > _maxStrings
+            || dataLength > (uint32_t)(_dataCapacity - _metadata->reservedTail)
+            || tableLength > (uint32_t)(end - cur) || dataLength != (uint32_t)(end - cur) - tableLength) {
+            return false;
+        }
+
+        // validate the table before modifying anything: capacities sum up to the data length
+        const uint8_t *table = cur;
+        const uint8_t *tableEnd = cur + tableLength;
+        const char *data = (const char *)tableEnd;
+        uint32_t offset = 0;
+        for (uint32_t i = 0; i < numstrings; ++i) {
+            uint32_t capacity;
+            if (!_readVarint(cur, tableEnd, capacity) || capacity == 0 || capacity > dataLength - offset
+                || data[offset + capacity - 1] != '\0') {
+                return false;
+            }
+            offset += capacity;
+        }
+        if (cur != tableEnd || offset != dataLength) {
+            return false;
+        }
+
+        memcpy(_data, data, dataLength);
+        for (uint32_t i = 0; i < numstrings; ++i) {
+            uint32_t capacity;
+            _readVarint(table, tableEnd, capacity);
+            _offsets[i + 1] = _offsets[i] + capacity;
+        }
+        for (int handle = 0; handle < _maxhandles; ++handle) {
+            _handleToStringIdxMap[handle] = handle < (int)numstrings ? handle : INVALID_STRING_IDX;
+        }
+        memset(_sharers, 0, _maxStrings);
+        if (numstrings == 0) {
+            _data[0] = '\0';
+        }
+        _metadata->numstrings = numstrings;
+        _metadata->curHandle = numstrings == 0 ? INVALID_STRING_IDX : numstrings - 1;
+
+        return true;
+    }
+
+    /// @brief Shrinks the buffer area of each string to fit the contained string, that is its capacity becomes
+    /// `length() + 1`. Strings are moved towards the beginning of the buffer retaining their order and handles.
+    /// @returns The number of bytes released.
+    int compact() noexcept {
+        uint8_t numstrings = _metadata->numstrings;
+        uint32_t dst = 0;
+        for (int i = 0; i < numstrings; ++i) {
+            // each buffer area ends with \0: length < capacity
+            char *src = _string(i);
+            int length = strlen(src);
+            memmove(_data + dst, src, length);
+            _data[dst + length] = '\0';
+            _offsets[i] = dst;
+            dst += length + 1;
+        }
+
+        int released = _offsets[numstrings] - dst;
+        _offsets[numstrings] = dst;
+        return released;
+    }
+
+    /// @brief Invokes `fn(CString&)` for each string using the given executor, e.g. CStringThreadPool. The strings
+    /// are split into contiguous ranges of roughly equal size in bytes, each processed by a single task. As fn is
+    /// invoked concurrently, it must not change the allocation of any string: reading and in-place modifications
+    /// like `toLower()` are fine, whereas `append()` or `clone()` are not. A range consists of whole strings, thus a
+    /// single large string is processed by a single thread. Buffer areas shared by several CStrings (see
+    /// CString#cloneShared()) are copied before, such that each CString is passed with its own area.
+    /// @returns `true` if fn was invoked, `false` if there's not enough capacity to copy the shared areas.
+    template<typename Executor, typename Fn>
+    bool forEachParallel(Executor &executor, Fn &&fn) noexcept {
+        // copying on write within fn would allocate concurrently
+        for (int handle = 0; handle < _maxhandles; ++handle) {
+            uint8_t index = _handleToStringIdxMap[handle];
+            if (index < _metadata->numstrings && _sharers[index] > 0 && !unshare(CString(this, handle))) {
+                return false;
+            }
+        }
+
+        CStringHandle handles[INVALID_STRING_IDX - 1];
+        for (int handle = 0; handle < _maxhandles; ++handle) {
+            if (_handleToStringIdxMap[handle] < _metadata->numstrings) {
+                handles[_handleToStringIdxMap[handle]] = handle;
+            }
+        }
+
+        _forEachRangeParallel(executor, [&](int /*task*/, int first, int last) {
+            for (int i = first; i < last; ++i) {
+                CString string(this, handles[i]);
+                fn(string);
+            }
+        });
+        return true;
+    }
+
+    /// @brief Converts all strings to lower case using the given executor. A buffer area shared by several CStrings
+    /// is converted once for all of them. See #forEachParallel() and CString#toLower().
+    template<typename Executor>
+    void toLowerAll(Executor &executor) noexcept {
+        _forEachRangeParallel(executor, [this](int /*task*/, int first, int last) {
+            for (int i = first; i < last; ++i) {
+                // branch free: vectorized by the compiler
+                char *string = _string(i);
+                for (int j = 0, length = strlen(string); j < length; ++j) {
+                    string[j] += (uint8_t)(string[j] - 'A') < 26 ? 32 : 0;
+                }
+            }
+        });
+    }
+
+    /// @brief Removes leading and trailing whitespace from all strings using the given executor. A buffer area shared
+    /// by several CStrings is trimmed once for all of them. Finally, the buffer is compacted (see #compact()). See
+    /// #forEachParallel() and CString#trim().
+    /// @returns The number of bytes released.
+    template<typename Executor>
+    int trimAll(Executor &executor) noexcept {
+        _forEachRangeParallel(executor, [this](int /*task*/, int first, int last) {
+            for (int i = first; i < last; ++i) {
+                char *string = _string(i);
+                int end = strlen(string);
+                while (end > 0 && isspace((uint8_t)string[end - 1])) {
+                    end--;
+                }
+                int start = 0;
+                while (start < end && isspace((uint8_t)string[start])) {
+                    start++;
+                }
+                memmove(string, string + start, end - start);
+                string[end - start] = '\0';
+            }
+        });
+        return compact();
+    }
+
+    /// @brief Counts the non-overlapping occurrences of the given needle within all strings using the given executor.
+    /// A buffer area shared by several CStrings is counted once. See #forEachParallel().
+    /// @returns The number of occurrences.
+    template<typename Executor>
+    int countMatches(Executor &executor, const char *needle) noexcept {
+        if (needle == nullptr || *needle == '\0') {
+            return 0;
+        }
+
+        std::string_view needleView(needle);
+        int counts[_maxParallelTasks]{};
+        _forEachRangeParallel(executor, [&](int task, int first, int last) {
+            for (int i = first; i < last; ++i) {
+                std::string_view string(_string(i));
+                for (size_t pos = string.find(needleView); pos != std::string_view::npos;
+                     pos = string.find(needleView, pos + needleView.length())) {
+                    counts[task]++;
+                }
+            }
+        });
+
+        int total = 0;
+        for (int count : counts) {
+            total += count;
+        }
+        return total;
+    }
+
+#ifdef CSTRING_HAS_WRITEV
+    /// @brief Writes all strings to the given file descriptor. See #writeRange(uint8_t, uint8_t, int, const char*).
+    ssize_t writeTo(int fd, const char *separator = nullptr) const noexcept {
+        return writeRange(0, _metadata->numstrings, fd, separator);
+    }
+
+    /// @brief Writes the strings with index first (inclusive) to last (exclusive) to the given file descriptor, each
+    /// one followed by the given separator (if not nullptr), e.g. "\n" to terminate lines. All strings are gathered
+    /// by a single `writev` call, which is repeated only if the kernel accepts a part of the data, only. Only
+    /// available if the platform provides `writev`.
+    /// @returns The number of bytes written or -1 if the range is invalid or writing failed (see errno). In the latter
+    /// case, a part of the data might have been written.
+    ssize_t writeRange(uint8_t first, uint8_t last, int fd, const char *separator = nullptr) const noexcept {
+        if (first > last || last > _metadata->numstrings) {
+            return -1;
+        }
+
+        // one iovec per string and separator: at most 2 * 254 entries, below IOV_MAX of all common platforms
+        iovec iov[2 * (INVALID_STRING_IDX - 1)];
+        int numIov = 0;
+        int separatorLength = separator == nullptr ? 0 : strlen(separator);
+        for (int i = first; i < last; ++i) {
+            // the terminating \0 might have been overwritten using raw(): the last byte is not written then
+            char *string = _string(i);
+            int capacity = _offsets[i + 1] - _offsets[i];
+            const char *end = (const char *)memchr(string, '\0', capacity);
+            if (end == nullptr) {
+                end = string + capacity - 1;
+            }
+            if (end != string) {
+                iov[numIov++] = {string, (size_t)(end - string)};
+            }
+            if (separatorLength > 0) {
+                iov[numIov++] = {(void *)separator, (size_t)separatorLength};
+            }
+        }
+
+        ssize_t total = 0;
+        for (iovec *cur = iov, *end = iov + numIov; cur < end;) {
+            ssize_t written = writev(fd, cur, end - cur);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return -1;
+            }
+            total += written;
+
+            // partial write: skip iovecs written completely, adjust the first one written partially
+            for (; cur < end && (size_t)written >= cur->iov_len; ++cur) {
+                written -= cur->iov_len;
+            }
+            if (cur < end) {
+                cur->iov_base = (char *)cur->iov_base + written;
+                cur->iov_len -= written;
+            }
+        }
+        return total;
+    }
+#endif
+
     virtual CString peek() noexcept override {
-        if (_numstrings == 0) {
+        if (_metadata->numstrings == 0) {
             return CString::INVALID;
         }
-        return getCString(_numstrings - 1);
+        return getCString(_metadata->numstrings - 1);
     }
 
-    bool pop() noexcept override {
-        if (_numstrings == 0) {
+    virtual bool pop() noexcept override {
+        if (_metadata->numstrings == 0) {
             return false;
         }
-        return this->remove(this->_numstrings - 1);
+        return remove(_metadata->numstrings - 1);
     }
 
     virtual CString appendToTopmost(const char c) noexcept override {
@@ -721,248 +1760,467 @@ public:
         return _pushOrAppendToLast(string, limit, true);
     }
 
-    virtual CString appendToTopmostFormat(const char* format, ...) noexcept override {
+    virtual CString appendToTopmostFormat(const char *format, ...) noexcept override {
         va_list args;
         va_start(args, format);
         return appendToTopmostFormatV(format, args);
     }
 
-    virtual CString appendToTopmostFormatV(const char* format, va_list args) noexcept override {
-        char *dst = _strings[_numstrings] - 1;
+    virtual CString appendToTopmostFormatV(const char *format, va_list args) noexcept override {
+        uint8_t numstrings = _metadata->numstrings;
+        if (numstrings == 0) {
+            return CString::INVALID;
+        }
+
+        int remaining = _remaining();
+        char *dst = _string(numstrings) - 1;
 
         // note: formattedLength does not include terminating \0
         // argument n (2nd) includes terminating \0!
-        int requiredLengthExcludingNull = vsnprintf(dst, _remaining + 1, format, args);
-        if (requiredLengthExcludingNull > _remaining) {
+        int requiredLengthExcludingNull = vsnprintf(dst, remaining + 1, format, args);
+        if (requiredLengthExcludingNull < 0 || requiredLengthExcludingNull > remaining) {
             *dst = '\0';
             return CString::INVALID;
         }
 
-        _strings[_numstrings] += requiredLengthExcludingNull;
+        _offsets[numstrings] += requiredLengthExcludingNull;
         return peek();
     }
 
     virtual CString resizeTopmost(int maxLength) noexcept override {
-        if (_numstrings == 0) {
+        if (_metadata->numstrings == 0 || maxLength < 0) {
             return CString::INVALID;
         }
 
-        uint8_t index = _numstrings - 1;
-        int capacityOfLast = getRawStringCapacity(index);
-        int newCapacity = maxLength + 1;
-        int newRemaining = _remaining + capacityOfLast - newCapacity;
-
-        if (newRemaining < 0) {
+        uint8_t index = _metadata->numstrings - 1;
+        if (maxLength >= _remaining() + getRawStringCapacity(index)) {
             return CString::INVALID;
         }
 
-        char *newLastChar = _strings[index] + maxLength ;
-        *newLastChar = '\0';
-        _strings[index + 1] = newLastChar + 1;
-        _remaining = newRemaining;
+        _string(index)[maxLength] = '\0';
+        _offsets[index + 1] = _offsets[index] + maxLength + 1;
 
-        return CString(this, _curHandle);
+        return CString(this, _metadata->curHandle);
     }
 
     virtual bool moveToTop(const CString &cstring) noexcept override {
         if (cstring._buf != this || !cstring.isAllocated()) {
             return false;
         }
+        // small strings have no index
+        uint8_t numstrings = _metadata->numstrings;
         uint8_t oldIndex = getIndex(cstring);
-        if (oldIndex == _numstrings - 1) {
+        if (oldIndex >= numstrings) {
+            return false;
+        }
+        if (oldIndex == numstrings - 1) {
             return true;
         }
-        uint8_t newIndex = _numstrings - 1;
+        uint8_t newIndex = numstrings - 1;
 
-        int cstringCapacity = cstring.rawCapacity();
-        int tailSize = _strings[newIndex + 1] - _strings[oldIndex + 1];
+        int cstringCapacity = getRawStringCapacity(oldIndex);
+        int tailSize = _offsets[newIndex + 1] - _offsets[oldIndex + 1];
+        int remaining = _remaining();
 
-        if (_remaining >= cstringCapacity) {
-            memcpy(_strings[newIndex + 1], _strings[oldIndex], cstringCapacity);
-            memmove(_strings[oldIndex], _strings[oldIndex+1], tailSize + cstringCapacity);
-        } else  {
+        if (remaining >= cstringCapacity) {
+            memcpy(_string(newIndex + 1), _string(oldIndex), cstringCapacity);
+            memmove(_string(oldIndex), _string(oldIndex + 1), tailSize + cstringCapacity);
+        } else {
             // use stack based temporary buffer if too few bytes remain
             constexpr int stackBasedChunkSize = 8;
             char stackTemp[stackBasedChunkSize];
-            char *temp = _remaining >= stackBasedChunkSize ? _strings[newIndex + 1] : stackTemp;
+            char *temp = remaining >= stackBasedChunkSize ? _string(newIndex + 1) : stackTemp;
 
-            int chunkSize = std::min(cstringCapacity, std::max(_remaining, stackBasedChunkSize));
-            for (int remaining = cstringCapacity; remaining > 0;) {
-                char *from = _strings[oldIndex] + remaining - chunkSize;
+            int chunkSize = std::min(cstringCapacity, std::max(remaining, stackBasedChunkSize));
+            for (int toMove = cstringCapacity; toMove > 0;) {
+                char *from = _string(oldIndex) + toMove - chunkSize;
                 memcpy(temp, from, chunkSize);
                 memmove(from, from + chunkSize, tailSize);
                 memcpy(from + tailSize, temp, chunkSize);
 
-                remaining -= chunkSize;
-                chunkSize = std::min(chunkSize, remaining);
+                toMove -= chunkSize;
+                chunkSize = std::min(chunkSize, toMove);
             }
         }
 
-        for (int i = oldIndex + 1; i < _numstrings; ++i) {
-            // update string pointers
-            _strings[i] = _strings[i + 1] - cstringCapacity;
+        // the tables are accessed through pointers, which may alias the members: use locals in the loops
+        uint32_t *offsets = _offsets;
+        uint8_t *sharers = _sharers;
+        uint8_t *handleToStringIdxMap = _handleToStringIdxMap;
+        int maxhandles = _maxhandles;
+
+        uint8_t movedSharers = sharers[oldIndex];
+        for (int i = oldIndex + 1; i < numstrings; ++i) {
+            // update string offsets
+            offsets[i] = offsets[i + 1] - cstringCapacity;
+            sharers[i - 1] = sharers[i];
+        }
+        // offsets[newIndex + 1] unchanged: total length did not change
+        sharers[newIndex] = movedSharers;
+
+        // update associated CString handles in a single pass, including all sharing the moved area
+        for (int handle = 0; handle < maxhandles; ++handle) {
+            uint8_t &index = handleToStringIdxMap[handle];
+            if (index == oldIndex) {
+                index = newIndex;
+            } else if (index > oldIndex && index < numstrings) {
+                index--;
+            }
+        }
+        _metadata->curHandle = cstring._handle;
+
+        return true;
+    }
 
-            // update associated CString handles
-            _handleToStringIdxMap[_findHandleByStringIndex(i)]--;
+    virtual bool remove(CString &cString) noexcept override {
+        if (_isSmall(cString)) {
+            _handleToStringIdxMap[cString._handle] = INVALID_STRING_IDX;
+            return true;
         }
-        // _strings[newIndex+1] unchanged: total length did not change
 
-        // update moved cstring
-        _handleToStringIdxMap[cstring._handle] = newIndex;
+        uint8_t index = getIndex(cString);
+        if (index >= _metadata->numstrings || _sharers[index] == 0) {
+            return remove(index);
+        }
 
+        // shared area: remains allocated for the other CStrings
+        _handleToStringIdxMap[cString._handle] = INVALID_STRING_IDX;
+        _sharers[index]--;
+        if (_metadata->curHandle == cString._handle) {
+            _metadata->curHandle = _findHandleByStringIndex(index);
+        }
         return true;
     }
 
-    virtual bool remove(CString &cString) noexcept override {
-        return remove(getIndex(cString));
+    /// @brief Shares the buffer area of the given cstring with a new CString using a further handle, such that no
+    /// content is copied. The area is copied when modified using CString methods, see #unshare(). Small strings are
+    /// copied as CString#clone() does.
+    virtual CString share(const CString &cstring) noexcept override {
+        if (_isSmall(cstring)) {
+            return cstring.clone();
+        }
+
+        uint8_t index = getIndex(cstring);
+        CStringHandle handle = _nextUnallocatedHandle();
+        if (index >= _metadata->numstrings || handle == INVALID_STRING_IDX) {
+            return CString::INVALID;
+        }
+
+        _handleToStringIdxMap[handle] = index;
+        _sharers[index]++;
+        return CString(this, handle);
     }
 
-    virtual bool remove(uint8_t index) noexcept override {
-        if (index >= _numstrings) {
+    virtual bool unshare(const CString &cstring) noexcept override {
+        uint8_t numstrings = _metadata->numstrings;
+        uint8_t index = getIndex(cstring);
+        if (index >= numstrings || _sharers[index] == 0) {
+            return true;
+        }
+
+        int capacity = _offsets[index + 1] - _offsets[index];
+        if (numstrings == _maxStrings || _remaining() < capacity) {
             return false;
         }
 
-        // note: _strings size is (_maxstrings + 1)
-        // => _strings[_numstrings] is valid index
-        int capacityToRemove = _strings[index + 1] - _strings[index];
-        _remaining += capacityToRemove;
+        // the copy becomes the topmost area, owned by cstring only
+        memcpy(_string(numstrings), _string(index), capacity);
+        _offsets[numstrings + 1] = _offsets[numstrings] + capacity;
+        _sharers[index]--;
+        _sharers[numstrings] = 0;
+        _handleToStringIdxMap[cstring._handle] = numstrings;
+        _metadata->curHandle = cstring._handle;
+        _metadata->numstrings++;
+        return true;
+    }
 
-        // if last string is about to be removed, only _numstrings needs to be decremented!
-        if (index == _numstrings - 1) {
-            _numstrings--;
-            _handleToStringIdxMap[_curHandle] = INVALID_STRING_IDX;
-            _curHandle = _numstrings == 0 ? INVALID_STRING_IDX : _findHandleByStringIndex(_numstrings - 1);
-            return true;
+    virtual bool spill(const CString &cstring) noexcept override {
+        if (!_isSmall(cstring)) {
+            return false;
         }
 
-        // note: _strings size is (_maxstrings + 1)
-        // => _strings[_numstrings] is valid index
-        memmove(_strings[index], _strings[index + 1], _strings[_numstrings] - _strings[index + 1]);
+        // the pushed area is taken over by the small string's handle
+        CString spilled = push(_smallStrings[cstring._handle - _maxStrings]);
+        if (spilled.isInvalid()) {
+            return false;
+        }
+        _handleToStringIdxMap[cstring._handle] = _metadata->numstrings - 1;
+        _handleToStringIdxMap[spilled._handle] = INVALID_STRING_IDX;
+        _metadata->curHandle = cstring._handle;
+        return true;
+    }
+
+    virtual bool remove(uint8_t index) noexcept override {
+        uint8_t numstrings = _metadata->numstrings;
+        if (index >= numstrings) {
+            return false;
+        }
+
+        // if last string is about to be removed, only numstrings needs to be decremented!
+        if (index == numstrings - 1 && _sharers[index] == 0) {
+            _metadata->numstrings--;
+            _handleToStringIdxMap[_metadata->curHandle] = INVALID_STRING_IDX;
+            _metadata->curHandle = index == 0 ? INVALID_STRING_IDX : _findHandleByStringIndex(index - 1);
+            return true;
+        }
 
-        // invalidate cstring associated with index
-        _handleToStringIdxMap[_findHandleByStringIndex(index)] = INVALID_STRING_IDX;
+        // the tables are accessed through pointers, which may alias the members: use locals in the loops
+        uint32_t *offsets = _offsets;
+        uint8_t *sharers = _sharers;
+        uint8_t *handleToStringIdxMap = _handleToStringIdxMap;
+        int maxhandles = _maxhandles;
 
-        for (int i = index + 1; i < _numstrings; ++i) {
-            // update string pointers
-            _strings[i] = _strings[i + 1] - capacityToRemove;
+        int capacityToRemove = offsets[index + 1] - offsets[index];
+        memmove(_string(index), _string(index + 1), offsets[numstrings] - offsets[index + 1]);
 
-            // update associated CString handles
-            _handleToStringIdxMap[_findHandleByStringIndex(i)]--;
+        for (int i = index + 1; i < numstrings; ++i) {
+            // update string offsets
+            offsets[i] = offsets[i + 1] - capacityToRemove;
+            sharers[i - 1] = sharers[i];
+        }
+        sharers[numstrings - 1] = 0;
+
+        // invalidate all cstrings associated with index, update the others in a single pass
+        for (int handle = 0; handle < maxhandles; ++handle) {
+            uint8_t &i = handleToStringIdxMap[handle];
+            if (i == index) {
+                i = INVALID_STRING_IDX;
+            } else if (i > index && i < numstrings) {
+                i--;
+            }
         }
-        _strings[_numstrings] = nullptr;
 
         // decrement after for-loop for correct loop condition!
-        // reason: next _string pointer needs to be adjusted as well!
-        _numstrings--;
+        // reason: next offset needs to be adjusted as well!
+        _metadata->numstrings--;
+        if (_handleToStringIdxMap[_metadata->curHandle] == INVALID_STRING_IDX) {
+            _metadata->curHandle = numstrings == 1 ? INVALID_STRING_IDX : _findHandleByStringIndex(numstrings - 2);
+        }
 
         return true;
     }
 
     virtual bool removeAll() noexcept override {
-        if (_numstrings == 0) {
-            return false;
+        bool anySmall = false;
+        for (int handle = _maxStrings; handle < _maxhandles; ++handle) {
+            anySmall |= _handleToStringIdxMap[handle] == _smallStringIdx;
+            _handleToStringIdxMap[handle] = INVALID_STRING_IDX;
         }
-
-        for (int i = 0; i < _maxstrings; ++i) {
-            _handleToStringIdxMap[i] = INVALID_STRING_IDX;
-            _strings[i+1] = nullptr;
+        if (_metadata->numstrings == 0) {
+            return anySmall;
         }
 
-        _buffer[0] = '\0';
-        _buffer[_capacity - 1] = '\0';
-        _strings[0] = _buffer;
-        _numstrings = 0;
-        _remaining = _capacity;
+        memset(_handleToStringIdxMap, INVALID_STRING_IDX, _maxStrings);
+        memset(_sharers, 0, _maxStrings);
+        _data[0] = '\0';
+        _data[_dataCapacity - _metadata->reservedTail - 1] = '\0';
+        _metadata->numstrings = 0;
 
         return true;
     }
 
     virtual uint8_t getIndex(const CString &cstring) const noexcept override {
-        if (cstring._buf != this || cstring._handle >= _maxstrings || cstring._handle == INVALID_STRING_IDX) {
+        if (cstring._buf != this || cstring._handle >= _maxhandles) {
             return INVALID_STRING_IDX;
         }
 
-        return _handleToStringIdxMap[cstring._handle];
+        // small strings have no index
+        uint8_t index = _handleToStringIdxMap[cstring._handle];
+        return index == _smallStringIdx ? INVALID_STRING_IDX : index;
     }
 
     virtual CString getCString(uint8_t index) noexcept override {
-        if (index >= _numstrings) {
+        if (index >= _metadata->numstrings) {
             return CString::INVALID;
         }
         return CString(this, _findHandleByStringIndex(index));
     }
 
     virtual char *getRawString(uint8_t index) const noexcept override {
-        if (index >= _numstrings || index == INVALID_STRING_IDX) {
+        if (index >= _metadata->numstrings) {
             return nullptr;
         }
-        return _strings[index];
+        return _string(index);
     }
 
     virtual char *getRawString(const CString &cstring) const noexcept override {
+        if (_isSmall(cstring)) {
+            return _smallStrings[cstring._handle - _maxStrings];
+        }
         return getRawString(getIndex(cstring));
     }
 
     virtual int getRawStringCapacity(uint8_t index) const noexcept override {
-        if (index >= _numstrings || index == INVALID_STRING_IDX) {
+        if (index >= _metadata->numstrings) {
             return -1;
         }
-
-        // consider terminating \0: subtract 1
-        return _strings[index + 1] - _strings[index];
+        return _offsets[index + 1] - _offsets[index];
     }
 
     virtual int getRawStringCapacity(const CString &cstring) const noexcept override {
+        if (_isSmall(cstring)) {
+            return CString::INLINE_MAX_LENGTH + 1;
+        }
         return getRawStringCapacity(getIndex(cstring));
     }
 
     virtual uint8_t numstrings() const noexcept override {
-        return _numstrings;
+        return _metadata->numstrings;
     }
 
     virtual uint8_t remainingStrings() const noexcept override {
-        return _maxstrings - _numstrings;
+        return _maxStrings - _metadata->numstrings;
     }
 
     virtual int capacity() const noexcept override {
-        return _capacity;
+        return _dataCapacity;
     }
 
     virtual int allocatedBytes() const noexcept override {
-        return _capacity - _remaining;
+        return _dataCapacity - _remaining();
     }
 
     virtual int unallocatedBytes() const noexcept override {
-        return _remaining;
+        return _remaining();
+    }
+
+protected:
+    // metadata layout: Metadata, uint32_t offsets[maxstrings + 1], uint8_t handleToStringIdxMap[maxstrings +
+    // maxsmall], uint8_t sharers[maxstrings], SmallString smallStrings[maxsmall]
+    struct Metadata {
+        int32_t capacity;
+        int32_t reservedTail;
+        uint8_t maxstrings;
+        uint8_t maxsmall;
+        uint8_t numstrings;
+        CStringHandle curHandle;
+        CStringHandle curSmallHandle;
+        uint8_t reserved[3];
+    };
+
+    typedef char SmallString[CString::INLINE_MAX_LENGTH + 1];
+
+    // index of a handle referring to a small string that is not spilled
+    static constexpr uint8_t _smallStringIdx = INVALID_STRING_IDX - 1;
+
+    constexpr CStringBufferCore() noexcept = default;
+
+    /// @brief Determines the size of the metadata region for the given number of strings and small strings.
+    static constexpr int _metadataSize(uint8_t maxstrings, uint8_t maxsmall) noexcept {
+        return sizeof(Metadata) + sizeof(uint32_t) * (maxstrings + 1) + 2 * maxstrings + maxsmall
+               + sizeof(SmallString) * maxsmall;
+    }
+
+    /// @brief Uses the given regions, which hold a consistent buffer. Handles of small strings follow the handles of
+    /// buffer areas: small string i uses handle `maxstrings + i`.
+    constexpr void _attach(char *data, Metadata *metadata, uint32_t *offsets, uint8_t *handleToStringIdxMap,
+                           uint8_t *sharers, SmallString *smallStrings) noexcept {
+        _metadata = metadata;
+        _offsets = offsets;
+        _handleToStringIdxMap = handleToStringIdxMap;
+        _sharers = sharers;
+        _smallStrings = smallStrings;
+        _data = data;
+        _dataCapacity = metadata->capacity;
+        _maxStrings = metadata->maxstrings;
+        _maxSmall = metadata->maxsmall;
+        _maxhandles = metadata->maxstrings + metadata->maxsmall;
     }
 
 private:
-    char _buffer[_capacity]{};
-    char *_strings[_maxstrings + 1]{};
-    uint8_t _numstrings = 0;
-    int _remaining = _capacity;
+    Metadata *_metadata = nullptr;
+    uint32_t *_offsets = nullptr;
+    uint8_t *_handleToStringIdxMap = nullptr;
+    // number of additional handles sharing the buffer area at index, see #share()
+    uint8_t *_sharers = nullptr;
+    SmallString *_smallStrings = nullptr;
+    char *_data = nullptr;
+
+    // copies of the metadata, which do not change while attached
+    int _dataCapacity = 0;
+    uint8_t _maxStrings = 0;
+    uint8_t _maxSmall = 0;
+    int _maxhandles = 0;
+
+    // serialized format version 1: magic, varint numstrings, varint data length, varint table length
+    static constexpr char _serializedMagic[4] = {'C', 'S', 'B', 1};
+    static constexpr int _serializedHeaderSize = sizeof(_serializedMagic) + 3 * 5;
+
+    static constexpr int _maxParallelTasks = 64;
+
+    char *_string(int index) const noexcept {
+        return _data + _offsets[index];
+    }
 
-    CStringHandle _curHandle = INVALID_STRING_IDX;
-    uint8_t _handleToStringIdxMap[_maxstrings];
+    int _remaining() const noexcept {
+        return _dataCapacity - _metadata->reservedTail - (int)_offsets[_metadata->numstrings];
+    }
 
-    template<std::size_t... indexes>
-    constexpr CStringBuffer(std::index_sequence<indexes...>) noexcept
-            : _handleToStringIdxMap{(static_cast<void>(indexes), INVALID_STRING_IDX)...} {
-        _buffer[0] = '\0';
-        _buffer[_capacity - 1] = '\0';
-        _strings[0] = _buffer;
+    static constexpr int _roundTailSize(int size) noexcept {
+        constexpr int granularity = alignof(std::max_align_t);
+        return size == 0 ? granularity : (size + granularity - 1) / granularity * granularity;
     }
 
-    CStringHandle _nextUnallocatedHandle() noexcept {
-        if (_numstrings == _maxstrings) {
-            return INVALID_STRING_IDX;
+    /// @brief Splits the strings into contiguous ranges of roughly equal size in bytes and invokes
+    /// `fn(int task, int first, int last)` for each range of strings first (inclusive) to last (exclusive) using the
+    /// given executor.
+    template<typename Executor, typename Fn>
+    void _forEachRangeParallel(Executor &executor, Fn &&fn) noexcept {
+        // several tasks per thread: threads finishing early take over the remaining ranges
+        uint8_t numstrings = _metadata->numstrings;
+        int numTasks = std::min({executor.numThreads() * 4, _maxParallelTasks, (int)numstrings});
+        if (numTasks == 0) {
+            return;
+        }
+
+        uint8_t bounds[_maxParallelTasks + 1];
+        long totalBytes = _offsets[numstrings];
+        bounds[0] = 0;
+        bounds[numTasks] = numstrings;
+        for (int task = 1; task < numTasks; ++task) {
+            uint32_t target = totalBytes * task / numTasks;
+            bounds[task] = std::lower_bound(_offsets + bounds[task - 1], _offsets + numstrings, target) - _offsets;
+        }
+
+        executor.run(numTasks, [&](int task) {
+            fn(task, bounds[task], bounds[task + 1]);
+        });
+    }
+
+    /// @brief Writes the given value as LEB128 varint: 7 bits per byte, least significant first, at most 5 bytes.
+    static void _writeVarint(uint8_t *&dst, uint32_t value) noexcept {
+        for (; value >= 0x80; value >>= 7) {
+            *dst++ = (uint8_t)value | 0x80;
         }
+        *dst++ = (uint8_t)value;
+    }
 
-        for (CStringHandle candidateHandle = _curHandle + 1; candidateHandle != _curHandle; ++candidateHandle) {
-            if (candidateHandle >= _maxstrings) {
-                candidateHandle = 0;
+    static bool _readVarint(const uint8_t *&src, const uint8_t *end, uint32_t &value) noexcept {
+        value = 0;
+        for (int shift = 0; src < end && shift < 35; shift += 7) {
+            uint8_t byte = *src++;
+            // the fifth byte holds the upper 4 bits: anything else would be truncated
+            if (shift == 28 && byte > 0x0F) {
+                return false;
+            }
+            value |= (uint32_t)(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                return true;
             }
+        }
+        return false;
+    }
+
+    CStringHandle _nextUnallocatedHandle() noexcept {
+        if (_metadata->numstrings == _maxStrings) {
+            return INVALID_STRING_IDX;
+        }
 
+        // shared areas use several handles: all handles may be in use although string indexes remain
+        CStringHandle curHandle = _metadata->curHandle;
+        int start = curHandle == INVALID_STRING_IDX ? 0 : curHandle + 1;
+        for (int probe = 0; probe < _maxStrings; ++probe) {
+            CStringHandle candidateHandle = (start + probe) % _maxStrings;
             if (_handleToStringIdxMap[candidateHandle] == INVALID_STRING_IDX) {
                 return candidateHandle;
             }
@@ -971,85 +2229,99 @@ private:
         return INVALID_STRING_IDX;
     }
 
-    CStringHandle _findHandleByStringIndex(uint8_t strIndex) noexcept {
-        CStringHandle candidateHandle = _curHandle;
+    CStringHandle _nextUnallocatedSmallHandle() noexcept {
+        // continue after the small string allocated last: usually free
+        CStringHandle &curSmallHandle = _metadata->curSmallHandle;
+        for (int probe = 1; probe <= _maxSmall; ++probe) {
+            int handle = _maxStrings + (curSmallHandle - _maxStrings + probe) % _maxSmall;
+            if (_handleToStringIdxMap[handle] == INVALID_STRING_IDX) {
+                return curSmallHandle = handle;
+            }
+        }
+        return INVALID_STRING_IDX;
+    }
+
+    bool _isSmall(const CString &cstring) const noexcept {
+        return cstring._buf == this && cstring._handle >= _maxStrings && cstring._handle < _maxhandles
+               && _handleToStringIdxMap[cstring._handle] == _smallStringIdx;
+    }
+
+    CStringHandle _findHandleByStringIndex(uint8_t strIndex) const noexcept {
+        // spilled small strings keep their handle: search those as well
+        CStringHandle curHandle = _metadata->curHandle;
+        CStringHandle candidateHandle = curHandle;
         do {
             if (_handleToStringIdxMap[candidateHandle] == strIndex) {
                 return candidateHandle;
             }
-        } while ((candidateHandle = candidateHandle == 0 ? _maxstrings - 1 : candidateHandle - 1) != _curHandle);
+        } while ((candidateHandle = candidateHandle == 0 ? _maxhandles - 1 : candidateHandle - 1) != curHandle);
 
         return INVALID_STRING_IDX;
     }
 
     CString _pushOrAppendToLast(const char *string, int limit, bool append) noexcept {
-        append &= _numstrings > 0; // append is push if there are no strings yet
-        CStringHandle resultHandle = append ? _curHandle : _nextUnallocatedHandle();
+        uint8_t numstrings = _metadata->numstrings;
+        append &= numstrings > 0; // append is push if there are no strings yet
+        CStringHandle resultHandle = append ? _metadata->curHandle : _nextUnallocatedHandle();
 
         if (append && limit == 0) {
             return CString(this, resultHandle);
         }
 
-        if ((!append && (_numstrings == _maxstrings || _remaining == 0))
-            || resultHandle == INVALID_STRING_IDX) {
+        int remaining = _remaining();
+        if (string == nullptr || limit < 0 || (!append && remaining == 0) || resultHandle == INVALID_STRING_IDX) {
             return CString::INVALID;
         }
 
-        uint8_t index = append ? _numstrings - 1 : _numstrings;
-        int count = 0;
-        int remaining = _remaining;
-        char *dst = _strings[_numstrings];
+        // appending overwrites the terminating \0 of the topmost string
+        uint8_t index = append ? numstrings - 1 : numstrings;
+        char *dst = _string(numstrings) - append;
+        int available = remaining + append;
 
-        if (append) {
-            dst--;
-            remaining++;
+        // commit changes only if there is enough buffer space for the string and its terminating \0
+        int length = 0;
+        for (int maxLength = std::min(limit, available); length < maxLength && string[length]; ) {
+            length++;
         }
-
-        bool endOfString = false;
-        while (remaining > 1 && count < limit) {
-            count++;
-            remaining--;
-
-            char cur = *string++;
-            *dst++ = cur;
-
-            if (cur == '\0') {
-                endOfString = true;
-                break;
-            }
+        if (length == available) {
+            return CString::INVALID;
         }
-
-        // make sure there's \0 at end
-        if (!endOfString) {
-            if (count < limit && *string == '\0') {
-                count++;
-                endOfString = true;
-            }
-
-            remaining--;
-            *dst++ = '\0';
+        memmove(dst, string, length);
+        dst[length] = '\0';
+        _offsets[index + 1] = dst + length + 1 - _data;
+
+        if (!append) {
+            _handleToStringIdxMap[resultHandle] = index;
+            _metadata->curHandle = resultHandle;
+            _metadata->numstrings++;
         }
 
-        // commit changes only if there was enough buffer space
-        if (endOfString || count == limit) {
-            // _strings size is (_maxstrings + 1)!
-            _strings[index + 1] = dst;
-            _remaining = remaining;
-
-            if (!append) {
-                _numstrings++;
-                _handleToStringIdxMap[resultHandle] = index;
-                _curHandle = resultHandle;
-            }
+        return CString(this, resultHandle);
+    }
+};
 
-            return CString(this, resultHandle);
-        }
+/// Stack based buffer for string content of the given capacity, holding at most maxstrings strings in buffer areas
+/// and at most maxsmall small strings in a separate table, see #pushSmall(). All tables are embedded in the buffer.
+template<int _capacity, int _maxstrings = 10, int _maxsmall = 0>
+class CStringBuffer final : public CStringBufferCore {
+    static_assert(_capacity > 0 && _maxstrings > 0 && _maxsmall >= 0 && _maxstrings + _maxsmall < UINT8_MAX);
+public:
+    constexpr CStringBuffer() noexcept : CStringBuffer(std::make_index_sequence<_maxstrings + _maxsmall>{}) {}
 
-        if (append) {
-            // restore \0 that has been overwritten
-            *(_strings[index] - 1) = '\0';
-        }
+private:
+    Metadata _embeddedMetadata;
+    uint32_t _embeddedOffsets[_maxstrings + 1]{};
+    uint8_t _embeddedHandleToStringIdxMap[_maxstrings + _maxsmall];
+    uint8_t _embeddedSharers[_maxstrings]{};
+    SmallString _embeddedSmallStrings[_maxsmall > 0 ? _maxsmall : 1]{};
+    char _buffer[_capacity]{};
 
-        return CString::INVALID;
+    template<std::size_t... indexes>
+    constexpr CStringBuffer(std::index_sequence<indexes...>) noexcept
+            : _embeddedMetadata{_capacity, 0, _maxstrings, _maxsmall, 0, INVALID_STRING_IDX,
+                                _maxstrings + _maxsmall - 1, {}},
+              _embeddedHandleToStringIdxMap{(static_cast<void>(indexes), INVALID_STRING_IDX)...} {
+        _attach(_buffer, &_embeddedMetadata, _embeddedOffsets, _embeddedHandleToStringIdxMap, _embeddedSharers,
+                _embeddedSmallStrings);
     }
 };
@@ -0,0 +1,160 @@
+#pragma  once
+
+#include "CString.h"
+
+#if __has_include(<atomic>)
+#include <atomic>
+#define CSTRING_HAS_ATOMIC
+
+/// Fixed set of buffers that are passed between threads instead of copying their strings: each worker thread
+/// acquires a buffer of its own, fills it and hands it off - as a whole or a contiguous range of its strings - to a
+/// consumer thread, e.g. an I/O thread. The consumer reads the strings in place and recycles the buffer, which makes
+/// it available to producers again. Buffers are exchanged through two bounded lock-free queues. The queues establish
+/// the required happens-before relationship: content written before handoff is visible to the consumer, the buffer
+/// is cleared by #recycle() before a producer reuses it.
+///
+/// A buffer must only be used by the thread that owns it: the producer from #acquire() until #handoff(), the
+/// consumer from #receive() until #recycle(). CStrings remain valid across threads as long as the buffer is not
+/// recycled.
+template<typename Buffer, int _numBuffers = 4>
+class CStringBufferPool final {
+    static_assert(_numBuffers > 0 && _numBuffers <= 1024);
+public:
+    /// Strings handed off to the consumer: the strings with index first (inclusive) to last (exclusive) of buffer.
+    struct Batch {
+        Buffer *buffer;
+        uint8_t first;
+        uint8_t last;
+    };
+
+    CStringBufferPool() noexcept {
+        for (int i = 0; i < _numBuffers; ++i) {
+            _free.push(Batch{&_buffers[i], 0, 0});
+        }
+    }
+
+    /// @brief Takes an empty buffer. May be called by any thread.
+    /// @returns A buffer or nullptr if all buffers are in use.
+    Buffer *acquire() noexcept {
+        Batch batch;
+        return _free.pop(batch) ? batch.buffer : nullptr;
+    }
+
+    /// @brief Passes all strings of the given buffer to the consumer. The calling thread must not use the buffer
+    /// anymore.
+    /// @returns `true` on success, `false` if the buffer does not belong to this pool.
+    bool handoff(Buffer *buffer) noexcept {
+        return buffer != nullptr && handoff(buffer, 0, buffer->numstrings());
+    }
+
+    /// @brief Passes the strings with index first (inclusive) to last (exclusive) of the given buffer to the consumer.
+    /// The calling thread must not use the buffer anymore. See #handoff(Buffer*).
+    bool handoff(Buffer *buffer, uint8_t first, uint8_t last) noexcept {
+        if (!_owns(buffer) || first > last || last > buffer->numstrings()) {
+            return false;
+        }
+        // a slot is available for each buffer: never fails
+        return _handedOff.push(Batch{buffer, first, last});
+    }
+
+    /// @brief Takes the batch handed off next, in the order of handoff. Must be called by a single consumer thread at
+    /// a time.
+    /// @returns `true` if a batch was available, `false` otherwise.
+    bool receive(Batch &batch) noexcept {
+        return _handedOff.pop(batch);
+    }
+
+    /// @brief Removes all strings of the given buffer and makes it available to producers. See #acquire().
+    /// @returns `true` on success, `false` if the buffer does not belong to this pool.
+    bool recycle(Buffer *buffer) noexcept {
+        if (!_owns(buffer)) {
+            return false;
+        }
+        buffer->removeAll();
+        return _free.push(Batch{buffer, 0, 0});
+    }
+
+    /// @brief Determines the number of buffers of this pool.
+    constexpr int numBuffers() const noexcept {
+        return _numBuffers;
+    }
+
+private:
+    /// Bounded multi-producer/multi-consumer queue (D. Vyukov): each cell's sequence number tells whether it may be
+    /// written or read in the current lap, such that producers and consumers only contend for their position.
+    class _Queue final {
+    public:
+        _Queue() noexcept {
+            for (int i = 0; i < _size; ++i) {
+                _cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        bool push(const Batch &batch) noexcept {
+            uint32_t pos = _tail.load(std::memory_order_relaxed);
+            while (true) {
+                Cell &cell = _cells[pos & (_size - 1)];
+                int32_t diff = (int32_t)(cell.sequence.load(std::memory_order_acquire) - pos);
+                if (diff == 0) {
+                    if (_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        cell.batch = batch;
+                        cell.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = _tail.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        bool pop(Batch &batch) noexcept {
+            uint32_t pos = _head.load(std::memory_order_relaxed);
+            while (true) {
+                Cell &cell = _cells[pos & (_size - 1)];
+                int32_t diff = (int32_t)(cell.sequence.load(std::memory_order_acquire) - (pos + 1));
+                if (diff == 0) {
+                    if (_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        batch = cell.batch;
+                        cell.sequence.store(pos + _size, std::memory_order_release);
+                        return true;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = _head.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+    private:
+        // power of two holding every buffer of the pool
+        static constexpr int _size = [] {
+            int size = 1;
+            while (size < _numBuffers) {
+                size <<= 1;
+            }
+            return size;
+        }();
+
+        struct Cell {
+            std::atomic<uint32_t> sequence;
+            Batch batch;
+        };
+
+        alignas(64) std::atomic<uint32_t> _tail{0};
+        alignas(64) std::atomic<uint32_t> _head{0};
+        Cell _cells[_size];
+    };
+
+    _Queue _free;
+    _Queue _handedOff;
+    Buffer _buffers[_numBuffers];
+
+    bool _owns(const Buffer *buffer) const noexcept {
+        return buffer >= _buffers && buffer < _buffers + _numBuffers;
+    }
+};
+
+#endif
@@ -0,0 +1,68 @@
+#pragma  once
+
+#include "CString.h"
+
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#define CSTRING_HAS_PMR
+
+/// Polymorphic memory resource drawing from the unallocated area of a CStringBuffer, such that pmr containers (e.g.
+/// `std::pmr::string` or `std::pmr::vector`) and CStrings share a single fixed arena without using the heap.
+/// Allocations are reserved at the end of the buffer (see CStringBuffer#reserveTail()) while strings grow from its
+/// beginning. Memory is released in reverse order of allocation, as happens for containers destroyed in reverse
+/// order of construction; deallocating any other block is deferred until #release(). Exhausting the buffer falls
+/// back to the upstream resource, which fails by default.
+template<typename Buffer>
+class CStringBufferResource final : public std::pmr::memory_resource {
+public:
+    explicit CStringBufferResource(Buffer &buffer,
+                                   std::pmr::memory_resource *upstream = std::pmr::null_memory_resource()) noexcept
+            : _buffer(buffer), _upstream(upstream) {
+    }
+
+    CStringBufferResource(const CStringBufferResource &) = delete;
+    CStringBufferResource &operator=(const CStringBufferResource &) = delete;
+
+    /// @brief Releases all memory reserved by this resource from the buffer, including deferred deallocations.
+    /// Containers using this resource must not be used anymore.
+    void release() noexcept {
+        _buffer.releaseTail();
+    }
+
+    /// @brief Determines the buffer allocations are drawn from.
+    Buffer &buffer() const noexcept {
+        return _buffer;
+    }
+
+    /// @brief Determines the resource used if the buffer is exhausted.
+    std::pmr::memory_resource *upstream() const noexcept {
+        return _upstream;
+    }
+
+protected:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+        void *p = bytes <= INT_MAX && alignment <= INT_MAX ? _buffer.reserveTail((int)bytes, (int)alignment) : nullptr;
+        return p != nullptr ? p : _upstream->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override {
+        char *start = (char *)p;
+        char *begin = _buffer.unallocatedArea();
+        if (start < begin || start >= begin + _buffer.unallocatedBytes() + _buffer.reservedTailBytes()) {
+            _upstream->deallocate(p, bytes, alignment);
+            return;
+        }
+        // not the most recent allocation: deferred until release()
+        _buffer.releaseTail(p, (int)bytes);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+
+private:
+    Buffer &_buffer;
+    std::pmr::memory_resource *_upstream;
+};
+
+#endif
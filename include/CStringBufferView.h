@@ -0,0 +1,157 @@
+#pragma  once
+
+#include "CString.h"
+
+/// CStringBuffer over memory provided by the caller, sized at runtime: string data is placed in a data region, the
+/// string table, handles and small strings in a separate metadata region (see #metadataSize()). Both may be located
+/// anywhere, e.g. in huge pages, shared memory or on the stack, and must remain valid while the view is attached. The
+/// metadata stores offsets relative to the data region, thus both regions may be attached again at other addresses
+/// later, also by another process (see #attach()).
+///
+/// A view provides the complete API of CStringBuffer, both use the allocator of CStringBufferCore. Like
+/// CStringBuffer, a view holds at most 254 strings and small strings in total (see CStringHandle). A detached view
+/// behaves like a buffer without capacity.
+class CStringBufferView : public CStringBufferCore {
+public:
+    CStringBufferView() noexcept {
+        detach();
+    }
+
+    /// @brief Creates a view of the given regions. See #create().
+    CStringBufferView(char *data, int capacity, void *metadata, int metadataSize,
+                      uint8_t maxstrings = INVALID_STRING_IDX - 1, uint8_t maxsmall = 0) noexcept {
+        create(data, capacity, metadata, metadataSize, maxstrings, maxsmall);
+    }
+
+    /// @brief Determines the size of the metadata region required for the given number of strings and small strings
+    /// (see CStringBufferCore#pushSmall()).
+    static constexpr int metadataSize(uint8_t maxstrings, uint8_t maxsmall = 0) noexcept {
+        return _metadataSize(maxstrings, maxsmall);
+    }
+
+    /// @brief Attaches the view to the given regions and initializes an empty buffer. The previous content of both
+    /// regions is discarded. A view that was attached before is detached first.
+    /// @param metadata Metadata region of at least #metadataSize() bytes, aligned to 4 bytes.
+    /// @returns `true` on success, `false` if the arguments are invalid (the view remains detached then).
+    bool create(char *data, int capacity, void *metadata, int metadataSize,
+                uint8_t maxstrings = INVALID_STRING_IDX - 1, uint8_t maxsmall = 0) noexcept {
+        detach();
+        if (data == nullptr || capacity <= 0 || maxstrings == 0 || maxstrings + maxsmall >= UINT8_MAX
+            || !_isMetadataRegion(metadata, metadataSize, maxstrings, maxsmall)) {
+            return false;
+        }
+
+        Metadata *header = (Metadata *)metadata;
+        CStringHandle curSmallHandle = maxstrings + maxsmall - 1;
+        *header = {capacity, 0, maxstrings, maxsmall, 0, INVALID_STRING_IDX, curSmallHandle, {}};
+        uint32_t *offsets = (uint32_t *)(header + 1);
+        offsets[0] = 0;
+        uint8_t *handleToStringIdxMap = (uint8_t *)(offsets + maxstrings + 1);
+        memset(handleToStringIdxMap, INVALID_STRING_IDX, maxstrings + maxsmall);
+        memset(handleToStringIdxMap + maxstrings + maxsmall, 0, maxstrings + sizeof(SmallString) * maxsmall);
+        data[0] = '\0';
+        data[capacity - 1] = '\0';
+
+        _attachRegions(data, header);
+        return true;
+    }
+
+    /// @brief Attaches the view to the given regions holding a buffer created before, e.g. by another view or
+    /// process. The metadata is checked to be consistent (O(maxstrings)), the string data is neither read nor copied.
+    /// A view that was attached before is detached first.
+    /// @returns `true` on success, `false` if the arguments are invalid or the metadata is inconsistent (the view
+    /// remains detached then).
+    bool attach(char *data, int capacity, void *metadata, int metadataSize) noexcept {
+        detach();
+        Metadata *header = (Metadata *)metadata;
+        if (data == nullptr || capacity <= 0 || !_isMetadataRegion(metadata, metadataSize, 0, 0)
+            || !_isMetadataRegion(metadata, metadataSize, header->maxstrings, header->maxsmall)
+            || header->capacity != capacity || !_isValid(header)) {
+            return false;
+        }
+
+        _attachRegions(data, header);
+        return true;
+    }
+
+    /// @brief Detaches the view from its regions, which retain the buffer's content. CStrings allocated using this
+    /// view become invalid.
+    void detach() noexcept {
+        _detachedMetadata = {};
+        _detachedOffset = 0;
+        _attach(nullptr, &_detachedMetadata, &_detachedOffset, nullptr, nullptr, nullptr);
+    }
+
+    /// @brief Determines whether the view is attached to a data and metadata region.
+    bool isAttached() const noexcept {
+        return capacity() > 0;
+    }
+
+private:
+    // while detached, the metadata refers to an empty buffer without capacity
+    Metadata _detachedMetadata{};
+    uint32_t _detachedOffset = 0;
+
+    static bool _isMetadataRegion(void *metadata, int metadataSize, uint8_t maxstrings, uint8_t maxsmall) noexcept {
+        return metadata != nullptr && (uintptr_t)metadata % alignof(Metadata) == 0
+            && metadataSize >= CStringBufferView::metadataSize(maxstrings, maxsmall);
+    }
+
+    void _attachRegions(char *data, Metadata *metadata) noexcept {
+        uint32_t *offsets = (uint32_t *)(metadata + 1);
+        uint8_t *handleToStringIdxMap = (uint8_t *)(offsets + metadata->maxstrings + 1);
+        uint8_t *sharers = handleToStringIdxMap + metadata->maxstrings + metadata->maxsmall;
+        SmallString *smallStrings = (SmallString *)(sharers + metadata->maxstrings);
+        _attach(data, metadata, offsets, handleToStringIdxMap, sharers, smallStrings);
+    }
+
+    /// @brief Checks the string table, reservations and handles: at most 254 strings and small strings, independent
+    /// of the capacity.
+    static bool _isValid(const Metadata *metadata) noexcept {
+        int capacity = metadata->capacity;
+        int maxstrings = metadata->maxstrings;
+        int maxhandles = maxstrings + metadata->maxsmall;
+        uint8_t numstrings = metadata->numstrings;
+        if (maxstrings == 0 || maxhandles >= UINT8_MAX || numstrings > maxstrings || metadata->reservedTail < 0
+            || metadata->reservedTail >= capacity) {
+            return false;
+        }
+
+        // each string occupies at least one byte below the reservations
+        const uint32_t *offsets = (const uint32_t *)(metadata + 1);
+        if (offsets[0] != 0) {
+            return false;
+        }
+        for (int i = 0; i < numstrings; ++i) {
+            if (offsets[i + 1] <= offsets[i] || offsets[i + 1] > (uint32_t)(capacity - metadata->reservedTail)) {
+                return false;
+            }
+        }
+
+        // each string has one handle plus one for each sharer, small strings use the handles following maxstrings
+        const uint8_t *handleToStringIdxMap = (const uint8_t *)(offsets + maxstrings + 1);
+        const uint8_t *sharers = handleToStringIdxMap + maxhandles;
+        int numHandles[INVALID_STRING_IDX]{};
+        for (int handle = 0; handle < maxhandles; ++handle) {
+            uint8_t index = handleToStringIdxMap[handle];
+            if (index == INVALID_STRING_IDX || (index == _smallStringIdx && handle >= maxstrings)) {
+                continue;
+            }
+            if (index >= numstrings) {
+                return false;
+            }
+            numHandles[index]++;
+        }
+        for (int i = 0; i < maxstrings; ++i) {
+            if (i < numstrings ? numHandles[i] != 1 + sharers[i] : sharers[i] != 0) {
+                return false;
+            }
+        }
+
+        CStringHandle curHandle = metadata->curHandle;
+        CStringHandle curSmallHandle = metadata->curSmallHandle;
+        return (metadata->maxsmall == 0 || (curSmallHandle >= maxstrings && curSmallHandle < maxhandles))
+            && (numstrings == 0 ? curHandle < maxhandles || curHandle == INVALID_STRING_IDX
+                                : curHandle < maxhandles && handleToStringIdxMap[curHandle] == numstrings - 1);
+    }
+};
@@ -0,0 +1,240 @@
+#pragma  once
+
+#include "CString.h"
+
+#if __has_include(<atomic>)
+#include <atomic>
+#define CSTRING_HAS_ATOMIC
+
+/// Staging buffer for strings produced by multiple threads and consumed by a single thread, e.g. log lines collected
+/// by workers and written by an I/O thread. Producers reserve a slab (buffer area and string index) using a single
+/// atomic fetch-add and write their string into it without any lock: appending to an own slab does not involve other
+/// threads at all. Committed strings are drained by the consumer in the order of reservation. Whenever the consumer
+/// has drained all strings reserved so far, the buffer is reused from its beginning.
+///
+/// Unlike CStringBuffer, the number of strings is not limited by CStringHandle: strings are not referred to by
+/// CString, but by the producer's Slab until it is committed.
+template<int _capacity, int _maxstrings = 254>
+class CStringConcurrentBuffer final {
+    static_assert(_capacity > 0 && _maxstrings > 0);
+public:
+    /// Buffer area reserved by a producer. Strings are appended until the slab is committed, which publishes the
+    /// string to the consumer. A slab that is destroyed without being committed is committed implicitly: the consumer
+    /// waits for every slab reserved before in order to preserve the order of strings.
+    class Slab final {
+        friend class CStringConcurrentBuffer;
+    public:
+        constexpr Slab() noexcept = default;
+        Slab(const Slab &) = delete;
+        Slab &operator=(const Slab &) = delete;
+
+        Slab(Slab &&other) noexcept : _buffer(other._buffer), _index(other._index), _start(other._start),
+                                      _slabCapacity(other._slabCapacity), _length(other._length) {
+            other._buffer = nullptr;
+        }
+
+        ~Slab() noexcept {
+            commit();
+        }
+
+        /// @brief Appends the given string if it fits into the slab. See #append(const char*, int).
+        bool append(const char *string) noexcept {
+            return append(string, INT_MAX);
+        }
+
+        /// @brief Appends the given string if it fits into the slab. See #append(const char*, int).
+        bool append(const std::string_view &string) noexcept {
+            return _append(string.data(), string.length());
+        }
+
+        /// @brief Appends at most limit characters of the given string.
+        /// @returns `true` if the string was appended, `false` if it did not fit into the slab or the slab is invalid.
+        /// In this case, the slab remains unchanged.
+        bool append(const char *string, int limit) noexcept {
+            if (string == nullptr || limit < 0) {
+                return false;
+            }
+            // counted instead of strnlen: a bound exceeding a short argument triggers -Wstringop-overread
+            int length = 0;
+            for (int maxLength = std::min(limit, _slabCapacity - _length); length < maxLength && string[length]; ) {
+                length++;
+            }
+            return _append(string, length);
+        }
+
+        /// @brief Appends the result of the format operation if it fits into the slab.
+        /// @returns `true` if the result was appended, `false` otherwise. In this case, the slab remains unchanged.
+        bool appendFormat(const char *format, ...) noexcept {
+            if (_buffer == nullptr) {
+                return false;
+            }
+
+            va_list args;
+            va_start(args, format);
+            char *end = raw() + _length;
+            int formattedLength = vsnprintf(end, _slabCapacity - _length, format, args);
+            va_end(args);
+            if (formattedLength < 0 || formattedLength >= _slabCapacity - _length) {
+                *end = '\0';
+                return false;
+            }
+            _length += formattedLength;
+            return true;
+        }
+
+        /// @brief Pointer to the slab's buffer area, which remains valid until the slab is committed.
+        char *raw() const noexcept {
+            return _buffer == nullptr ? nullptr : _buffer->_data + _start;
+        }
+
+        /// @brief Length of the contained string.
+        int length() const noexcept {
+            return _length;
+        }
+
+        /// @brief Capacity of the slab's buffer area, including terminating \0.
+        int rawCapacity() const noexcept {
+            return _slabCapacity;
+        }
+
+        /// @brief Determines whether the slab could not be reserved or has been committed already.
+        bool isInvalid() const noexcept {
+            return _buffer == nullptr;
+        }
+
+        /// @brief Publishes the string to the consumer. The slab becomes invalid.
+        /// @returns `true` on success, `false` if the slab was invalid.
+        bool commit() noexcept {
+            if (_buffer == nullptr) {
+                return false;
+            }
+            _buffer->_starts[_index] = _start;
+            _buffer->_lengths[_index] = _length;
+            _buffer->_states[_index].store(_committed, std::memory_order_release);
+            _buffer = nullptr;
+            return true;
+        }
+
+    private:
+        CStringConcurrentBuffer *_buffer = nullptr;
+        int _index = 0;
+        int _start = 0;
+        int _slabCapacity = 0;
+        int _length = 0;
+
+        Slab(CStringConcurrentBuffer *buffer, int index, int start, int capacity) noexcept
+                : _buffer(buffer), _index(index), _start(start), _slabCapacity(capacity) {}
+
+        bool _append(const char *string, int length) noexcept {
+            if (_buffer == nullptr || length >= _slabCapacity - _length) {
+                return false;
+            }
+            char *end = raw() + _length;
+            memcpy(end, string, length);
+            end[length] = '\0';
+            _length += length;
+            return true;
+        }
+    };
+
+    CStringConcurrentBuffer() noexcept = default;
+
+    /// @brief Reserves a slab of the given maxLength. May be called by any thread.
+    /// @returns A slab. Will be invalid if the remaining capacity or the number of remaining strings is too low.
+    Slab reserve(int maxLength) noexcept {
+        if (maxLength < 0 || maxLength >= _capacity) {
+            return Slab();
+        }
+        uint64_t size = maxLength + 1;
+
+        // don't increment a buffer that is full: lets the consumer reset it as soon as it has been drained
+        uint64_t reserved = _reserved.load(std::memory_order_relaxed);
+        if ((reserved >> 32) >= _maxstrings || (uint32_t)reserved + size > _capacity) {
+            return Slab();
+        }
+
+        // acquire: the consumer has finished reading the area before resetting the buffer
+        reserved = _reserved.fetch_add(_oneString | size, std::memory_order_acquire);
+        uint64_t index = reserved >> 32;
+        uint64_t start = (uint32_t)reserved;
+        if (index >= _maxstrings || start + size > _capacity) {
+            // undo unless other threads reserved meanwhile, otherwise the consumer needs to skip the index
+            uint64_t expected = reserved + (_oneString | size);
+            if (!_reserved.compare_exchange_strong(expected, reserved, std::memory_order_relaxed)
+                && index < _maxstrings) {
+                _states[index].store(_abandoned, std::memory_order_release);
+            }
+            return Slab();
+        }
+
+        _data[start] = '\0';
+        return Slab(this, index, start, size);
+    }
+
+    /// @brief Reserves a slab for the given string, copies it and commits it. May be called by any thread.
+    /// @returns `true` on success, `false` if the remaining capacity or the number of remaining strings is too low.
+    bool push(const char *string) noexcept {
+        return string != nullptr && push(std::string_view(string));
+    }
+
+    /// @brief Reserves a slab for the given string, copies it and commits it. See #push(const char*).
+    bool push(const std::string_view &string) noexcept {
+        Slab slab = reserve(string.length());
+        return slab.append(string) && slab.commit();
+    }
+
+    /// @brief Invokes the given function for each committed string in the order of reservation, until a string is
+    /// reached that has been reserved, but not yet committed. Must be called by a single consumer thread at a time.
+    /// @param fn Callable `void(const char *string, int length)`. The string is valid until fn returns.
+    /// @returns The number of strings drained.
+    template<typename Fn>
+    int drain(Fn &&fn) noexcept {
+        int drained = 0;
+        uint64_t reserved = _reserved.load(std::memory_order_acquire);
+        int numReserved = std::min((uint64_t)_maxstrings, reserved >> 32);
+        for (; _drainIndex < numReserved; ++_drainIndex) {
+            uint8_t state = _states[_drainIndex].load(std::memory_order_acquire);
+            if (state == _pending) {
+                return drained;
+            }
+            if (state == _committed) {
+                fn((const char *)(_data + _starts[_drainIndex]), _lengths[_drainIndex]);
+                drained++;
+            }
+            _states[_drainIndex].store(_pending, std::memory_order_relaxed);
+        }
+
+        // all reservations are drained: start over unless new ones came in meanwhile
+        if (_reserved.compare_exchange_strong(reserved, 0, std::memory_order_release, std::memory_order_relaxed)) {
+            _drainIndex = 0;
+        }
+        return drained;
+    }
+
+    /// @brief Retrieves the number of bytes assigned to this buffer.
+    constexpr int capacity() const noexcept {
+        return _capacity;
+    }
+
+    /// @brief Determines the maximum number of strings reserved before the consumer drains them.
+    constexpr int maxstrings() const noexcept {
+        return _maxstrings;
+    }
+
+private:
+    static constexpr uint8_t _pending = 0;
+    static constexpr uint8_t _committed = 1;
+    static constexpr uint8_t _abandoned = 2;
+
+    // number of reservations (upper 32 bit) and reserved bytes (lower 32 bit): both are taken by a single fetch-add
+    static constexpr uint64_t _oneString = (uint64_t)1 << 32;
+
+    alignas(64) std::atomic<uint64_t> _reserved{0};
+    alignas(64) int _drainIndex = 0;
+    std::atomic<uint8_t> _states[_maxstrings]{};
+    uint32_t _starts[_maxstrings]{};
+    uint32_t _lengths[_maxstrings]{};
+    alignas(64) char _data[_capacity]{};
+};
+
+#endif
@@ -0,0 +1,248 @@
+#pragma  once
+
+#include "CString.h"
+
+/// Span matched by a wildcard (`*` or `?`) of a CStringGlob.
+struct CStringGlobCapture {
+    /// @brief Index of the first character matched by the wildcard.
+    int index;
+
+    /// @brief Number of characters matched by the wildcard.
+    int length;
+};
+
+/// Precompiled glob pattern: `*` matches any sequence of characters (including `/`), `?` any single character, `[abc]`
+/// or `[a-z]` any listed character, `[!a-z]` or `[^a-z]` any character not listed and `\` escapes the next character.
+/// The pattern is split into segments separated by `*`. Matching never backtracks: each segment is placed at its
+/// leftmost possible position, only the last one is anchored at the end. Thus, the worst case is O(n * m) for n input
+/// characters and m pattern tokens. The pattern is stored in fixed size tables of at most _maxTokens tokens and
+/// _maxClasses character classes. No heap allocations are involved and the glob can be built at compile time:
+/// `constexpr CStringGlob<> glob("/api/*/items/?*");`
+template<int _maxTokens = 32, int _maxClasses = 4>
+class CStringGlob final {
+    static_assert(_maxTokens > 0 && _maxTokens <= UINT8_MAX && _maxClasses >= 0 && _maxClasses <= UINT8_MAX);
+public:
+    /// @brief Compiles the given \0 terminated pattern. See #isInvalid().
+    constexpr explicit CStringGlob(const char *pattern) noexcept
+            : CStringGlob(pattern, pattern == nullptr ? 0 : (int)std::char_traits<char>::length(pattern)) {}
+
+    /// @brief Compiles the given pattern of the given length. See #isInvalid().
+    constexpr CStringGlob(const char *pattern, int length) noexcept {
+        _invalid = pattern == nullptr || length < 0;
+        for (int i = 0; !_invalid && i < length; ++i) {
+            if (_numTokens == _maxTokens) {
+                _invalid = true;
+                break;
+            }
+
+            Token &token = _tokens[_numTokens++];
+            switch (pattern[i]) {
+                case '*':
+                    token.type = STAR;
+                    _numCaptures++;
+                    break;
+                case '?':
+                    token.type = ANY;
+                    _numCaptures++;
+                    break;
+                case '[':
+                    i = _parseClass(pattern, i + 1, length, token);
+                    break;
+                case '\\':
+                    _invalid = ++i == length;
+                    token.c = _invalid ? '\0' : pattern[i];
+                    break;
+                default:
+                    token.c = pattern[i];
+                    break;
+            }
+        }
+    }
+
+    /// @brief Determines whether the pattern is malformed (e.g. unterminated character class) or too complex.
+    constexpr bool isInvalid() const noexcept {
+        return _invalid;
+    }
+
+    /// @brief Retrieves the number of wildcards (`*` and `?`), that is the number of captures reported.
+    constexpr int numCaptures() const noexcept {
+        return _numCaptures;
+    }
+
+    /// @brief Determines whether the given data matches the pattern as a whole. Matching stops at the first \0
+    /// character or after length characters.
+    /// @param captures Receives the span matched by each wildcard in pattern order if not nullptr. Must provide space
+    /// for #numCaptures() entries. The content is unspecified if not matching.
+    constexpr bool matches(const char *data, int length, CStringGlobCapture *captures = nullptr) const noexcept {
+        if (_invalid || data == nullptr || length < 0) {
+            return false;
+        }
+        int dataLength = 0;
+        while (dataLength < length && data[dataLength] != '\0') {
+            dataLength++;
+        }
+
+        int pos = 0;
+        int tokenIdx = 0;
+        int captureIdx = 0;
+        for (bool isFirstSegment = true;; isFirstSegment = false) {
+            int starPos = pos;
+            int starCaptureIdx = -1;
+            while (tokenIdx < _numTokens && _tokens[tokenIdx].type == STAR) {
+                // consecutive stars: all but the last one match the empty sequence
+                if (starCaptureIdx >= 0 && captures != nullptr) {
+                    captures[starCaptureIdx] = {pos, 0};
+                }
+                starCaptureIdx = captureIdx++;
+                tokenIdx++;
+            }
+
+            int segmentEnd = tokenIdx;
+            while (segmentEnd < _numTokens && _tokens[segmentEnd].type != STAR) {
+                segmentEnd++;
+            }
+            int segmentLength = segmentEnd - tokenIdx;
+
+            bool isAnchoredAtBeginning = isFirstSegment && starCaptureIdx < 0;
+            bool isAnchoredAtEnd = segmentEnd == _numTokens;
+            if (isAnchoredAtBeginning || isAnchoredAtEnd) {
+                int start = isAnchoredAtEnd ? dataLength - segmentLength : pos;
+                if (start < pos || (isAnchoredAtBeginning && start != pos)
+                    || !_matchSegment(tokenIdx, segmentEnd, data + start)) {
+                    return false;
+                }
+                pos = start;
+            } else {
+                // leftmost occurrence: a later one never enables a match that the leftmost one prevents
+                const Token &first = _tokens[tokenIdx];
+                while (pos + segmentLength <= dataLength && !_matchSegment(tokenIdx, segmentEnd, data + pos)) {
+                    pos++;
+                    if (first.type == LITERAL) {
+                        while (pos + segmentLength <= dataLength && data[pos] != first.c) {
+                            pos++;
+                        }
+                    }
+                }
+                if (pos + segmentLength > dataLength) {
+                    return false;
+                }
+            }
+
+            if (captures != nullptr) {
+                if (starCaptureIdx >= 0) {
+                    captures[starCaptureIdx] = {starPos, pos - starPos};
+                }
+                for (int i = tokenIdx; i < segmentEnd; ++i) {
+                    if (_tokens[i].type == ANY) {
+                        captures[captureIdx++] = {pos + i - tokenIdx, 1};
+                    }
+                }
+            } else {
+                for (int i = tokenIdx; i < segmentEnd; ++i) {
+                    captureIdx += _tokens[i].type == ANY;
+                }
+            }
+
+            pos += segmentLength;
+            tokenIdx = segmentEnd;
+            if (tokenIdx == _numTokens) {
+                return true;
+            }
+        }
+    }
+
+    /// @brief Determines whether the contained string matches the pattern. See #matches(const char*, int,
+    /// CStringGlobCapture*).
+    bool matches(const CString &str, CStringGlobCapture *captures = nullptr) const noexcept {
+        int length = str.length();
+        return length >= 0 && matches(str.raw(), length, captures);
+    }
+
+private:
+    enum TokenType : uint8_t {
+        LITERAL, ANY, STAR, CLASS
+    };
+
+    struct Token {
+        TokenType type = LITERAL;
+        // literal character or index of the character class
+        char c = '\0';
+    };
+
+    Token _tokens[_maxTokens]{};
+    // bitmap of 256 bits per character class
+    uint32_t _classes[_maxClasses == 0 ? 1 : _maxClasses][8]{};
+    int _numTokens = 0;
+    int _numClasses = 0;
+    int _numCaptures = 0;
+    bool _invalid = false;
+
+    /// @brief Parses the character class starting at the given index (after `[`) into the given token.
+    /// @returns The index of the closing `]`.
+    constexpr int _parseClass(const char *pattern, int i, int length, Token &token) noexcept {
+        if (_numClasses == _maxClasses) {
+            _invalid = true;
+            return length;
+        }
+
+        token.type = CLASS;
+        token.c = (char)_numClasses;
+        uint32_t *bitmap = _classes[_numClasses++];
+
+        bool negate = i < length && (pattern[i] == '!' || pattern[i] == '^');
+        i += negate;
+
+        // a leading `]` is a member of the class
+        for (int first = i; i < length && (pattern[i] != ']' || i == first); ++i) {
+            uint8_t from = (uint8_t)pattern[i];
+            uint8_t to = from;
+            if (i + 2 < length && pattern[i + 1] == '-' && pattern[i + 2] != ']') {
+                to = (uint8_t)pattern[i + 2];
+                i += 2;
+            }
+            for (int c = from; c <= to; ++c) {
+                bitmap[c >> 5] |= 1u << (c & 31);
+            }
+        }
+
+        if (i >= length) {
+            _invalid = true;
+            return length;
+        }
+        if (negate) {
+            for (int word = 0; word < 8; ++word) {
+                bitmap[word] = ~bitmap[word];
+            }
+        }
+        return i;
+    }
+
+    /// @brief Determines whether the given tokens (not containing STAR) match the given data, which is known to
+    /// provide enough characters.
+    constexpr bool _matchSegment(int firstToken, int endToken, const char *data) const noexcept {
+        for (int i = firstToken; i < endToken; ++i, ++data) {
+            const Token &token = _tokens[i];
+            uint8_t c = (uint8_t)*data;
+            if ((token.type == LITERAL && token.c != *data)
+                || (token.type == CLASS && (_classes[(uint8_t)token.c][c >> 5] & (1u << (c & 31))) == 0)) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+inline bool CString::matchesGlob(const char *pattern) const noexcept {
+    // most patterns fit the default tables, larger ones are compiled again using the largest tables supported
+    CStringGlob<> glob(pattern);
+    if (!glob.isInvalid()) {
+        return matchesGlob(glob);
+    }
+    return matchesGlob(CStringGlob<UINT8_MAX, 32>(pattern));
+}
+
+template<int _maxTokens, int _maxClasses>
+bool CString::matchesGlob(const CStringGlob<_maxTokens, _maxClasses> &glob,
+                          CStringGlobCapture *captures) const noexcept {
+    return glob.matches(*this, captures);
+}
@@ -0,0 +1,175 @@
+#pragma  once
+
+#include "CString.h"
+
+/// Stores each distinct string only once using an internal CStringBuffer. Interned strings are identified by an id,
+/// which remains stable as interned strings are never removed or relocated. Thus, two interned strings are equal iff
+/// their ids are equal. Lookup uses a fixed size open addressing hash index: no heap allocations, no rehashing.
+template<int _capacity, int _maxstrings = 10>
+class CStringInternPool final {
+    static_assert(_capacity > 0 && _maxstrings > 0 && _maxstrings < UINT8_MAX);
+public:
+    constexpr CStringInternPool() noexcept : CStringInternPool(std::make_index_sequence<_slots>{}) {}
+
+    /// @brief Interns the given string. See #intern(const char*, int).
+    uint8_t intern(const char *string) noexcept {
+        if (string == nullptr) {
+            return INVALID_STRING_IDX;
+        }
+        return intern(string, strlen(string));
+    }
+
+    /// @brief Interns the given string. See #intern(const char*, int).
+    uint8_t intern(const std::string_view &string) noexcept {
+        return intern(string.data(), string.length());
+    }
+
+    /// @brief Interns the given string. See #intern(const char*, int).
+    uint8_t intern(const CString &string) noexcept {
+        std::string_view view = string.asStringView();
+        if (view.data() == nullptr) {
+            return INVALID_STRING_IDX;
+        }
+        return intern(view.data(), view.length());
+    }
+
+    /// @brief Interns the given string, that is it is added to the pool unless an equal string has been interned
+    /// before. At most limit characters are considered.
+    /// @returns The id of the interned string or INVALID_STRING_IDX if the pool's capacity is too low.
+    uint8_t intern(const char *string, int limit) noexcept {
+        if (string == nullptr || limit < 0) {
+            return INVALID_STRING_IDX;
+        }
+
+        int length = _lengthWithin(string, limit);
+        uint32_t hash = _hash(string, length);
+        int slot = _findSlot(string, length, hash);
+        if (_ids[slot] != INVALID_STRING_IDX) {
+            return _ids[slot];
+        }
+
+        if (_buffer.push(string, length).isInvalid()) {
+            return INVALID_STRING_IDX;
+        }
+
+        uint8_t id = _buffer.numstrings() - 1;
+        _hashes[slot] = hash;
+        _ids[slot] = id;
+        return id;
+    }
+
+    /// @brief Looks up the given string without interning it. See #find(const char*, int).
+    uint8_t find(const char *string) const noexcept {
+        if (string == nullptr) {
+            return INVALID_STRING_IDX;
+        }
+        return find(string, strlen(string));
+    }
+
+    /// @brief Looks up the given string without interning it. See #find(const char*, int).
+    uint8_t find(const std::string_view &string) const noexcept {
+        return find(string.data(), string.length());
+    }
+
+    /// @brief Looks up the given string without interning it. At most limit characters are considered.
+    /// @returns The id of the interned string or INVALID_STRING_IDX if the string has not been interned.
+    uint8_t find(const char *string, int limit) const noexcept {
+        if (string == nullptr || limit < 0) {
+            return INVALID_STRING_IDX;
+        }
+
+        int length = _lengthWithin(string, limit);
+        return _ids[_findSlot(string, length, _hash(string, length))];
+    }
+
+    /// @brief Retrieves the interned string with the given id. Interned strings are read-only: a modifiable CString
+    /// could be moved within the pool's buffer, changing the ids.
+    /// @returns A string_view, its data() is nullptr if the id is unknown. Remains valid as long as the pool is in
+    /// scope.
+    std::string_view getStringView(uint8_t id) const noexcept {
+        const char *string = _buffer.getRawString(id);
+        if (string == nullptr) {
+            return std::string_view();
+        }
+        // interned strings are pushed with exact capacity: length equals capacity - 1
+        return std::string_view(string, _buffer.getRawStringCapacity(id) - 1);
+    }
+
+    /// @brief Retrieves the raw interned string with the given id.
+    /// @returns A char* or nullptr if the id is unknown. Remains valid as long as the pool is in scope.
+    const char *getRawString(uint8_t id) const noexcept {
+        return _buffer.getRawString(id);
+    }
+
+    /// @brief Determines the number of distinct strings interned.
+    uint8_t numstrings() const noexcept {
+        return _buffer.numstrings();
+    }
+
+    /// @brief Determines the number of strings that can still be interned.
+    uint8_t remainingStrings() const noexcept {
+        return _buffer.remainingStrings();
+    }
+
+    /// @brief Retrieves the number of unallocated bytes.
+    int unallocatedBytes() const noexcept {
+        return _buffer.unallocatedBytes();
+    }
+
+private:
+    // load factor <= 0.5: probe sequences remain short, an empty slot always exists
+    static constexpr int _slots = [] {
+        int slots = 1;
+        while (slots < 2 * _maxstrings) {
+            slots <<= 1;
+        }
+        return slots;
+    }();
+
+    CStringBuffer<_capacity, _maxstrings> _buffer;
+    uint32_t _hashes[_slots]{};
+    uint8_t _ids[_slots];
+
+    template<std::size_t... indexes>
+    constexpr CStringInternPool(std::index_sequence<indexes...>) noexcept
+            : _ids{(static_cast<void>(indexes), INVALID_STRING_IDX)...} {}
+
+    /// @brief Finds the slot containing the given string or the empty slot terminating its probe sequence.
+    int _findSlot(const char *string, int length, uint32_t hash) const noexcept {
+        for (int slot = hash & (_slots - 1);; slot = (slot + 1) & (_slots - 1)) {
+            uint8_t id = _ids[slot];
+            if (id == INVALID_STRING_IDX) {
+                return slot;
+            }
+
+            // interned strings are pushed with exact capacity: length equals capacity - 1
+            if (_hashes[slot] == hash && _buffer.getRawStringCapacity(id) == length + 1
+                && _equals(_buffer.getRawString(id), string, length)) {
+                return slot;
+            }
+        }
+    }
+
+    // counted and compared characterwise instead of strnlen and memcmp: bounds exceeding a short argument trigger
+    // -Wstringop-overread. Comparisons are rare as the hashes are compared first.
+    static int _lengthWithin(const char *string, int maxLength) noexcept {
+        int length = 0;
+        while (length < maxLength && string[length]) {
+            length++;
+        }
+        return length;
+    }
+
+    static bool _equals(const char *interned, const char *string, int length) noexcept {
+        for (int i = 0; i < length; ++i) {
+            if (interned[i] != string[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static uint32_t _hash(const char *string, int length) noexcept {
+        return (uint32_t)CString::hash(string, length);
+    }
+};
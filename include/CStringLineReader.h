@@ -0,0 +1,172 @@
+#pragma  once
+
+#include "CString.h"
+
+#if __has_include(<unistd.h>)
+#include <errno.h>
+#include <unistd.h>
+
+/// Reads lines from a file descriptor straight into the unallocated area of a CStringBuffer: each complete line is
+/// registered as a string in place (the line feed becomes its terminating \0, a preceding carriage return is removed),
+/// such that no byte is copied. Lines are found using `memchr`, which is vectorized by common C libraries. Data read
+/// beyond the last complete line is kept in the unallocated area and carried over.
+///
+/// While reading, strings of the buffer must not be allocated, resized or moved to the top by other means; popping or
+/// removing strings is fine and reclaims their space. Then, the pending data is moved down to the beginning of the
+/// unallocated area. This is cheapest if lines are processed in batches: read lines until #readLine() fails while
+/// neither #isEof(), #isError() nor #isLineTooLong() is set (the buffer is full), process them, `removeAll()` and
+/// continue. A line exceeding the capacity of the empty buffer is reported by #isLineTooLong() and may be discarded
+/// using #skipLine().
+template<typename Buffer>
+class CStringLineReader final {
+public:
+    CStringLineReader(Buffer &buffer, int fd) noexcept : _buffer(buffer), _fd(fd), _pending(buffer.unallocatedArea()) {}
+
+    /// @brief Registers the next line as string of the buffer, reading more data if necessary.
+    /// @returns The line or an invalid CString if the end of input has been reached (see #isEof()), reading failed
+    /// (see #isError()), the line does not fit into the empty buffer (see #isLineTooLong()) or the buffer is full (no
+    /// further string or not enough capacity for the next line).
+    CString readLine() noexcept {
+        _lineTooLong = false;
+        while (true) {
+            char *area = _buffer.unallocatedArea();
+            if (area != _pending) {
+                memmove(area, _pending, _pendingLength);
+                _pending = area;
+            }
+
+            char *lineFeed = (char *)memchr(area + _scanned, '\n', _pendingLength - _scanned);
+            if (lineFeed != nullptr) {
+                return _pushLine(lineFeed - area, 1);
+            }
+            _scanned = _pendingLength;
+
+            if (_eof) {
+                // last line without line feed
+                return _pendingLength == 0 ? CString::INVALID : _pushLine(_pendingLength, 0);
+            }
+
+            // keep one byte for the terminating \0
+            int space = _buffer.unallocatedBytes() - _pendingLength - 1;
+            if (space <= 0 || _error) {
+                // removing strings cannot make room for the line
+                _lineTooLong = space <= 0 && _buffer.numstrings() == 0;
+                return CString::INVALID;
+            }
+
+            // don't read much more than the remaining strings can take: pending data is moved when space is reclaimed
+            if (_lines > 0) {
+                int64_t expected = (_buffer.remainingStrings() + 1) * (_lineBytes / _lines + 1);
+                space = (int)std::min((int64_t)space, std::max(expected, (int64_t)minReadSize));
+            }
+
+            ssize_t count = read(_fd, area + _pendingLength, space);
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+            if (count < 0) {
+                _error = true;
+                return CString::INVALID;
+            }
+            _eof = count == 0;
+            _pendingLength += count;
+        }
+    }
+
+    /// @brief Determines whether all lines have been read.
+    bool isEof() const noexcept {
+        return _eof && _pendingLength == 0;
+    }
+
+    /// @brief Determines whether reading from the file descriptor failed (see errno).
+    bool isError() const noexcept {
+        return _error;
+    }
+
+    /// @brief Determines whether the last call to #readLine() failed as the line does not fit into the buffer, even
+    /// if all strings are removed. The line remains pending: it needs to be discarded using #skipLine().
+    bool isLineTooLong() const noexcept {
+        return _lineTooLong;
+    }
+
+    /// @brief Discards the pending data up to and including the next line feed, reading more data as necessary, e.g.
+    /// to skip a line that is too long (see #isLineTooLong()).
+    /// @returns `true` if a line has been discarded, `false` if reading failed (see #isError()) or the buffer is full.
+    bool skipLine() noexcept {
+        _lineTooLong = false;
+        while (true) {
+            char *lineFeed = (char *)memchr(_pending, '\n', _pendingLength);
+            if (lineFeed != nullptr) {
+                int consumed = lineFeed - _pending + 1;
+                _pending += consumed;
+                _pendingLength -= consumed;
+                _scanned = 0;
+                return true;
+            }
+
+            // discard all pending data, read into the whole unallocated area
+            _pending = _buffer.unallocatedArea();
+            _pendingLength = 0;
+            _scanned = 0;
+            int space = _buffer.unallocatedBytes() - 1;
+            if (_eof) {
+                return true;
+            }
+            if (space <= 0 || _error) {
+                return false;
+            }
+
+            ssize_t count = read(_fd, _pending, space);
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+            if (count < 0) {
+                _error = true;
+                return false;
+            }
+            _eof = count == 0;
+            _pendingLength = count;
+        }
+    }
+
+    /// @brief Retrieves the number of bytes read, but not yet registered as line.
+    int pendingBytes() const noexcept {
+        return _pendingLength;
+    }
+
+private:
+    static constexpr int minReadSize = 16384;
+
+    Buffer &_buffer;
+    int _fd;
+    char *_pending;
+    int _pendingLength = 0;
+    // number of pending bytes known not to contain a line feed
+    int _scanned = 0;
+    bool _eof = false;
+    bool _error = false;
+    bool _lineTooLong = false;
+    // statistics used to estimate the amount of data to read
+    int64_t _lineBytes = 0;
+    int64_t _lines = 0;
+
+    CString _pushLine(int length, int lineFeedLength) noexcept {
+        // the line feed (if any) is overwritten by the terminating \0
+        CString line = _buffer.pushUnallocated(length);
+        if (line.isInvalid()) {
+            return CString::INVALID;
+        }
+        if (length > 0 && _pending[length - 1] == '\r') {
+            _pending[length - 1] = '\0';
+        }
+
+        int consumed = length + lineFeedLength;
+        _pending += consumed;
+        _pendingLength -= consumed;
+        _scanned = 0;
+        _lineBytes += consumed;
+        _lines++;
+        return line;
+    }
+};
+#endif
@@ -0,0 +1,173 @@
+#pragma  once
+
+#include "CString.h"
+
+/// Fixed capacity hash map from string keys to string values without heap allocations. Keys and values are allocated
+/// using the given CStringBuffer, while the index is a statically sized robin hood hash table caching the key hashes.
+/// Entries refer to keys and values by CString (handle), thus they remain valid if the buffer relocates its content,
+/// e.g. due to `moveToTop` or values being appended to. Keys must not be modified.
+template<typename Buffer, int _slots = 16>
+class CStringMap final {
+    static_assert(_slots > 0 && _slots <= 128 && (_slots & (_slots - 1)) == 0, "_slots must be a power of two <= 128");
+public:
+    explicit CStringMap(Buffer &buffer) noexcept : _buffer(buffer) {}
+
+    /// @brief Inserts the given key / value pair. The value of an existing entry is replaced.
+    /// @returns The value's CString or an invalid CString if the map is full or the buffer's capacity is too low. In
+    /// the latter case, the map remains unchanged.
+    CString insert(const std::string_view &key, const std::string_view &value) noexcept {
+        uint32_t hash = _hash(key.data(), key.length());
+        int slot = _findSlot(key, hash);
+        if (slot >= 0) {
+            // push new value before removing the old one: the given value might refer to the old one
+            CString newValue = _buffer.push(value.data(), value.length());
+            if (newValue.isInvalid()) {
+                return CString::INVALID;
+            }
+            _values[slot].deallocate();
+            _values[slot] = newValue;
+            return newValue;
+        }
+
+        if (_size == _slots) {
+            return CString::INVALID;
+        }
+
+        CString newKey = _buffer.push(key.data(), key.length());
+        if (newKey.isInvalid()) {
+            return CString::INVALID;
+        }
+        CString newValue = _buffer.push(value.data(), value.length());
+        if (newValue.isInvalid()) {
+            newKey.deallocate();
+            return CString::INVALID;
+        }
+
+        _insertEntry(hash, newKey, newValue);
+        return newValue;
+    }
+
+    /// @brief Looks up the value associated with the given key.
+    /// @returns The value's CString or an invalid CString if the key was not found.
+    CString find(const std::string_view &key) const noexcept {
+        int slot = _findSlot(key, _hash(key.data(), key.length()));
+        return slot < 0 ? CString::INVALID : _values[slot];
+    }
+
+    /// @brief Determines whether an entry with the given key exists.
+    bool contains(const std::string_view &key) const noexcept {
+        return _findSlot(key, _hash(key.data(), key.length())) >= 0;
+    }
+
+    /// @brief Removes the entry with the given key and deallocates its key and value from the buffer.
+    /// @returns `true` if the entry was found, `false` otherwise.
+    bool erase(const std::string_view &key) noexcept {
+        int slot = _findSlot(key, _hash(key.data(), key.length()));
+        if (slot < 0) {
+            return false;
+        }
+
+        _values[slot].deallocate();
+        _keys[slot].deallocate();
+
+        // backward shift deletion: no tombstones needed
+        for (int next = (slot + 1) & (_slots - 1); _dist[next] > 1; slot = next, next = (next + 1) & (_slots - 1)) {
+            _dist[slot] = _dist[next] - 1;
+            _hashes[slot] = _hashes[next];
+            _keys[slot] = _keys[next];
+            _values[slot] = _values[next];
+        }
+        _dist[slot] = 0;
+        _size--;
+
+        return true;
+    }
+
+    /// @brief Removes all entries and deallocates their keys and values from the buffer.
+    void clear() noexcept {
+        for (int slot = 0; slot < _slots; ++slot) {
+            if (_dist[slot] != 0) {
+                _values[slot].deallocate();
+                _keys[slot].deallocate();
+                _dist[slot] = 0;
+            }
+        }
+        _size = 0;
+    }
+
+    /// @brief Invokes the given function for each entry. The order is unspecified. The map must not be modified by
+    /// the given function.
+    void forEach(std::function<void(const CString &key, CString &value)> fn) noexcept {
+        for (int slot = 0; slot < _slots; ++slot) {
+            if (_dist[slot] != 0) {
+                fn(_keys[slot], _values[slot]);
+            }
+        }
+    }
+
+    /// @brief Determines the number of entries.
+    int size() const noexcept {
+        return _size;
+    }
+
+    /// @brief Determines the maximum number of entries.
+    constexpr int capacity() const noexcept {
+        return _slots;
+    }
+
+private:
+    Buffer &_buffer;
+    int _size = 0;
+
+    // probe distance + 1 of the entry within the slot, 0 if empty
+    uint8_t _dist[_slots]{};
+    uint32_t _hashes[_slots]{};
+    CString _keys[_slots];
+    CString _values[_slots];
+
+    /// @brief Finds the slot of the entry with the given key.
+    /// @returns The slot or -1 if not found.
+    int _findSlot(const std::string_view &key, uint32_t hash) const noexcept {
+        int slot = hash & (_slots - 1);
+        for (int dist = 1; dist <= _slots; ++dist, slot = (slot + 1) & (_slots - 1)) {
+            // robin hood invariant: the key would have been placed here if it existed
+            if (_dist[slot] < dist) {
+                return -1;
+            }
+
+            if (_hashes[slot] == hash && _keys[slot].rawCapacity() == (int)key.length() + 1
+                && memcmp(_keys[slot].raw(), key.data(), key.length()) == 0) {
+                return slot;
+            }
+        }
+        return -1;
+    }
+
+    void _insertEntry(uint32_t hash, CString key, CString value) noexcept {
+        int slot = hash & (_slots - 1);
+        uint8_t dist = 1;
+        for (;; slot = (slot + 1) & (_slots - 1), ++dist) {
+            if (_dist[slot] == 0) {
+                break;
+            }
+
+            // robin hood: take the slot from entries that are closer to their home slot
+            if (_dist[slot] < dist) {
+                std::swap(dist, _dist[slot]);
+                std::swap(hash, _hashes[slot]);
+                std::swap(key, _keys[slot]);
+                std::swap(value, _values[slot]);
+            }
+        }
+
+        _dist[slot] = dist;
+        _hashes[slot] = hash;
+        _keys[slot] = key;
+        _values[slot] = value;
+        _size++;
+    }
+
+    static uint32_t _hash(const char *string, int length) noexcept {
+        return (uint32_t)CString::hash(string, length);
+    }
+};
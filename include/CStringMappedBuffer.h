@@ -0,0 +1,174 @@
+#pragma  once
+
+#include "CStringBufferView.h"
+
+#if __has_include(<sys/mman.h>)
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CSTRING_HAS_MMAP
+
+/// CStringBuffer whose content survives restarts: string data, string table and handles are stored in a memory mapped
+/// file. The file starts with a versioned header, followed by the metadata of a CStringBufferView - string offsets
+/// relative to the data area, thus independent of the address the file is mapped to, and the handle map - and the
+/// string data. Opening an existing file
+/// checks the header and the string table, but does not read or copy the string data: pages are loaded on first
+/// access. Thus, opening takes constant time independent of the file size.
+///
+/// Strings are allocated, appended to and removed with the same semantics as CStringBuffer. Changes are written back
+/// by the OS eventually, also if the process crashes. Use #sync() to persist them at a given point, e.g. to survive
+/// a crash of the OS. The file uses the native byte order and layout; other platforms reject it as incompatible.
+/// Like CStringBuffer, a buffer holds at most 254 strings (see CStringHandle). A closed buffer behaves like a buffer
+/// without capacity.
+class CStringMappedBuffer final : public CStringBufferView {
+public:
+    /// @brief Version of the file format. Files of other versions are rejected.
+    static constexpr uint32_t formatVersion = 3;
+
+    CStringMappedBuffer() noexcept = default;
+    CStringMappedBuffer(const CStringMappedBuffer &) = delete;
+    CStringMappedBuffer &operator=(const CStringMappedBuffer &) = delete;
+
+    ~CStringMappedBuffer() noexcept {
+        close();
+    }
+
+    /// @brief Creates the given file, or truncates it if it exists, and maps it. The file's size is the given capacity
+    /// plus a few bytes for the header and string table. A buffer that was open before is closed first.
+    /// @returns `true` if the file was created, `false` otherwise (see errno).
+    bool create(const char *path, int capacity, uint8_t maxstrings = INVALID_STRING_IDX - 1) noexcept {
+        close();
+        if (capacity <= 0 || maxstrings == 0 || maxstrings == INVALID_STRING_IDX) {
+            errno = EINVAL;
+            return false;
+        }
+
+        int fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            return false;
+        }
+        size_t dataOffset = _dataOffset(maxstrings);
+        bool mapped = ftruncate(fd, dataOffset + capacity) == 0 && _map(fd, dataOffset + capacity);
+        _closeKeepingErrno(fd);
+        if (!mapped) {
+            return false;
+        }
+
+        Header *header = (Header *)_mapping;
+        header->version = formatVersion;
+        header->dataOffset = dataOffset;
+        CStringBufferView::create(_mapping + dataOffset, capacity, _mapping + sizeof(Header),
+                                  dataOffset - sizeof(Header), maxstrings);
+        memcpy(header->magic, _magic, sizeof(_magic));
+        return true;
+    }
+
+    /// @brief Maps the given file, which must have been created by #create(). A buffer that was open before is closed
+    /// first.
+    /// @returns `true` if the file was opened, `false` otherwise, e.g. if it is no compatible buffer file (errno is
+    /// EINVAL then).
+    bool open(const char *path) noexcept {
+        close();
+
+        int fd = ::open(path, O_RDWR | O_CLOEXEC);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat stat;
+        if (fstat(fd, &stat) != 0) {
+            _closeKeepingErrno(fd);
+            return false;
+        }
+        // the header must be mapped from the file: accessing mapped pages beyond the file's end raises SIGBUS
+        bool mapped = (size_t)stat.st_size >= sizeof(Header) && _map(fd, stat.st_size);
+        _closeKeepingErrno(fd);
+        if (!mapped) {
+            errno = (size_t)stat.st_size < sizeof(Header) ? EINVAL : errno;
+            return false;
+        }
+
+        const Header *header = (const Header *)_mapping;
+        if (memcmp(header->magic, _magic, sizeof(_magic)) != 0 || header->version != formatVersion
+            || header->dataOffset < sizeof(Header) || header->dataOffset >= _mappingSize
+            || _mappingSize - header->dataOffset > INT_MAX
+            || !attach(_mapping + header->dataOffset, _mappingSize - header->dataOffset, _mapping + sizeof(Header),
+                       header->dataOffset - sizeof(Header))) {
+            munmap(_mapping, _mappingSize);
+            _mapping = nullptr;
+            _mappingSize = 0;
+            errno = EINVAL;
+            return false;
+        }
+        return true;
+    }
+
+    /// @brief Writes changes back to the file. CStrings remain valid.
+    /// @param wait `true` to wait until the data has been written, `false` to schedule writing only.
+    /// @returns `true` on success, `false` otherwise (see errno).
+    bool sync(bool wait = true) noexcept {
+        if (_mapping == nullptr) {
+            errno = EBADF;
+            return false;
+        }
+        return msync(_mapping, _mappingSize, wait ? MS_SYNC : MS_ASYNC) == 0;
+    }
+
+    /// @brief Unmaps the file. Changes are written back by the OS eventually, use #sync() before to wait for them
+    /// being written. CStrings allocated using this buffer become invalid.
+    void close() noexcept {
+        if (_mapping == nullptr) {
+            return;
+        }
+
+        detach();
+        munmap(_mapping, _mappingSize);
+        _mapping = nullptr;
+        _mappingSize = 0;
+    }
+
+    /// @brief Determines whether a file is mapped.
+    bool isOpen() const noexcept {
+        return _mapping != nullptr;
+    }
+
+private:
+    using CStringBufferView::attach;
+    using CStringBufferView::detach;
+
+    // file layout: Header, CStringBufferView metadata, data
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t dataOffset;
+    };
+
+    static constexpr char _magic[8] = {'C', 'S', 'T', 'R', 'B', 'U', 'F', '\0'};
+
+    char *_mapping = nullptr;
+    size_t _mappingSize = 0;
+
+    /// @brief Offset of the data area: cache line aligned.
+    static constexpr size_t _dataOffset(uint8_t maxstrings) noexcept {
+        return (sizeof(Header) + metadataSize(maxstrings) + 63) & ~(size_t)63;
+    }
+
+    static void _closeKeepingErrno(int fd) noexcept {
+        int error = errno;
+        ::close(fd);
+        errno = error;
+    }
+
+    bool _map(int fd, size_t size) noexcept {
+        void *mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (mapping == MAP_FAILED) {
+            return false;
+        }
+        _mapping = (char *)mapping;
+        _mappingSize = size;
+        return true;
+    }
+};
+
+#endif
@@ -0,0 +1,253 @@
+#pragma  once
+
+#include <initializer_list>
+#include "CString.h"
+
+/// A match reported by CStringMatcher.
+struct CStringMatch {
+    /// @brief Id of the matching pattern, that is the order in which distinct patterns have been added (starting at 0).
+    int patternId;
+
+    /// @brief Index of the first character of the match.
+    int index;
+
+    /// @brief Length of the matching pattern.
+    int length;
+};
+
+/// Multi-pattern matcher (Aho-Corasick) finding any of up to hundreds of patterns in a single pass over the input,
+/// independent of the number of patterns. The automaton is a dense DFA stored in fixed size tables: at most _maxStates
+/// states (sum of pattern lengths + 1 is an upper bound) and at most _maxClasses - 1 distinct characters used by all
+/// patterns. No heap allocations are involved and the matcher can be built at compile time:
+/// `constexpr CStringMatcher<64, 16> matcher{"error", "warn"};`
+template<int _maxStates = 256, int _maxClasses = 32>
+class CStringMatcher final {
+    static_assert(_maxStates > 1 && _maxStates < UINT16_MAX && _maxClasses > 1 && _maxClasses <= 256);
+public:
+    /// Iterates all matches within the given input in the order of their end index. Overlapping matches are reported.
+    /// The input is referred to by pointer and must not be modified or relocated during iteration.
+    class Iterator final {
+        friend class CStringMatcher;
+    public:
+        /// @brief Retrieves the next match.
+        /// @returns `true` if a match was found, `false` if the end of the input has been reached.
+        constexpr bool next(CStringMatch &match) noexcept {
+            if (_pending == 0) {
+                while (_index < _length && _data[_index] != '\0') {
+                    _state = _matcher._next[_state][_matcher._classOf[(uint8_t)_data[_index++]]];
+                    _pending = _matcher._output[_state] != 0 ? _state : _matcher._dictLink[_state];
+                    if (_pending != 0) {
+                        break;
+                    }
+                }
+                if (_pending == 0) {
+                    return false;
+                }
+            }
+
+            match.patternId = _matcher._output[_pending] - 1;
+            match.length = _matcher._depth[_pending];
+            match.index = _index - match.length;
+            _pending = _matcher._dictLink[_pending];
+            return true;
+        }
+
+    private:
+        const CStringMatcher &_matcher;
+        const char *_data;
+        int _length;
+        int _index;
+        uint16_t _state = 0;
+        uint16_t _pending = 0;
+
+        constexpr Iterator(const CStringMatcher &matcher, const char *data, int length, int startIndex) noexcept
+                : _matcher(matcher), _data(data), _length(length), _index(startIndex) {}
+    };
+
+    constexpr CStringMatcher() noexcept = default;
+
+    /// @brief Creates a matcher for the given patterns. See #isInvalid().
+    constexpr CStringMatcher(std::initializer_list<const char *> patterns) noexcept {
+        for (const char *pattern : patterns) {
+            addPattern(pattern);
+        }
+        build();
+    }
+
+    /// @brief Adds a pattern. Patterns must be added prior to #build().
+    /// @returns The pattern id or -1 if the capacity of this matcher is too low or the pattern is empty.
+    constexpr int addPattern(const char *pattern) noexcept {
+        return addPattern(pattern, pattern == nullptr ? 0 : (int)std::char_traits<char>::length(pattern));
+    }
+
+    /// @brief Adds a pattern. Patterns must be added prior to #build().
+    /// @returns The pattern id or -1 if the capacity of this matcher is too low or the pattern is empty. Adding a
+    /// pattern again returns the id assigned before.
+    constexpr int addPattern(const char *pattern, int length) noexcept {
+        if (_built || _invalid || length <= 0) {
+            _invalid = true;
+            return -1;
+        }
+
+        uint16_t state = 0;
+        for (int i = 0; i < length; ++i) {
+            uint8_t c = (uint8_t)pattern[i];
+            if (_classOf[c] == 0) {
+                if (_numClasses == _maxClasses || c == '\0') {
+                    _invalid = true;
+                    return -1;
+                }
+                _classOf[c] = _numClasses++;
+            }
+
+            uint16_t &next = _next[state][_classOf[c]];
+            if (next == 0) {
+                if (_numStates == _maxStates) {
+                    _invalid = true;
+                    return -1;
+                }
+                next = _numStates++;
+                _depth[next] = i + 1;
+            }
+            state = next;
+        }
+
+        // a duplicate is the same pattern: matches report the id of the first occurrence only
+        if (_output[state] != 0) {
+            return _output[state] - 1;
+        }
+        _output[state] = _numPatterns + 1;
+        _maxLength = std::max(_maxLength, length);
+        return _numPatterns++;
+    }
+
+    /// @brief Computes the automaton after all patterns have been added.
+    constexpr void build() noexcept {
+        if (_built || _invalid) {
+            return;
+        }
+
+        uint16_t fail[_maxStates]{};
+        uint16_t queue[_maxStates]{};
+        int head = 0;
+        int tail = 0;
+
+        for (int cls = 0; cls < _numClasses; ++cls) {
+            if (_next[0][cls] != 0) {
+                queue[tail++] = _next[0][cls];
+            }
+        }
+
+        // breadth first: fail links of shallower states are complete when needed
+        while (head < tail) {
+            uint16_t state = queue[head++];
+            uint16_t failState = fail[state];
+            _dictLink[state] = _output[failState] != 0 ? failState : _dictLink[failState];
+
+            for (int cls = 0; cls < _numClasses; ++cls) {
+                uint16_t &next = _next[state][cls];
+                if (next == 0) {
+                    next = _next[failState][cls];
+                } else {
+                    fail[next] = _next[failState][cls];
+                    queue[tail++] = next;
+                }
+            }
+        }
+
+        _built = true;
+    }
+
+    /// @brief Determines whether adding a pattern failed, e.g. due to insufficient capacity.
+    constexpr bool isInvalid() const noexcept {
+        return _invalid;
+    }
+
+    /// @brief Retrieves the number of distinct patterns added.
+    constexpr int numPatterns() const noexcept {
+        return _numPatterns;
+    }
+
+    /// @brief Retrieves the number of states of the automaton.
+    constexpr int numStates() const noexcept {
+        return _numStates;
+    }
+
+    /// @brief Finds the match with the lowest index (the longest one if several matches start there). Search stops at
+    /// the first \0 character or after length characters.
+    /// @returns `true` if a match was found, `false` otherwise.
+    constexpr bool find(const char *data, int length, CStringMatch &match) const noexcept {
+        if (!_built || data == nullptr) {
+            return false;
+        }
+
+        bool found = false;
+        uint16_t state = 0;
+        for (int i = 0; i < length && data[i] != '\0'; ++i) {
+            // no match ending at or after this index can start before the match found so far
+            if (found && i - _maxLength + 1 > match.index) {
+                break;
+            }
+
+            state = _next[state][_classOf[(uint8_t)data[i]]];
+
+            // the state itself is the longest match ending here, suffix matches are shorter
+            uint16_t longest = _output[state] != 0 ? state : _dictLink[state];
+            if (longest != 0 && (!found || i + 1 - _depth[longest] <= match.index)) {
+                found = true;
+                match.patternId = _output[longest] - 1;
+                match.length = _depth[longest];
+                match.index = i + 1 - match.length;
+            }
+        }
+
+        return found;
+    }
+
+    /// @brief Iterates all matches within the given string. See Iterator.
+    constexpr Iterator findAll(const char *data, int length) const noexcept {
+        return Iterator(*this, data, _built && data != nullptr ? length : 0, 0);
+    }
+
+    /// @brief Iterates all matches within the contained string. See Iterator.
+    Iterator findAll(const CString &str) const noexcept {
+        return findAll(str.raw(), str.rawCapacity());
+    }
+
+private:
+    uint8_t _classOf[256]{};
+    uint16_t _next[_maxStates][_maxClasses]{};
+    // pattern id + 1 of the pattern ending in the state, 0 if none
+    uint16_t _output[_maxStates]{};
+    // next state on the fail link chain having an output, 0 if none
+    uint16_t _dictLink[_maxStates]{};
+    uint16_t _depth[_maxStates]{};
+
+    int _numClasses = 1;
+    uint16_t _numStates = 1;
+    int _numPatterns = 0;
+    int _maxLength = 0;
+    bool _built = false;
+    bool _invalid = false;
+};
+
+template<int _maxStates, int _maxClasses>
+int CString::indexOfAnyPattern(const CStringMatcher<_maxStates, _maxClasses> &matcher, int startIndex) const noexcept {
+    CStringMatch match{};
+    return indexOfAnyPattern(matcher, startIndex, match);
+}
+
+template<int _maxStates, int _maxClasses>
+int CString::indexOfAnyPattern(const CStringMatcher<_maxStates, _maxClasses> &matcher, int startIndex,
+                               CStringMatch &match) const noexcept {
+    int capacity = rawCapacity();
+    if (startIndex < 0 || startIndex >= capacity) {
+        return -1;
+    }
+
+    if (!matcher.find(raw() + startIndex, capacity - startIndex, match)) {
+        return -1;
+    }
+    match.index += startIndex;
+    return match.index;
+}
@@ -0,0 +1,373 @@
+#pragma  once
+
+#include "CString.h"
+
+/// Large string composed of an ordered list of CString segments, possibly located in several buffers, e.g. a response
+/// of several megabytes built by many appends. Appending extends the last segment if it is the topmost string of its
+/// buffer, or pushes a new segment otherwise, continuing in the next buffer once a buffer is exhausted. Earlier
+/// segments are never moved. Segments are exported without copying, by iteration or by `writev` (see #writeTo());
+/// #flatten() copies them into a single CString only if that is needed.
+///
+/// The last segment is extended by the buffer's appendToTopmost(), which may relocate it: a CStringSegmentedBuffer
+/// moves it into a new chunk if its chunk is full. Thus, pointers obtained by `raw()` or #toIovec() are invalidated by
+/// appending, the segments themselves remain valid.
+///
+/// The rope owns its segments: they must not be modified or removed except through the rope. Buffers are registered
+/// by #addBuffer() and must outlive the rope's segments.
+template<int _maxSegments = 64, int _maxBuffers = 4>
+class CStringRope final {
+    static_assert(_maxSegments > 0 && _maxBuffers > 0);
+public:
+    CStringRope() noexcept = default;
+    CStringRope(const CStringRope &) = delete;
+    CStringRope &operator=(const CStringRope &) = delete;
+
+    /// @brief Registers a buffer new segments are pushed to. Buffers are used in order of registration.
+    /// @returns `true` if the buffer was registered, `false` if the maximum number of buffers is reached.
+    template<typename Buffer>
+    bool addBuffer(Buffer &buffer) noexcept {
+        if (_numBuffers == _maxBuffers) {
+            return false;
+        }
+        _buffers[_numBuffers++] = {
+            &buffer,
+            [](void *b, const char *string, int limit) { return ((Buffer *)b)->push(string, limit); },
+            [](void *b, int maxLength) { return ((Buffer *)b)->allocate(maxLength); },
+            [](void *b) { return ((Buffer *)b)->unallocatedBytes(); }
+        };
+        return true;
+    }
+
+    /// @brief Appends the given string. See #append(const char*, int).
+    bool append(const char *string) noexcept {
+        return string != nullptr && append(string, strlen(string));
+    }
+
+    /// @brief Appends the given string, but at most limit characters. Earlier segments are never moved, the last one
+    /// might be relocated by its buffer.
+    /// @returns `true` on success, `false` if the buffers or the maximum number of segments are exhausted. In the
+    /// latter case, the part of the string that fitted is appended.
+    bool append(const char *string, int limit) noexcept {
+        if (string == nullptr || limit < 0) {
+            return false;
+        }
+
+        // counted instead of strnlen: a bound exceeding a short argument triggers -Wstringop-overread
+        int remaining = 0;
+        while (remaining < limit && string[remaining]) {
+            remaining++;
+        }
+        for (; remaining > 0 && _curBuffer < _numBuffers; ++_curBuffer) {
+            int appended = _appendToBuffer(_buffers[_curBuffer], string, remaining);
+            string += appended;
+            remaining -= appended;
+            if (remaining == 0) {
+                return true;
+            }
+            if (_numSegments == _maxSegments) {
+                return false;
+            }
+        }
+        return remaining == 0;
+    }
+
+    /// @brief Appends the given CString as a segment without copying it. The rope takes over ownership.
+    /// @returns `true` on success, `false` if the CString is unallocated or the maximum number of segments is reached.
+    bool appendSegment(const CString &segment) noexcept {
+        if (!segment.isAllocated() || _numSegments == _maxSegments) {
+            return false;
+        }
+        _segments[_numSegments] = segment;
+        _lengths[_numSegments++] = segment.length();
+        _length += _lengths[_numSegments - 1];
+        return true;
+    }
+
+    /// @brief Removes all segments from their buffers.
+    void clear() noexcept {
+        for (int i = _numSegments - 1; i >= 0; --i) {
+            _segments[i]._buf->remove(_segments[i]);
+        }
+        _numSegments = 0;
+        _length = 0;
+        _curBuffer = 0;
+    }
+
+    /// @brief Determines the total length of all segments.
+    int length() const noexcept {
+        return _length;
+    }
+
+    /// @brief Determines the number of segments.
+    int numSegments() const noexcept {
+        return _numSegments;
+    }
+
+    /// @brief Determines the segment with the given index or an invalid CString if the index is out of range.
+    const CString &segment(int index) const noexcept {
+        return index >= 0 && index < _numSegments ? _segments[index] : CString::INVALID;
+    }
+
+    /// @brief Iterates the segments in order.
+    const CString *begin() const noexcept {
+        return _segments;
+    }
+
+    const CString *end() const noexcept {
+        return _segments + _numSegments;
+    }
+
+    /// @brief Determines the character at the given index or '\0' if the index is out of range.
+    char charAt(int index) const noexcept {
+        if (index < 0) {
+            return '\0';
+        }
+        for (int i = 0; i < _numSegments; index -= _lengths[i++]) {
+            if (index < _lengths[i]) {
+                return _segments[i].raw()[index];
+            }
+        }
+        return '\0';
+    }
+
+    /// @brief Reports the index of the first occurrence of the given character or -1 if not found. Search starts at the
+    /// given startIndex.
+    int indexOf(const char c, int startIndex = 0) const noexcept {
+        return indexOf(&c, startIndex, 1);
+    }
+
+    /// @brief Reports the index of the first occurrence of the given string or -1 if not found. Search starts at the
+    /// given startIndex. Occurrences spanning several segments are found as well.
+    int indexOf(const char *str, int startIndex = 0) const noexcept {
+        return str == nullptr ? -1 : indexOf(str, startIndex, strlen(str));
+    }
+
+    /// @brief Reports the index of the first occurrence of the given string or -1 if not found. Search starts at the
+    /// given startIndex. Occurrences spanning several segments are found as well.
+    int indexOf(const char *str, int startIndex, int strLenExcludingNull) const noexcept {
+        if (str == nullptr || startIndex < 0 || startIndex > _length || strLenExcludingNull < 0) {
+            return -1;
+        }
+        if (strLenExcludingNull == 0) {
+            return startIndex;
+        }
+
+        std::string_view needle(str, strLenExcludingNull);
+        int base = 0;
+        for (int i = 0; i < _numSegments; base += _lengths[i++]) {
+            int length = _lengths[i];
+            int from = std::max(startIndex - base, 0);
+            if (from >= length) {
+                continue;
+            }
+
+            // occurrences within the segment precede those starting in the segment and ending in later ones
+            std::string_view segment(_segments[i].raw(), length);
+            size_t found = segment.find(needle, from);
+            if (found != std::string_view::npos) {
+                return base + (int)found;
+            }
+            for (int offset = std::max(from, length - strLenExcludingNull + 1); offset < length; ++offset) {
+                if (_matchesAt(i, offset, str, strLenExcludingNull)) {
+                    return base + offset;
+                }
+            }
+        }
+        return -1;
+    }
+
+    /// @brief Determines whether the rope starts with the given string.
+    bool startsWith(const char *str) const noexcept {
+        return str != nullptr && startsWith(str, strlen(str));
+    }
+
+    /// @brief Determines whether the rope starts with the given string.
+    bool startsWith(const char *str, int strLengthExcludingNull) const noexcept {
+        if (str == nullptr || strLengthExcludingNull < 0 || strLengthExcludingNull > _length) {
+            return false;
+        }
+        return strLengthExcludingNull == 0 || _matchesAt(0, 0, str, strLengthExcludingNull);
+    }
+
+    /// @brief Determines whether the rope ends with the given string.
+    bool endsWith(const char *str) const noexcept {
+        if (str == nullptr) {
+            return false;
+        }
+        int length = strlen(str);
+        if (length > _length) {
+            return false;
+        }
+
+        int index = _length - length;
+        int segment = 0;
+        for (; segment < _numSegments && index >= _lengths[segment]; index -= _lengths[segment++]) {
+        }
+        return length == 0 || _matchesAt(segment, index, str, length);
+    }
+
+    /// @brief Copies all segments into a single CString, allocated in the first registered buffer providing enough
+    /// space, and replaces the segments by it. Does not copy anything if the rope consists of a single segment.
+    /// @returns The flattened CString or an invalid CString if there is no buffer providing enough space. The rope is
+    /// left unchanged in the latter case.
+    CString flatten() noexcept {
+        if (_numSegments == 1) {
+            return _segments[0];
+        }
+
+        CString flat = CString::INVALID;
+        for (int i = 0; i < _numBuffers && !flat.isAllocated(); ++i) {
+            flat = _buffers[i].allocate(_buffers[i].buffer, _length);
+        }
+        if (!flat.isAllocated()) {
+            return CString::INVALID;
+        }
+
+        // segments are not moved by allocating: flat is the topmost string of its buffer
+        char *dst = flat.raw();
+        for (int i = 0; i < _numSegments; ++i) {
+            memcpy(dst, _segments[i].raw(), _lengths[i]);
+            dst += _lengths[i];
+        }
+        *dst = '\0';
+
+        clear();
+        appendSegment(flat);
+        return flat;
+    }
+
+#ifdef CSTRING_HAS_WRITEV
+    /// @brief Fills the given iovecs with the segments in order, e.g. for `writev`. Empty segments are skipped.
+    /// @returns The number of iovecs filled or -1 if maxIov is too small.
+    int toIovec(iovec *iov, int maxIov) const noexcept {
+        int numIov = 0;
+        for (int i = 0; i < _numSegments; ++i) {
+            if (_lengths[i] == 0) {
+                continue;
+            }
+            if (numIov == maxIov) {
+                return -1;
+            }
+            iov[numIov++] = {_segments[i].raw(), (size_t)_lengths[i]};
+        }
+        return numIov;
+    }
+
+    /// @brief Writes all segments to the given file descriptor by a single `writev` call, which is repeated only if the
+    /// kernel accepts a part of the data, only. Only available if the platform provides `writev`.
+    /// @returns The number of bytes written or -1 if writing failed (see errno). In the latter case, a part of the data
+    /// might have been written.
+    ssize_t writeTo(int fd) const noexcept {
+        iovec iov[_maxSegments];
+        int numIov = toIovec(iov, _maxSegments);
+
+        ssize_t total = 0;
+        for (iovec *cur = iov, *end = iov + numIov; cur < end;) {
+            ssize_t written = writev(fd, cur, end - cur);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return -1;
+            }
+            total += written;
+
+            // partial write: skip iovecs written completely, adjust the first one written partially
+            for (; cur < end && (size_t)written >= cur->iov_len; ++cur) {
+                written -= cur->iov_len;
+            }
+            if (cur < end) {
+                cur->iov_base = (char *)cur->iov_base + written;
+                cur->iov_len -= written;
+            }
+        }
+        return total;
+    }
+#endif
+
+private:
+    struct _Buffer {
+        void *buffer;
+        CString (*push)(void *buffer, const char *string, int limit);
+        CString (*allocate)(void *buffer, int maxLength);
+        int (*unallocatedBytes)(void *buffer);
+    };
+
+    CString _segments[_maxSegments];
+    int _lengths[_maxSegments]{};
+    int _numSegments = 0;
+    int _length = 0;
+
+    _Buffer _buffers[_maxBuffers]{};
+    int _numBuffers = 0;
+    int _curBuffer = 0;
+
+    /// @brief Appends as much of the given string as fits into the buffer: to the last segment as long as it is the
+    /// topmost string of its buffer, to new segments otherwise.
+    /// @returns The number of characters appended.
+    int _appendToBuffer(const _Buffer &buffer, const char *string, int length) noexcept {
+        int appended = 0;
+        while (appended < length) {
+            int n = _appendToLastSegment(string + appended, length - appended);
+            if (n == 0) {
+                n = _pushSegment(buffer, string + appended, length - appended);
+            }
+            if (n == 0) {
+                break;
+            }
+            appended += n;
+        }
+        return appended;
+    }
+
+    int _appendToLastSegment(const char *string, int length) noexcept {
+        if (_numSegments == 0) {
+            return 0;
+        }
+        CString &last = _segments[_numSegments - 1];
+        CStringBufferBase *lastBuffer = last._buf;
+        if (lastBuffer->getIndex(last) != lastBuffer->numstrings() - 1) {
+            return 0;
+        }
+
+        // halve the length until it fits, e.g. into the rest of a chunk of a segmented buffer
+        for (int n = std::min(length, lastBuffer->unallocatedBytes()); n > 0; n /= 2) {
+            if (lastBuffer->appendToTopmost(string, n).isAllocated()) {
+                _lengths[_numSegments - 1] += n;
+                _length += n;
+                return n;
+            }
+        }
+        return 0;
+    }
+
+    int _pushSegment(const _Buffer &buffer, const char *string, int length) noexcept {
+        if (_numSegments == _maxSegments) {
+            return 0;
+        }
+        for (int n = std::min(length, buffer.unallocatedBytes(buffer.buffer) - 1); n > 0; n /= 2) {
+            CString segment = buffer.push(buffer.buffer, string, n);
+            if (segment.isAllocated()) {
+                _segments[_numSegments] = segment;
+                _lengths[_numSegments++] = n;
+                _length += n;
+                return n;
+            }
+        }
+        return 0;
+    }
+
+    /// @brief Compares the given string to the content starting at the given offset of the given segment, continuing
+    /// in the following segments.
+    bool _matchesAt(int segment, int offset, const char *str, int length) const noexcept {
+        for (; segment < _numSegments && length > 0; ++segment, offset = 0) {
+            int n = std::min(length, _lengths[segment] - offset);
+            if (memcmp(_segments[segment].raw() + offset, str, n) != 0) {
+                return false;
+            }
+            str += n;
+            length -= n;
+        }
+        return length == 0;
+    }
+};
@@ -0,0 +1,217 @@
+#pragma  once
+
+#include "CString.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/// Preprocessed needle for repeated searches, e.g. a multipart boundary searched within thousands of strings. The skip
+/// table (Boyer-Moore-Horspool) and the two rarest needle bytes used as prefilter are computed once. If SSE2 is
+/// available, the prefilter tests 16 candidate positions at once; otherwise the Horspool search is used exclusively.
+/// The needle is referred to by pointer and must remain valid (and unchanged) as long as the searcher is used.
+class CStringSearcher final {
+public:
+    /// @brief Creates a searcher for the given \0 terminated needle.
+    explicit CStringSearcher(const char *needle) noexcept
+            : CStringSearcher(needle, needle == nullptr ? 0 : (int)strlen(needle)) {}
+
+    /// @brief Creates a searcher for the given needle of the given length.
+    CStringSearcher(const char *needle, int needleLength) noexcept
+            : _needle(needle), _needleLength(needle == nullptr || needleLength < 0 ? 0 : needleLength) {
+        // shifts larger than UINT16_MAX are clamped: shorter shifts are always safe
+        uint16_t maxSkip = (uint16_t)std::min(_needleLength, (int)UINT16_MAX);
+        for (uint16_t &skip : _skip) {
+            skip = std::max(maxSkip, (uint16_t)1);
+        }
+        for (int i = 0; i < _needleLength - 1; ++i) {
+            _skip[(uint8_t)_needle[i]] = (uint16_t)std::min(_needleLength - 1 - i, (int)UINT16_MAX);
+        }
+
+        for (int i = 1; i < _needleLength; ++i) {
+            if (_byteRank(_needle[i]) > _byteRank(_needle[_rareOffset1])) {
+                _rareOffset1 = i;
+            }
+        }
+        // a second byte differing from the first one filters better, even if more common
+        _rareOffset2 = _rareOffset1 == 0 ? std::min(1, _needleLength - 1) : 0;
+        for (int i = 0; i < _needleLength; ++i) {
+            bool differs = _needle[i] != _needle[_rareOffset1];
+            bool currentDiffers = _needle[_rareOffset2] != _needle[_rareOffset1];
+            bool isRarer = differs == currentDiffers && _byteRank(_needle[i]) > _byteRank(_needle[_rareOffset2]);
+            if (i != _rareOffset1 && ((differs && !currentDiffers) || isRarer)) {
+                _rareOffset2 = i;
+            }
+        }
+    }
+
+    /// @brief Reports the index of the first occurrence of the needle within the given data or -1 if not found. An
+    /// empty needle is found at index 0.
+    int find(const char *data, int length) const noexcept {
+        if (data == nullptr || length < _needleLength) {
+            return -1;
+        }
+        if (_needleLength <= 1) {
+            const void *c = _needleLength == 0 ? data : memchr(data, _needle[0], length);
+            return c == nullptr ? -1 : (const char *)c - data;
+        }
+
+        int pos = 0;
+#ifdef __SSE2__
+        const __m128i rare1 = _mm_set1_epi8(_needle[_rareOffset1]);
+        const __m128i rare2 = _mm_set1_epi8(_needle[_rareOffset2]);
+        int lastCandidate = length - _needleLength;
+        for (; pos + 15 <= lastCandidate; pos += 16) {
+            __m128i block1 = _mm_loadu_si128((const __m128i *)(data + pos + _rareOffset1));
+            __m128i block2 = _mm_loadu_si128((const __m128i *)(data + pos + _rareOffset2));
+            unsigned mask = _mm_movemask_epi8(
+                    _mm_and_si128(_mm_cmpeq_epi8(block1, rare1), _mm_cmpeq_epi8(block2, rare2)));
+            for (; mask != 0; mask &= mask - 1) {
+                int candidate = pos + __builtin_ctz(mask);
+                if (memcmp(data + candidate, _needle, _needleLength) == 0) {
+                    return candidate;
+                }
+            }
+        }
+#endif
+
+        // remaining candidates (all of them without SSE2)
+        int result = _findHorspool(data + pos, length - pos);
+        return result < 0 ? -1 : result + pos;
+    }
+
+    /// @brief Retrieves the needle.
+    const char *needle() const noexcept {
+        return _needle;
+    }
+
+    /// @brief Retrieves the length of the needle.
+    int needleLength() const noexcept {
+        return _needleLength;
+    }
+
+private:
+    const char *_needle;
+    int _needleLength;
+
+    // offsets of the rarest and second rarest needle byte (prefilter)
+    int _rareOffset1 = 0;
+    int _rareOffset2 = 0;
+
+    // Horspool: shift distance depending on the last byte of the current window
+    uint16_t _skip[256];
+
+    int _findHorspool(const char *data, int length) const noexcept {
+        const char last = _needle[_needleLength - 1];
+        for (int pos = 0; pos <= length - _needleLength;) {
+            char c = data[pos + _needleLength - 1];
+            if (c == last && memcmp(data + pos, _needle, _needleLength - 1) == 0) {
+                return pos;
+            }
+            pos += _skip[(uint8_t)c];
+        }
+        return -1;
+    }
+
+    /// @brief Estimates how rare the given byte is within typical text and protocol data: higher is rarer.
+    static int _byteRank(char c) noexcept {
+        static constexpr char common[] = " etaoinsrhldcumfpgwybvkxjqz-\r\n/.,0123456789ETAOINSRHLDCUMFPGWYBVKXJQZ:=\"_;";
+        const void *pos = memchr(common, c, sizeof(common) - 1);
+        return pos == nullptr ? (int)sizeof(common) : (const char *)pos - common;
+    }
+};
+
+/// Searches a needle in data that is split across several chunks (e.g. a multipart body received as several
+/// CStrings). Chunks are fed in order; matches spanning chunk boundaries are found as well. No data is copied: only the
+/// length of the needle prefix matched at the end of the data fed so far is retained.
+class CStringSearchStream final {
+public:
+    explicit CStringSearchStream(const CStringSearcher &searcher) noexcept : _searcher(searcher) {}
+
+    /// @brief Feeds the contained string as next chunk. See #find(const char*, int).
+    int64_t find(const CString &chunk) noexcept {
+        int length = chunk.length();
+        return length < 0 ? -1 : find(chunk.raw(), length);
+    }
+
+    /// @brief Feeds the next chunk and searches the first match ending within this chunk.
+    /// @returns The index of the match relative to the beginning of the stream (it might start within a previous
+    /// chunk) or -1 if not found. The stream advances past the whole chunk in any case.
+    int64_t find(const char *chunk, int length) noexcept {
+        if (chunk == nullptr || length < 0) {
+            return -1;
+        }
+
+        const char *needle = _searcher.needle();
+        int needleLength = _searcher.needleLength();
+        int64_t result = -1;
+
+        // matches spanning the boundary: the longest partial match yields the lowest index
+        for (int k = _partialMatch; k > 0 && result < 0; --k) {
+            bool isPartialMatch = memcmp(needle + _partialMatch - k, needle, k) == 0;
+            if (isPartialMatch && needleLength - k <= length
+                && memcmp(chunk, needle + k, needleLength - k) == 0) {
+                result = _position - k;
+            }
+        }
+
+        if (result < 0) {
+            int index = _searcher.find(chunk, length);
+            if (index >= 0) {
+                result = _position + index;
+            }
+        }
+
+        _partialMatch = _continuedPartialMatch(_partialMatch, chunk, length);
+        _position += length;
+        return result;
+    }
+
+    /// @brief Retrieves the number of bytes fed so far.
+    int64_t position() const noexcept {
+        return _position;
+    }
+
+    /// @brief Starts a new stream.
+    void reset() noexcept {
+        _position = 0;
+        _partialMatch = 0;
+    }
+
+private:
+    const CStringSearcher &_searcher;
+    int64_t _position = 0;
+
+    // length of the longest proper needle prefix that is a suffix of the data fed so far
+    int _partialMatch = 0;
+
+    /// @brief Determines the longest proper needle prefix that is a suffix of the given chunk appended to the given
+    /// partial match.
+    int _continuedPartialMatch(int partialMatch, const char *chunk, int length) const noexcept {
+        const char *needle = _searcher.needle();
+        for (int k = std::min(_searcher.needleLength() - 1, partialMatch + length); k > 0; --k) {
+            if (k <= length) {
+                if (memcmp(chunk + length - k, needle, k) == 0) {
+                    return k;
+                }
+            } else {
+                int fromPrevious = k - length;
+                if (memcmp(needle + partialMatch - fromPrevious, needle, fromPrevious) == 0
+                    && memcmp(chunk, needle + fromPrevious, length) == 0) {
+                    return k;
+                }
+            }
+        }
+        return 0;
+    }
+};
+
+inline int CString::indexOf(const CStringSearcher &searcher, int startIndex) const noexcept {
+    int capacity = rawCapacity();
+    if (startIndex < 0 || startIndex >= capacity) {
+        return -1;
+    }
+
+    int result = searcher.find(raw() + startIndex, capacity - startIndex);
+    return result < 0 ? -1 : result + startIndex;
+}
@@ -0,0 +1,476 @@
+#pragma  once
+
+#include "CString.h"
+
+/// CStringBuffer composed of fixed size chunks instead of a single contiguous buffer: strings are placed in the topmost
+/// chunk, a string that does not fit is placed in a new chunk taken from a fixed pool. Removing or moving a string
+/// only moves the bytes of the chunk it is located in, thus the cost of each operation is bounded by the chunk size
+/// (and the number of strings), not by the total capacity. Chunks that become empty are returned to the pool.
+///
+/// Strings are allocated, appended to and removed with the same semantics as CStringBuffer, except that a string's
+/// capacity is limited to the chunk size. Bytes left at the end of a chunk that is no longer the topmost one, or
+/// released by removing a string, are reused only after the chunk's later strings have been removed or moved. The
+/// number of unallocated bytes counts the bytes available in the topmost chunk and in the pool.
+template<int _chunkSize = 4096, int _numChunks = 16, int _maxstrings = 254>
+class CStringSegmentedBuffer final : CStringBufferBase {
+    static_assert(_chunkSize > 1 && _chunkSize < UINT16_MAX && _numChunks > 0 && _numChunks < UINT8_MAX
+                  && _maxstrings > 0 && _maxstrings < UINT8_MAX);
+public:
+    CStringSegmentedBuffer() noexcept {
+        for (int handle = 0; handle < _maxstrings; ++handle) {
+            _handleToStringIdxMap[handle] = INVALID_STRING_IDX;
+        }
+        _releaseAllChunks();
+    }
+
+    CStringSegmentedBuffer(const CStringSegmentedBuffer &) = delete;
+    CStringSegmentedBuffer &operator=(const CStringSegmentedBuffer &) = delete;
+
+    /// @brief Determines the number of chunks holding strings.
+    int usedChunks() const noexcept {
+        return _numChunks - _numFreeChunks;
+    }
+
+    virtual CString allocate() noexcept override {
+        return push('\0');
+    }
+
+    virtual CString allocate(int maxLength) noexcept override {
+        CString initialAllocation = allocate();
+        if (!initialAllocation.isAllocated()) {
+            return initialAllocation;
+        }
+
+        CString resizedAllocation = resizeTopmost(maxLength);
+        if (!resizedAllocation.isAllocated()) {
+            pop();
+            return CString::INVALID;
+        }
+
+        return resizedAllocation;
+    }
+
+    virtual CString allocateRemaining() noexcept override {
+        // largest contiguous area: rest of the topmost chunk or a new chunk
+        int remaining = std::max(_topChunk == INVALID_CHUNK ? 0 : _chunkSize - _chunkUsed[_topChunk],
+                                 _numFreeChunks > 0 ? _chunkSize : 0);
+        if (remaining < 1) {
+            return CString::INVALID;
+        }
+        return allocate(remaining - 1);
+    }
+
+    virtual CString push() noexcept override {
+        return allocate();
+    }
+
+    virtual CString push(int maxLength) noexcept override {
+        return allocate(maxLength);
+    }
+
+    virtual CString push(const char c) noexcept override {
+        return push(&c, 1);
+    }
+
+    virtual CString push(const char *string) noexcept override {
+        return push(string, INT_MAX);
+    }
+
+    virtual CString push(const char *string, int limit) noexcept override {
+        CStringHandle handle = _nextUnallocatedHandle();
+        if (string == nullptr || limit < 0 || handle == INVALID_STRING_IDX) {
+            return CString::INVALID;
+        }
+
+        int length = _lengthWithin(string, std::min(limit, _chunkSize));
+        if (length == _chunkSize || !_reserveTop(length + 1)) {
+            return CString::INVALID;
+        }
+
+        uint8_t chunk = _topChunk;
+        char *dst = _chunks[chunk] + _chunkUsed[chunk];
+        memmove(dst, string, length);
+        dst[length] = '\0';
+
+        _chunkOf[_numstrings] = chunk;
+        _offsetOf[_numstrings] = _chunkUsed[chunk];
+        _chunkUsed[chunk] += length + 1;
+        _stringIdxToHandle[_numstrings] = handle;
+        _handleToStringIdxMap[handle] = _numstrings;
+        _curHandle = handle;
+        _numstrings++;
+        return CString(this, handle);
+    }
+
+    virtual CString pushFormat(const char *format, ...) noexcept override {
+        va_list args;
+        va_start(args, format);
+        return pushFormatV(format, args);
+    }
+
+    virtual CString pushFormatV(const char *format, va_list args) noexcept override {
+        if (allocate().isInvalid()) {
+            return CString::INVALID;
+        }
+        return appendToTopmostFormatV(format, args);
+    }
+
+    virtual CString peek() noexcept override {
+        if (_numstrings == 0) {
+            return CString::INVALID;
+        }
+        return CString(this, _curHandle);
+    }
+
+    virtual bool pop() noexcept override {
+        if (_numstrings == 0) {
+            return false;
+        }
+        return remove(_numstrings - 1);
+    }
+
+    virtual CString appendToTopmost(const char c) noexcept override {
+        return appendToTopmost(&c, 1);
+    }
+
+    virtual CString appendToTopmost(const char *string) noexcept override {
+        return appendToTopmost(string, INT_MAX);
+    }
+
+    virtual CString appendToTopmost(const char *string, int limit) noexcept override {
+        if (_numstrings == 0) {
+            // append is push if there are no strings yet
+            return push(string, limit);
+        }
+        if (limit == 0) {
+            return CString(this, _curHandle);
+        }
+        if (string == nullptr || limit < 0) {
+            return CString::INVALID;
+        }
+
+        int length = _lengthWithin(string, std::min(limit, _chunkSize));
+        char *dst = _growTopmost(length);
+        if (dst == nullptr) {
+            return CString::INVALID;
+        }
+        // the string might have been located in the area released by relocating the topmost string: still readable
+        memmove(dst, string, length);
+        dst[length] = '\0';
+        return CString(this, _curHandle);
+    }
+
+    virtual CString appendToTopmostFormat(const char *format, ...) noexcept override {
+        va_list args;
+        va_start(args, format);
+        return appendToTopmostFormatV(format, args);
+    }
+
+    virtual CString appendToTopmostFormatV(const char *format, va_list args) noexcept override {
+        if (_numstrings == 0) {
+            return CString::INVALID;
+        }
+
+        va_list argsCopy;
+        va_copy(argsCopy, args);
+        int length = vsnprintf(nullptr, 0, format, argsCopy);
+        va_end(argsCopy);
+        char *dst = length < 0 ? nullptr : _growTopmost(length);
+        if (dst == nullptr) {
+            return CString::INVALID;
+        }
+
+        // overwrites the \0 at the end of the area, then appends a new one
+        vsnprintf(dst, length + 1, format, args);
+        return CString(this, _curHandle);
+    }
+
+    virtual CString resizeTopmost(int maxLength) noexcept override {
+        if (_numstrings == 0 || maxLength < 0 || maxLength >= _chunkSize) {
+            return CString::INVALID;
+        }
+
+        uint8_t index = _numstrings - 1;
+        int difference = maxLength + 1 - getRawStringCapacity(index);
+        if (difference > 0 && _growTopmost(difference) == nullptr) {
+            return CString::INVALID;
+        }
+        if (difference < 0) {
+            _chunkUsed[_chunkOf[index]] += difference;
+        }
+
+        _area(index)[maxLength] = '\0';
+        return CString(this, _curHandle);
+    }
+
+    virtual bool moveToTop(const CString &cstring) noexcept override {
+        uint8_t index = getIndex(cstring);
+        if (index == INVALID_STRING_IDX) {
+            return false;
+        }
+        if (index == _numstrings - 1) {
+            return true;
+        }
+
+        uint8_t chunk = _chunkOf[index];
+        int capacity = getRawStringCapacity(index);
+        if (chunk == _topChunk && _chunkSize - _chunkUsed[chunk] < capacity) {
+            // no room at the end of the topmost chunk: rotate the string to the end within the chunk
+            char *area = _area(index);
+            std::rotate(area, area + capacity, _chunks[chunk] + _chunkUsed[chunk]);
+            for (int i = index + 1; i < _numstrings; ++i) {
+                _offsetOf[i] -= capacity;
+            }
+        } else {
+            // copy to the end of the topmost chunk or to a new one, then remove the original area
+            if (!_reserveTop(capacity)) {
+                return false;
+            }
+            memcpy(_chunks[_topChunk] + _chunkUsed[_topChunk], _area(index), capacity);
+            _chunkUsed[_topChunk] += capacity;
+            _removeArea(index);
+        }
+
+        CStringHandle handle = _stringIdxToHandle[index];
+        _eraseIndex(index);
+        _numstrings--;
+        uint8_t newIndex = _numstrings;
+        _chunkOf[newIndex] = _topChunk;
+        _offsetOf[newIndex] = _chunkUsed[_topChunk] - capacity;
+        _stringIdxToHandle[newIndex] = handle;
+        _handleToStringIdxMap[handle] = newIndex;
+        _curHandle = handle;
+        _numstrings++;
+
+        _releaseIfEmpty(chunk);
+        return true;
+    }
+
+    virtual bool remove(CString &cstring) noexcept override {
+        return remove(getIndex(cstring));
+    }
+
+    virtual bool remove(uint8_t index) noexcept override {
+        if (index >= _numstrings) {
+            return false;
+        }
+
+        uint8_t chunk = _chunkOf[index];
+        _removeArea(index);
+        _handleToStringIdxMap[_stringIdxToHandle[index]] = INVALID_STRING_IDX;
+        _eraseIndex(index);
+        _numstrings--;
+
+        // the topmost string is located at the end of its chunk: it becomes the topmost chunk
+        _curHandle = _numstrings == 0 ? INVALID_STRING_IDX : _stringIdxToHandle[_numstrings - 1];
+        if (chunk == _topChunk && _numstrings > 0 && _chunkOf[_numstrings - 1] != chunk) {
+            _topChunk = _chunkOf[_numstrings - 1];
+        }
+        _releaseIfEmpty(chunk);
+        return true;
+    }
+
+    virtual bool removeAll() noexcept override {
+        if (_numstrings == 0) {
+            return false;
+        }
+
+        for (int handle = 0; handle < _maxstrings; ++handle) {
+            _handleToStringIdxMap[handle] = INVALID_STRING_IDX;
+        }
+        _numstrings = 0;
+        _curHandle = INVALID_STRING_IDX;
+        _releaseAllChunks();
+        return true;
+    }
+
+    virtual uint8_t getIndex(const CString &cstring) const noexcept override {
+        if (cstring._buf != this || cstring._handle >= _maxstrings) {
+            return INVALID_STRING_IDX;
+        }
+        return _handleToStringIdxMap[cstring._handle];
+    }
+
+    virtual CString getCString(uint8_t index) noexcept override {
+        if (index >= _numstrings) {
+            return CString::INVALID;
+        }
+        return CString(this, _stringIdxToHandle[index]);
+    }
+
+    virtual char *getRawString(uint8_t index) const noexcept override {
+        if (index >= _numstrings) {
+            return nullptr;
+        }
+        return _area(index);
+    }
+
+    virtual char *getRawString(const CString &cstring) const noexcept override {
+        return getRawString(getIndex(cstring));
+    }
+
+    virtual int getRawStringCapacity(uint8_t index) const noexcept override {
+        if (index >= _numstrings) {
+            return -1;
+        }
+
+        uint8_t chunk = _chunkOf[index];
+        bool isLastOfChunk = index == _numstrings - 1 || _chunkOf[index + 1] != chunk;
+        return (isLastOfChunk ? _chunkUsed[chunk] : _offsetOf[index + 1]) - _offsetOf[index];
+    }
+
+    virtual int getRawStringCapacity(const CString &cstring) const noexcept override {
+        return getRawStringCapacity(getIndex(cstring));
+    }
+
+    virtual uint8_t numstrings() const noexcept override {
+        return _numstrings;
+    }
+
+    virtual uint8_t remainingStrings() const noexcept override {
+        return _maxstrings - _numstrings;
+    }
+
+    virtual int capacity() const noexcept override {
+        return _chunkSize * _numChunks;
+    }
+
+    virtual int allocatedBytes() const noexcept override {
+        return capacity() - unallocatedBytes();
+    }
+
+    virtual int unallocatedBytes() const noexcept override {
+        return _numFreeChunks * _chunkSize + (_topChunk == INVALID_CHUNK ? 0 : _chunkSize - _chunkUsed[_topChunk]);
+    }
+
+private:
+    static constexpr uint8_t INVALID_CHUNK = UINT8_MAX;
+
+    char _chunks[_numChunks][_chunkSize];
+    uint16_t _chunkUsed[_numChunks]{};
+    uint8_t _freeChunks[_numChunks];
+    uint8_t _numFreeChunks = 0;
+    uint8_t _topChunk = INVALID_CHUNK;
+
+    // strings in index order: chunk, offset within the chunk and handle
+    uint8_t _chunkOf[_maxstrings];
+    uint16_t _offsetOf[_maxstrings];
+    CStringHandle _stringIdxToHandle[_maxstrings];
+    uint8_t _numstrings = 0;
+
+    CStringHandle _curHandle = INVALID_STRING_IDX;
+    uint8_t _handleToStringIdxMap[_maxstrings];
+
+    /// @brief Determines the length of the given string, but at most maxLength. Unlike strnlen, whose bound may exceed
+    /// a short argument, this triggers no -Wstringop-overread.
+    static int _lengthWithin(const char *string, int maxLength) noexcept {
+        int length = 0;
+        while (length < maxLength && string[length]) {
+            length++;
+        }
+        return length;
+    }
+
+    char *_area(int index) const noexcept {
+        return (char *)_chunks[_chunkOf[index]] + _offsetOf[index];
+    }
+
+    void _releaseAllChunks() noexcept {
+        for (int chunk = 0; chunk < _numChunks; ++chunk) {
+            _freeChunks[chunk] = _numChunks - 1 - chunk;
+            _chunkUsed[chunk] = 0;
+        }
+        _numFreeChunks = _numChunks;
+        _topChunk = INVALID_CHUNK;
+    }
+
+    void _releaseIfEmpty(uint8_t chunk) noexcept {
+        if (_chunkUsed[chunk] > 0) {
+            return;
+        }
+        _freeChunks[_numFreeChunks++] = chunk;
+        if (chunk == _topChunk) {
+            _topChunk = _numstrings == 0 ? INVALID_CHUNK : _chunkOf[_numstrings - 1];
+        }
+    }
+
+    /// @brief Makes sure the topmost chunk provides the given number of bytes, takes a new chunk if necessary.
+    bool _reserveTop(int size) noexcept {
+        if (_topChunk != INVALID_CHUNK && _chunkSize - _chunkUsed[_topChunk] >= size) {
+            return true;
+        }
+        if (size > _chunkSize || _numFreeChunks == 0) {
+            return false;
+        }
+        _topChunk = _freeChunks[--_numFreeChunks];
+        _chunkUsed[_topChunk] = 0;
+        return true;
+    }
+
+    /// @brief Adds the given number of bytes to the area of the topmost string, relocates it to a new chunk if
+    /// necessary.
+    /// @returns Pointer to the former last byte of the area or nullptr if capacity is too low.
+    char *_growTopmost(int additional) noexcept {
+        uint8_t index = _numstrings - 1;
+        int capacity = getRawStringCapacity(index);
+        if (additional > _chunkSize - capacity) {
+            return nullptr;
+        }
+
+        uint8_t chunk = _chunkOf[index];
+        if (_chunkSize - _chunkUsed[chunk] < additional) {
+            // preceded by other strings of the chunk: relocate
+            if (_numFreeChunks == 0) {
+                return nullptr;
+            }
+            uint8_t newChunk = _freeChunks[--_numFreeChunks];
+            memcpy(_chunks[newChunk], _area(index), capacity);
+            _chunkUsed[chunk] -= capacity;
+            _chunkUsed[newChunk] = capacity;
+            _chunkOf[index] = newChunk;
+            _offsetOf[index] = 0;
+            _topChunk = newChunk;
+            chunk = newChunk;
+        }
+
+        _chunkUsed[chunk] += additional;
+        return _area(index) + capacity - 1;
+    }
+
+    /// @brief Removes the area of the given string from its chunk: moves the chunk's following strings.
+    void _removeArea(uint8_t index) noexcept {
+        uint8_t chunk = _chunkOf[index];
+        int capacity = getRawStringCapacity(index);
+        char *area = _area(index);
+        memmove(area, area + capacity, _chunks[chunk] + _chunkUsed[chunk] - area - capacity);
+        _chunkUsed[chunk] -= capacity;
+        for (int i = index + 1; i < _numstrings && _chunkOf[i] == chunk; ++i) {
+            _offsetOf[i] -= capacity;
+        }
+    }
+
+    /// @brief Removes the given index from the string table: following strings' indexes are decremented.
+    void _eraseIndex(uint8_t index) noexcept {
+        for (int i = index + 1; i < _numstrings; ++i) {
+            _chunkOf[i - 1] = _chunkOf[i];
+            _offsetOf[i - 1] = _offsetOf[i];
+            _stringIdxToHandle[i - 1] = _stringIdxToHandle[i];
+            _handleToStringIdxMap[_stringIdxToHandle[i]] = i - 1;
+        }
+    }
+
+    CStringHandle _nextUnallocatedHandle() noexcept {
+        if (_numstrings == _maxstrings) {
+            return INVALID_STRING_IDX;
+        }
+
+        for (CStringHandle candidateHandle = _curHandle + 1; ; ++candidateHandle) {
+            if (candidateHandle >= _maxstrings) {
+                candidateHandle = 0;
+            }
+            if (_handleToStringIdxMap[candidateHandle] == INVALID_STRING_IDX) {
+                return candidateHandle;
+            }
+        }
+    }
+};
@@ -0,0 +1,382 @@
+#pragma  once
+
+#include "CStringBufferView.h"
+
+#if __has_include(<sys/mman.h>) && __has_include(<atomic>)
+#include <atomic>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CSTRING_HAS_SHM
+
+/// CStringBuffer located in a POSIX shared memory segment, such that other processes read its strings in place
+/// instead of receiving copies, e.g. through a socket. A single process creates the segment and writes to it using
+/// the CStringBuffer API; any number of processes open it for reading. The segment holds a header, the metadata of a
+/// CStringBufferView - offsets instead of pointers, thus each process may map it at another address - and the string
+/// data.
+///
+/// Readers do not block the writer: the writer increments a sequence number before and after each modification
+/// (seqlock), readers check it to be even and unchanged after reading (see #read()). Modifications through buffer
+/// methods, including those invoked by CString (e.g. `append()`), are published automatically, each as a whole. CString methods
+/// modifying a string in place (e.g. `toLower()`, `trim()` or `operator[]`) must be enclosed by #beginWrite() and
+/// #endWrite(), which also allows publishing several modifications at once.
+class CStringSharedBuffer final : public CStringBufferView {
+public:
+    /// @brief Version of the segment layout. Segments of other versions are rejected.
+    static constexpr uint32_t formatVersion = 2;
+
+    CStringSharedBuffer() noexcept = default;
+    CStringSharedBuffer(const CStringSharedBuffer &) = delete;
+    CStringSharedBuffer &operator=(const CStringSharedBuffer &) = delete;
+
+    ~CStringSharedBuffer() noexcept {
+        close();
+    }
+
+    /// @brief Creates the shared memory segment with the given name (see `shm_open`), or truncates it if it exists, and
+    /// maps it for writing. The segment's size is the given capacity plus a few bytes for the header and string table.
+    /// A segment that was mapped before is closed first.
+    /// @returns `true` if the segment was created, `false` otherwise (see errno).
+    bool create(const char *name, int capacity, uint8_t maxstrings = INVALID_STRING_IDX - 1) noexcept {
+        close();
+        if (capacity <= 0 || maxstrings == 0 || maxstrings == INVALID_STRING_IDX) {
+            errno = EINVAL;
+            return false;
+        }
+
+        int fd = shm_open(name, O_RDWR | O_CREAT | O_TRUNC, 0600);
+        if (fd < 0) {
+            return false;
+        }
+        size_t dataOffset = _dataOffset(maxstrings);
+        bool mapped = ftruncate(fd, dataOffset + capacity) == 0
+            && _map(fd, dataOffset + capacity, PROT_READ | PROT_WRITE);
+        _closeKeepingErrno(fd);
+        if (!mapped) {
+            return false;
+        }
+
+        // a new segment is zero-filled: the sequence number is even
+        Header *header = (Header *)_mapping;
+        header->version = formatVersion;
+        header->dataOffset = dataOffset;
+        CStringBufferView::create(_mapping + dataOffset, capacity, _mapping + sizeof(Header),
+                                  dataOffset - sizeof(Header), maxstrings);
+        std::atomic_thread_fence(std::memory_order_release);
+        memcpy(header->magic, _magic, sizeof(_magic));
+        _writable = true;
+        return true;
+    }
+
+    /// @brief Maps the shared memory segment with the given name for reading. It must have been created by #create().
+    /// The buffer methods behave like a buffer without capacity then, strings are read using #read(). A segment that
+    /// was mapped before is closed first.
+    /// @returns `true` if the segment was opened, `false` otherwise, e.g. if it is no compatible segment (errno is
+    /// EINVAL then).
+    bool open(const char *name) noexcept {
+        close();
+
+        int fd = shm_open(name, O_RDONLY, 0);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat stat;
+        if (fstat(fd, &stat) != 0) {
+            _closeKeepingErrno(fd);
+            return false;
+        }
+        // the header must be mapped from the segment: accessing mapped pages beyond its end raises SIGBUS
+        bool isLargeEnough = (size_t)stat.st_size >= sizeof(Header) + sizeof(Metadata);
+        bool mapped = isLargeEnough && _map(fd, stat.st_size, PROT_READ);
+        _closeKeepingErrno(fd);
+        if (!mapped) {
+            errno = isLargeEnough ? errno : EINVAL;
+            return false;
+        }
+
+        // capacity and maxstrings do not change after creation
+        const Header *header = (const Header *)_mapping;
+        const Metadata *metadata = (const Metadata *)(_mapping + sizeof(Header));
+        if (memcmp(header->magic, _magic, sizeof(_magic)) != 0 || header->version != formatVersion
+            || metadata->maxstrings == 0 || metadata->maxstrings == INVALID_STRING_IDX
+            || header->dataOffset != _dataOffset(metadata->maxstrings) || metadata->capacity <= 0
+            || _mappingSize != header->dataOffset + (size_t)metadata->capacity) {
+            close();
+            errno = EINVAL;
+            return false;
+        }
+        return true;
+    }
+
+    /// @brief Unmaps the segment, which persists until it is removed (see #unlink()). CStrings allocated using this
+    /// buffer become invalid.
+    void close() noexcept {
+        if (_mapping == nullptr) {
+            return;
+        }
+
+        detach();
+        munmap(_mapping, _mappingSize);
+        _mapping = nullptr;
+        _mappingSize = 0;
+        _writable = false;
+        _writeDepth = 0;
+    }
+
+    /// @brief Removes the shared memory segment with the given name. Processes that mapped it keep using it until they
+    /// close it.
+    /// @returns `true` on success, `false` otherwise (see errno).
+    static bool unlink(const char *name) noexcept {
+        return shm_unlink(name) == 0;
+    }
+
+    /// @brief Determines whether a segment is mapped.
+    bool isOpen() const noexcept {
+        return _mapping != nullptr;
+    }
+
+    /// @brief Determines whether the segment was created by this buffer, that is whether it is mapped for writing.
+    bool isWritable() const noexcept {
+        return _writable;
+    }
+
+    /// @brief Starts a modification, which is published to readers by the matching #endWrite(). Calls may be nested:
+    /// the outermost pair publishes. Required only for modifying strings in place.
+    void beginWrite() noexcept {
+        if (_writable && _writeDepth++ == 0) {
+            std::atomic<uint32_t> &sequence = _header()->sequence;
+            sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+    }
+
+    /// @brief Publishes the modifications done since #beginWrite().
+    void endWrite() noexcept {
+        if (_writable && _writeDepth > 0 && --_writeDepth == 0) {
+            std::atomic<uint32_t> &sequence = _header()->sequence;
+            sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+    }
+
+    /// @brief Determines the sequence number, which is incremented twice by each published modification. Readers may
+    /// poll it to detect changes.
+    uint32_t sequence() const noexcept {
+        return _mapping == nullptr ? 0 : _header()->sequence.load(std::memory_order_acquire);
+    }
+
+    /// @brief Invokes `fn(uint8_t index, const char *string, int length)` for each string in index order. Strings are
+    /// read in place, without copying. As the writer may modify them concurrently, fn must only rely on the strings'
+    /// content after `true` was returned, e.g. by processing them in a way that can be discarded. All offsets are
+    /// checked, such that concurrent modifications never cause reading beyond the segment.
+    /// @returns `true` if no modification took place while reading, `false` if reading must be retried.
+    template<typename Fn>
+    bool read(Fn &&fn) const noexcept {
+        if (_mapping == nullptr) {
+            return false;
+        }
+
+        const std::atomic<uint32_t> &sequence = _header()->sequence;
+        uint32_t before = sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            return false;
+        }
+
+        // read each value of the metadata once: values checked are used
+        const volatile Metadata *metadata = (const volatile Metadata *)(_mapping + sizeof(Header));
+        const volatile uint32_t *offsets = (const volatile uint32_t *)(metadata + 1);
+        const char *data = _mapping + ((const Header *)_mapping)->dataOffset;
+        uint32_t capacity = metadata->capacity;
+        uint8_t maxstrings = metadata->maxstrings;
+        uint8_t numstrings = metadata->numstrings;
+        numstrings = std::min(numstrings, maxstrings);
+        uint32_t start = offsets[0];
+        for (int i = 0; i < numstrings; ++i) {
+            uint32_t end = offsets[i + 1];
+            if (start >= end || end > capacity) {
+                return false;
+            }
+            fn((uint8_t)i, data + start, (int)strnlen(data + start, end - start));
+            start = end;
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return sequence.load(std::memory_order_relaxed) == before;
+    }
+
+    using CStringBufferView::allocate;
+    using CStringBufferView::push;
+    using CStringBufferView::appendToTopmost;
+    using CStringBufferView::remove;
+    using CStringBufferView::pushSmall;
+
+    virtual CString allocate(int maxLength) noexcept override {
+        _WriteGuard guard(*this);
+        return CStringBufferView::allocate(maxLength);
+    }
+
+    virtual CString pushFormatV(const char *format, va_list args) noexcept override {
+        _WriteGuard guard(*this);
+        return CStringBufferView::pushFormatV(format, args);
+    }
+
+    virtual CString push(const char *string, int limit) noexcept override {
+        _WriteGuard guard(*this);
+        return CStringBufferView::push(string, limit);
+    }
+
+    virtual CString appendToTopmost(const char *string, int limit) noexcept override {
+        _WriteGuard guard(*this);
+        return CStringBufferView::appendToTopmost(string, limit);
+    }
+
+    virtual CString appendToTopmostFormatV(const char *format, va_list args) noexcept override {
+        _WriteGuard guard(*this);
+        return CStringBufferView::appendToTopmostFormatV(format, args);
+    }
+
+    virtual CString resizeTopmost(int maxLength) noexcept override {
+        _WriteGuard guard(*this);
+        return CStringBufferView::resizeTopmost(maxLength);
+    }
+
+    virtual bool moveToTop(const CString &cstring) noexcept override {
+        _WriteGuard guard(*this);
+        return CStringBufferView::moveToTop(cstring);
+    }
+
+    virtual bool remove(CString &cstring) noexcept override {
+        _WriteGuard guard(*this);
+        return CStringBufferView::remove(cstring);
+    }
+
+    virtual bool remove(uint8_t index) noexcept override {
+        _WriteGuard guard(*this);
+        return CStringBufferView::remove(index);
+    }
+
+    virtual bool removeAll() noexcept override {
+        _WriteGuard guard(*this);
+        return CStringBufferView::removeAll();
+    }
+
+    virtual CString pushSmall(const char *string, int limit) noexcept override {
+        _WriteGuard guard(*this);
+        return CStringBufferView::pushSmall(string, limit);
+    }
+
+    virtual CString share(const CString &cstring) noexcept override {
+        _WriteGuard guard(*this);
+        return CStringBufferView::share(cstring);
+    }
+
+    virtual bool unshare(const CString &cstring) noexcept override {
+        _WriteGuard guard(*this);
+        return CStringBufferView::unshare(cstring);
+    }
+
+    virtual bool spill(const CString &cstring) noexcept override {
+        _WriteGuard guard(*this);
+        return CStringBufferView::spill(cstring);
+    }
+
+    /// @brief See CStringBufferCore#pushUnallocated().
+    CString pushUnallocated(int length) noexcept {
+        _WriteGuard guard(*this);
+        return CStringBufferView::pushUnallocated(length);
+    }
+
+    /// @brief See CStringBufferCore#deserialize().
+    bool deserialize(const char *image, int length) noexcept {
+        _WriteGuard guard(*this);
+        return CStringBufferView::deserialize(image, length);
+    }
+
+    /// @brief See CStringBufferCore#compact().
+    int compact() noexcept {
+        _WriteGuard guard(*this);
+        return CStringBufferView::compact();
+    }
+
+    /// @brief See CStringBufferCore#forEachParallel(). Modifications by fn are published as a whole.
+    template<typename Executor, typename Fn>
+    bool forEachParallel(Executor &executor, Fn &&fn) noexcept {
+        _WriteGuard guard(*this);
+        return CStringBufferView::forEachParallel(executor, std::forward<Fn>(fn));
+    }
+
+    /// @brief See CStringBufferCore#toLowerAll().
+    template<typename Executor>
+    void toLowerAll(Executor &executor) noexcept {
+        _WriteGuard guard(*this);
+        CStringBufferView::toLowerAll(executor);
+    }
+
+    /// @brief See CStringBufferCore#trimAll().
+    template<typename Executor>
+    int trimAll(Executor &executor) noexcept {
+        _WriteGuard guard(*this);
+        return CStringBufferView::trimAll(executor);
+    }
+
+private:
+    using CStringBufferView::attach;
+    using CStringBufferView::detach;
+
+    // segment layout: Header, CStringBufferView metadata, data
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t dataOffset;
+        std::atomic<uint32_t> sequence;
+        uint32_t reserved;
+    };
+    static_assert(std::atomic<uint32_t>::is_always_lock_free, "sequence must be shared between processes");
+
+    struct _WriteGuard {
+        explicit _WriteGuard(CStringSharedBuffer &buffer) noexcept : buffer(buffer) {
+            buffer.beginWrite();
+        }
+
+        ~_WriteGuard() noexcept {
+            buffer.endWrite();
+        }
+
+        CStringSharedBuffer &buffer;
+    };
+
+    static constexpr char _magic[8] = {'C', 'S', 'T', 'R', 'S', 'H', 'M', '\0'};
+
+    char *_mapping = nullptr;
+    size_t _mappingSize = 0;
+    bool _writable = false;
+    int _writeDepth = 0;
+
+    /// @brief Offset of the data area: cache line aligned.
+    static constexpr size_t _dataOffset(uint8_t maxstrings) noexcept {
+        return (sizeof(Header) + metadataSize(maxstrings) + 63) & ~(size_t)63;
+    }
+
+    Header *_header() const noexcept {
+        return (Header *)_mapping;
+    }
+
+    static void _closeKeepingErrno(int fd) noexcept {
+        int error = errno;
+        ::close(fd);
+        errno = error;
+    }
+
+    bool _map(int fd, size_t size, int protection) noexcept {
+        void *mapping = mmap(nullptr, size, protection, MAP_SHARED, fd, 0);
+        if (mapping == MAP_FAILED) {
+            return false;
+        }
+        _mapping = (char *)mapping;
+        _mappingSize = size;
+        return true;
+    }
+};
+
+#endif
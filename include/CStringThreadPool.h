@@ -0,0 +1,121 @@
+#pragma  once
+
+#include "CString.h"
+
+#if __has_include(<thread>)
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#define CSTRING_HAS_THREADS
+
+/// Small fixed size thread pool executing the tasks of a single job at a time, e.g. the parallel bulk operations of
+/// CStringBuffer (see CStringBuffer#forEachParallel()). Threads are started once by the constructor; running a job
+/// allocates nothing. Idle threads take the next task from a shared counter, such that threads finishing early take
+/// over the remaining work of slower ones. The calling thread takes part in running the job.
+template<int _maxThreads = 16>
+class CStringThreadPool final {
+    static_assert(_maxThreads > 0);
+public:
+    /// @brief Starts `numThreads - 1` worker threads, limited to 1 to _maxThreads. Uses all hardware threads by
+    /// default.
+    explicit CStringThreadPool(int numThreads = std::thread::hardware_concurrency()) noexcept
+            : _numThreads(std::clamp(numThreads, 1, _maxThreads)) {
+        for (int i = 0; i < _numThreads - 1; ++i) {
+            _workers[i] = std::thread([this] { _runWorker(); });
+        }
+    }
+
+    CStringThreadPool(const CStringThreadPool &) = delete;
+    CStringThreadPool &operator=(const CStringThreadPool &) = delete;
+
+    ~CStringThreadPool() noexcept {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _started.notify_all();
+        for (int i = 0; i < _numThreads - 1; ++i) {
+            _workers[i].join();
+        }
+    }
+
+    /// @brief Determines the number of threads running a job, including the calling thread.
+    int numThreads() const noexcept {
+        return _numThreads;
+    }
+
+    /// @brief Invokes `fn(int task)` for each task 0 to numTasks - 1 and waits until all tasks have been completed.
+    /// Tasks run concurrently in any order. Must not be called concurrently.
+    template<typename Fn>
+    void run(int numTasks, Fn &&fn) noexcept {
+        if (_numThreads == 1 || numTasks <= 1) {
+            for (int task = 0; task < numTasks; ++task) {
+                fn(task);
+            }
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _invoke = [](void *context, int task) { (*(std::remove_reference_t<Fn> *)context)(task); };
+            _context = (void *)&fn;
+            _numTasks = numTasks;
+            _nextTask.store(0, std::memory_order_relaxed);
+            _activeWorkers = _numThreads - 1;
+            _generation++;
+        }
+        _started.notify_all();
+
+        _runTasks();
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        _finished.wait(lock, [this] { return _activeWorkers == 0; });
+    }
+
+private:
+    const int _numThreads;
+    std::thread _workers[_maxThreads - 1 > 0 ? _maxThreads - 1 : 1];
+
+    std::mutex _mutex;
+    std::condition_variable _started;
+    std::condition_variable _finished;
+    uint64_t _generation = 0;
+    int _activeWorkers = 0;
+    bool _stop = false;
+
+    // current job: written while holding the mutex before workers are started
+    void (*_invoke)(void *context, int task) = nullptr;
+    void *_context = nullptr;
+    int _numTasks = 0;
+    alignas(64) std::atomic<int> _nextTask{0};
+
+    void _runTasks() noexcept {
+        for (int task; (task = _nextTask.fetch_add(1, std::memory_order_relaxed)) < _numTasks;) {
+            _invoke(_context, task);
+        }
+    }
+
+    void _runWorker() noexcept {
+        uint64_t generation = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _started.wait(lock, [&] { return _stop || _generation != generation; });
+                if (_stop) {
+                    return;
+                }
+                generation = _generation;
+            }
+
+            _runTasks();
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (--_activeWorkers == 0) {
+                _finished.notify_one();
+            }
+        }
+    }
+};
+
+#endif
@@ -1,7 +1,354 @@
 #include "CString.h"
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define CSTRING_UTF8_NEON
+#endif
+
 CString CString::INVALID = CString(nullptr, INVALID_STRING_IDX);
 
+/// @brief Decodes the UTF-8 sequence at the given position.
+/// @returns The length of the sequence or 0 if it is ill-formed or truncated.
+static int decodeUtf8(const uint8_t *s, int available, char32_t &codePoint) noexcept {
+    uint8_t c = s[0];
+    if (c < 0x80) {
+        codePoint = c;
+        return 1;
+    }
+
+    // valid ranges of the second byte according to the unicode standard (table 3-7)
+    int length;
+    uint8_t min2 = 0x80;
+    uint8_t max2 = 0xBF;
+    if (c < 0xC2) {
+        return 0;
+    } else if (c < 0xE0) {
+        length = 2;
+        codePoint = c & 0x1F;
+    } else if (c < 0xF0) {
+        length = 3;
+        codePoint = c & 0x0F;
+        min2 = c == 0xE0 ? 0xA0 : 0x80;
+        max2 = c == 0xED ? 0x9F : 0xBF;
+    } else if (c < 0xF5) {
+        length = 4;
+        codePoint = c & 0x07;
+        min2 = c == 0xF0 ? 0x90 : 0x80;
+        max2 = c == 0xF4 ? 0x8F : 0xBF;
+    } else {
+        return 0;
+    }
+
+    if (available < length || s[1] < min2 || s[1] > max2) {
+        return 0;
+    }
+    codePoint = codePoint << 6 | (s[1] & 0x3F);
+    for (int i = 2; i < length; ++i) {
+        if ((s[i] & 0xC0) != 0x80) {
+            return 0;
+        }
+        codePoint = codePoint << 6 | (s[i] & 0x3F);
+    }
+    return length;
+}
+
+static constexpr char base64Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static constexpr char base64UrlAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+struct DecodeTable {
+    int8_t values[256];
+};
+
+// value of each base64 digit of both alphabets, -1 if invalid
+static constexpr DecodeTable base64DecodeTable = [] {
+    DecodeTable table{};
+    for (int8_t &value : table.values) {
+        value = -1;
+    }
+    for (int i = 0; i < 64; ++i) {
+        table.values[(uint8_t)base64Alphabet[i]] = i;
+        table.values[(uint8_t)base64UrlAlphabet[i]] = i;
+    }
+    return table;
+}();
+
+// value of each hex digit, -1 if invalid
+static constexpr DecodeTable hexDecodeTable = [] {
+    DecodeTable table{};
+    for (int i = 0; i < 256; ++i) {
+        table.values[i] = i >= '0' && i <= '9' ? i - '0' : i >= 'a' && i <= 'f' ? i - 'a' + 10
+                : i >= 'A' && i <= 'F' ? i - 'A' + 10 : -1;
+    }
+    return table;
+}();
+
+static void encodeHex(const uint8_t *src, int length, char *dst, bool upperCase) noexcept {
+    const char *digits = upperCase ? "0123456789ABCDEF" : "0123456789abcdef";
+    int i = 0;
+#ifdef __SSE2__
+    // digit = nibble + '0', plus the distance from '9' + 1 to 'a' (or 'A') for nibbles > 9
+    const __m128i lowNibbleMask = _mm_set1_epi8(0x0F);
+    const __m128i nine = _mm_set1_epi8(9);
+    const __m128i zero = _mm_set1_epi8('0');
+    const __m128i letterOffset = _mm_set1_epi8(upperCase ? 'A' - '0' - 10 : 'a' - '0' - 10);
+    for (; i + 16 <= length; i += 16) {
+        __m128i bytes = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i high = _mm_and_si128(_mm_srli_epi16(bytes, 4), lowNibbleMask);
+        __m128i low = _mm_and_si128(bytes, lowNibbleMask);
+        high = _mm_add_epi8(_mm_add_epi8(high, zero), _mm_and_si128(_mm_cmpgt_epi8(high, nine), letterOffset));
+        low = _mm_add_epi8(_mm_add_epi8(low, zero), _mm_and_si128(_mm_cmpgt_epi8(low, nine), letterOffset));
+        _mm_storeu_si128((__m128i *)(dst + 2 * i), _mm_unpacklo_epi8(high, low));
+        _mm_storeu_si128((__m128i *)(dst + 2 * i + 16), _mm_unpackhi_epi8(high, low));
+    }
+#endif
+    for (; i < length; ++i) {
+        dst[2 * i] = digits[src[i] >> 4];
+        dst[2 * i + 1] = digits[src[i] & 0x0F];
+    }
+}
+
+/// @brief Encodes the given bytes using the given alphabet.
+/// @returns The number of characters written.
+static int encodeBase64(const uint8_t *src, int length, char *dst, const char *alphabet, bool pad) noexcept {
+    char *start = dst;
+    int i = 0;
+    for (; i + 3 <= length; i += 3) {
+        uint32_t bits = (uint32_t)src[i] << 16 | (uint32_t)src[i + 1] << 8 | src[i + 2];
+        dst[0] = alphabet[bits >> 18];
+        dst[1] = alphabet[(bits >> 12) & 0x3F];
+        dst[2] = alphabet[(bits >> 6) & 0x3F];
+        dst[3] = alphabet[bits & 0x3F];
+        dst += 4;
+    }
+
+    int remaining = length - i;
+    if (remaining > 0) {
+        uint32_t bits = (uint32_t)src[i] << 16 | (remaining == 2 ? (uint32_t)src[i + 1] << 8 : 0);
+        *dst++ = alphabet[bits >> 18];
+        *dst++ = alphabet[(bits >> 12) & 0x3F];
+        if (remaining == 2) {
+            *dst++ = alphabet[(bits >> 6) & 0x3F];
+        }
+        if (pad) {
+            *dst++ = '=';
+            if (remaining == 1) {
+                *dst++ = '=';
+            }
+        }
+    }
+    return dst - start;
+}
+
+/// @brief Determines the number of bytes encoded by the given base64 data.
+/// @returns The number of bytes or -1 if the length is not well-formed.
+static int base64DecodedLength(const char *encoded, int length) noexcept {
+    if (length > 0 && length % 4 == 0 && encoded[length - 1] == '=') {
+        length -= encoded[length - 2] == '=' ? 2 : 1;
+    }
+    return length % 4 == 1 ? -1 : length / 4 * 3 + (length % 4 == 0 ? 0 : length % 4 - 1);
+}
+
+static bool decodeBase64Unchecked(const char *encoded, int decodedLength, uint8_t *dst) noexcept {
+    const int8_t *table = base64DecodeTable.values;
+    const uint8_t *src = (const uint8_t *)encoded;
+    int i = 0;
+    for (; i + 3 <= decodedLength; i += 3, src += 4) {
+        int32_t a = table[src[0]];
+        int32_t b = table[src[1]];
+        int32_t c = table[src[2]];
+        int32_t d = table[src[3]];
+        if ((a | b | c | d) < 0) {
+            return false;
+        }
+        uint32_t bits = a << 18 | b << 12 | c << 6 | d;
+        dst[i] = bits >> 16;
+        dst[i + 1] = bits >> 8;
+        dst[i + 2] = bits;
+    }
+
+    int remaining = decodedLength - i;
+    if (remaining > 0) {
+        int32_t a = table[src[0]];
+        int32_t b = table[src[1]];
+        int32_t c = remaining == 2 ? table[src[2]] : 0;
+        if ((a | b | c) < 0) {
+            return false;
+        }
+        uint32_t bits = a << 18 | b << 12 | c << 6;
+        dst[i] = bits >> 16;
+        if (remaining == 2) {
+            dst[i + 1] = bits >> 8;
+        }
+    }
+    return true;
+}
+
+static bool decodeHexUnchecked(const char *encoded, int decodedLength, uint8_t *dst) noexcept {
+    const int8_t *table = hexDecodeTable.values;
+    const uint8_t *src = (const uint8_t *)encoded;
+    for (int i = 0; i < decodedLength; ++i) {
+        int high = table[src[2 * i]];
+        int low = table[src[2 * i + 1]];
+        if ((high | low) < 0) {
+            return false;
+        }
+        dst[i] = high << 4 | low;
+    }
+    return true;
+}
+
+enum class Escaping {
+    C, JSON, URL
+};
+
+/// @brief Determines the length of the escape sequence of the given character, 1 if it is not escaped.
+static constexpr int escapedLength(Escaping escaping, uint8_t c) noexcept {
+    switch (escaping) {
+        case Escaping::C:
+            return c == '"' || c == '\\' || (c >= '\a' && c <= '\r') ? 2 : c < 0x20 || c >= 0x7F ? 4 : 1;
+        case Escaping::JSON:
+            return c == '"' || c == '\\' || c == '\b' || c == '\f' || c == '\n' || c == '\r' || c == '\t' ? 2
+                    : c < 0x20 ? 6 : 1;
+        default:
+            return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9')
+                   || c == '-' || c == '.' || c == '_' || c == '~' ? 1 : 3;
+    }
+}
+
+struct EscapedLengthTable {
+    uint8_t values[3][256];
+};
+
+static constexpr EscapedLengthTable escapedLengthTable = [] {
+    EscapedLengthTable table{};
+    for (int c = 0; c < 256; ++c) {
+        table.values[(int)Escaping::C][c] = escapedLength(Escaping::C, c);
+        table.values[(int)Escaping::JSON][c] = escapedLength(Escaping::JSON, c);
+        table.values[(int)Escaping::URL][c] = escapedLength(Escaping::URL, c);
+    }
+    return table;
+}();
+
+#ifdef __SSE2__
+/// @brief Determines which of the given characters are within [lo, hi].
+static inline __m128i inRange(__m128i chars, uint8_t lo, uint8_t hi) noexcept {
+    __m128i offset = _mm_sub_epi8(chars, _mm_set1_epi8(lo));
+    return _mm_cmpeq_epi8(_mm_min_epu8(offset, _mm_set1_epi8(hi - lo)), offset);
+}
+#endif
+
+/// @brief Finds the index of the first character at or after the given index that needs to be escaped.
+/// @returns The index or length if none.
+template<Escaping escaping>
+static int findEscaped(const uint8_t *s, int i, int length) noexcept {
+#ifdef __SSE2__
+    for (; i + 16 <= length; i += 16) {
+        __m128i chars = _mm_loadu_si128((const __m128i *)(s + i));
+        __m128i escaped;
+        if (escaping == Escaping::URL) {
+            __m128i unreserved = _mm_or_si128(
+                    _mm_or_si128(inRange(chars, 'a', 'z'), inRange(chars, 'A', 'Z')),
+                    _mm_or_si128(inRange(chars, '-', '9'), _mm_or_si128(
+                            _mm_cmpeq_epi8(chars, _mm_set1_epi8('_')), _mm_cmpeq_epi8(chars, _mm_set1_epi8('~')))));
+            // '/' is within the range '-' to '9'
+            escaped = _mm_or_si128(_mm_cmpeq_epi8(unreserved, _mm_setzero_si128()),
+                                   _mm_cmpeq_epi8(chars, _mm_set1_epi8('/')));
+        } else {
+            escaped = _mm_or_si128(_mm_or_si128(inRange(chars, 0, 0x1F), _mm_cmpeq_epi8(chars, _mm_set1_epi8('"'))),
+                                   _mm_cmpeq_epi8(chars, _mm_set1_epi8('\\')));
+            if (escaping == Escaping::C) {
+                escaped = _mm_or_si128(escaped, inRange(chars, 0x7F, 0xFF));
+            }
+        }
+
+        int mask = _mm_movemask_epi8(escaped);
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+#endif
+    const uint8_t *table = escapedLengthTable.values[(int)escaping];
+    while (i < length && table[s[i]] == 1) {
+        i++;
+    }
+    return i;
+}
+
+/// @brief Determines the length of the given string after escaping.
+/// @returns The length or -1 if it exceeds INT_MAX.
+template<Escaping escaping>
+static int measureEscaped(const std::string_view &str) noexcept {
+    const uint8_t *s = (const uint8_t *)str.data();
+    const uint8_t *table = escapedLengthTable.values[(int)escaping];
+    int length = str.length();
+    int64_t escapedLength = length;
+    for (int i = findEscaped<escaping>(s, 0, length); i < length; i = findEscaped<escaping>(s, i + 1, length)) {
+        escapedLength += table[s[i]] - 1;
+    }
+    return escapedLength > INT_MAX - 1 ? -1 : (int)escapedLength;
+}
+
+/// @brief Writes the given string escaped to the given destination, which provides enough space.
+/// @returns The end of the written string.
+template<Escaping escaping>
+static char *writeEscaped(const std::string_view &str, char *dst) noexcept {
+    static constexpr char upperDigits[] = "0123456789ABCDEF";
+    static constexpr char lowerDigits[] = "0123456789abcdef";
+    static constexpr char shortEscapes[] = "abtnvfr"; // \a = 7 to \r = 13
+
+    const uint8_t *s = (const uint8_t *)str.data();
+    int length = str.length();
+    for (int i = 0; i < length;) {
+        int next = findEscaped<escaping>(s, i, length);
+        memcpy(dst, s + i, next - i);
+        dst += next - i;
+        if (next == length) {
+            break;
+        }
+
+        uint8_t c = s[next];
+        int escapedLength = escapedLengthTable.values[(int)escaping][c];
+        if (escaping == Escaping::URL) {
+            dst[0] = '%';
+            dst[1] = upperDigits[c >> 4];
+            dst[2] = upperDigits[c & 0x0F];
+        } else if (escapedLength == 2) {
+            dst[0] = '\\';
+            dst[1] = c == '"' || c == '\\' ? c : shortEscapes[c - '\a'];
+        } else if (escaping == Escaping::JSON) {
+            memcpy(dst, "\\u00", 4);
+            dst[4] = lowerDigits[c >> 4];
+            dst[5] = lowerDigits[c & 0x0F];
+        } else {
+            dst[0] = '\\';
+            dst[1] = '0' + (c >> 6);
+            dst[2] = '0' + ((c >> 3) & 7);
+            dst[3] = '0' + (c & 7);
+        }
+        dst += escapedLength;
+        i = next + 1;
+    }
+    return dst;
+}
+
+/// @brief Determines the highest index <= limit that does not split a UTF-8 sequence.
+static int utf8Boundary(const char *data, int length, int limit) noexcept {
+    if (limit >= length) {
+        return length;
+    }
+
+    // a sequence has at most 3 continuation bytes
+    for (int i = 0; i < 3 && limit > 0 && ((uint8_t)data[limit] & 0xC0) == 0x80; ++i) {
+        limit--;
+    }
+    return limit;
+}
+
 int CString::length() const noexcept {
     if (!isAllocated()) {
         return -1;
@@ -10,6 +357,30 @@ int CString::length() const noexcept {
     return _lengthUnchecked();
 }
 
+int CString::codePointLength() const noexcept {
+    if (!isAllocated()) {
+        return -1;
+    }
+
+    const uint8_t *s = (const uint8_t*)_rawUnchecked();
+    int length = _lengthUnchecked();
+    int continuationBytes = 0;
+    int i = 0;
+
+    // continuation bytes are 10xxxxxx: count 8 bytes at a time
+    for (; i + 8 <= length; i += 8) {
+        uint64_t word;
+        memcpy(&word, s + i, sizeof(word));
+        uint64_t continuation = (word & ~(word << 1) & 0x8080808080808080ull) >> 7;
+        continuationBytes += (int)((continuation * 0x0101010101010101ull) >> 56);
+    }
+    for (; i < length; ++i) {
+        continuationBytes += (s[i] & 0xC0) == 0x80;
+    }
+
+    return length - continuationBytes;
+}
+
 uint8_t CString::bufferIndex() const noexcept {
     if (isInvalid()) {
         return INVALID_STRING_IDX;
@@ -17,6 +388,10 @@ uint8_t CString::bufferIndex() const noexcept {
     return _bufferIndexUnchecked();
 }
 
+bool CString::isInline() const noexcept {
+    return _isInline();
+}
+
 char* CString::raw() const noexcept {
     if (!isAllocated()) {
         return nullptr;
@@ -36,7 +411,8 @@ int CString::rawMaxLength() const noexcept {
 }
 
 bool CString::isAllocated() const noexcept {
-    return bufferIndex() != INVALID_STRING_IDX;
+    // small strings have no index, but content
+    return !isInvalid() && _buf->getRawString(*this) != nullptr;
 }
 
 bool CString::isEmpty() const noexcept {
@@ -55,11 +431,259 @@ bool CString::isInvalid() const noexcept {
     return _buf == nullptr || _handle == INVALID_STRING_IDX ;
 }
 
+bool CString::isValidUtf8() const noexcept {
+    return isAllocated() && isValidUtf8(_rawUnchecked(), _lengthUnchecked());
+}
+
+#if defined(__SSSE3__) || defined(CSTRING_UTF8_NEON)
+// error classes of two consecutive bytes, see Keiser, Lemire: "Validating UTF-8 In Less Than One Instruction Per
+// Byte". Each class is a bit: a pair is invalid if all three table lookups agree on a class.
+static constexpr uint8_t UTF8_TOO_SHORT = 1 << 0;
+static constexpr uint8_t UTF8_TOO_LONG = 1 << 1;
+static constexpr uint8_t UTF8_OVERLONG_3 = 1 << 2;
+static constexpr uint8_t UTF8_TOO_LARGE = 1 << 3;
+static constexpr uint8_t UTF8_SURROGATE = 1 << 4;
+static constexpr uint8_t UTF8_OVERLONG_2 = 1 << 5;
+static constexpr uint8_t UTF8_TOO_LARGE_1000 = 1 << 6;
+static constexpr uint8_t UTF8_OVERLONG_4 = 1 << 6;
+static constexpr uint8_t UTF8_TWO_CONTS = 1 << 7;
+static constexpr uint8_t UTF8_CARRY = UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTS;
+
+// indexed by the high nibble of the first byte
+alignas(16) static constexpr uint8_t utf8Byte1High[16] = {
+    UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+    UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+    UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS,
+    UTF8_TOO_SHORT | UTF8_OVERLONG_2,
+    UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE,
+    UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4
+};
+
+// indexed by the low nibble of the first byte
+alignas(16) static constexpr uint8_t utf8Byte1Low[16] = {
+    UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4,
+    UTF8_CARRY | UTF8_OVERLONG_2,
+    UTF8_CARRY,
+    UTF8_CARRY,
+    UTF8_CARRY | UTF8_TOO_LARGE,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_SURROGATE,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000
+};
+
+// indexed by the high nibble of the second byte
+alignas(16) static constexpr uint8_t utf8Byte2High[16] = {
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4,
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE,
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE,
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE,
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT
+};
+
+// lead bytes in the last three positions of a block that need more bytes than remain in the block
+alignas(16) static constexpr uint8_t utf8MaxComplete[16] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF
+};
+
+/// @brief Validates 16 byte blocks of the given data using SIMD lookup tables. Sequences crossing the end of the
+/// last block are not checked: validation continues at the returned index, which is the start of such a sequence or
+/// of the remaining bytes.
+/// @returns The index to continue validation or -1 if the data is invalid.
+static int validateUtf8Blocks(const uint8_t *s, int length) noexcept {
+    int i = 0;
+#ifdef __SSSE3__
+    const __m128i byte1High = _mm_load_si128((const __m128i *)utf8Byte1High);
+    const __m128i byte1Low = _mm_load_si128((const __m128i *)utf8Byte1Low);
+    const __m128i byte2High = _mm_load_si128((const __m128i *)utf8Byte2High);
+    const __m128i maxComplete = _mm_load_si128((const __m128i *)utf8MaxComplete);
+    const __m128i nibbleMask = _mm_set1_epi8(0x0F);
+    __m128i error = _mm_setzero_si128();
+    __m128i prevBlock = _mm_setzero_si128();
+    __m128i prevIncomplete = _mm_setzero_si128();
+    for (; i + 16 <= length; i += 16) {
+        // long ASCII runs: 32 bytes at a time
+        for (; i + 32 <= length; i += 32) {
+            __m128i next = _mm_loadu_si128((const __m128i *)(s + i + 16));
+            if (_mm_movemask_epi8(_mm_or_si128(_mm_loadu_si128((const __m128i *)(s + i)), next)) != 0) {
+                break;
+            }
+            error = _mm_or_si128(error, prevIncomplete);
+            prevBlock = next;
+            prevIncomplete = _mm_setzero_si128();
+        }
+        if (i + 16 > length) {
+            break;
+        }
+
+        __m128i block = _mm_loadu_si128((const __m128i *)(s + i));
+        if (_mm_movemask_epi8(block) == 0) {
+            // ASCII block: a sequence of the previous block must not be continued
+            error = _mm_or_si128(error, prevIncomplete);
+            prevBlock = block;
+            prevIncomplete = _mm_setzero_si128();
+            continue;
+        }
+
+        // classify each pair of the previous and the current byte
+        __m128i prev1 = _mm_alignr_epi8(block, prevBlock, 15);
+        __m128i specialCases = _mm_and_si128(
+                _mm_and_si128(_mm_shuffle_epi8(byte1High, _mm_and_si128(_mm_srli_epi16(prev1, 4), nibbleMask)),
+                              _mm_shuffle_epi8(byte1Low, _mm_and_si128(prev1, nibbleMask))),
+                _mm_shuffle_epi8(byte2High, _mm_and_si128(_mm_srli_epi16(block, 4), nibbleMask)));
+
+        // the third and fourth byte of 3 and 4 byte sequences must be continuations (TWO_CONTS) as well
+        __m128i prev2 = _mm_alignr_epi8(block, prevBlock, 14);
+        __m128i prev3 = _mm_alignr_epi8(block, prevBlock, 13);
+        __m128i mustBeContinuation = _mm_or_si128(_mm_subs_epu8(prev2, _mm_set1_epi8((char)(0xE0 - 0x80))),
+                                                  _mm_subs_epu8(prev3, _mm_set1_epi8((char)(0xF0 - 0x80))));
+        mustBeContinuation = _mm_and_si128(mustBeContinuation, _mm_set1_epi8((char)0x80));
+        error = _mm_or_si128(error, _mm_xor_si128(mustBeContinuation, specialCases));
+
+        prevBlock = block;
+        prevIncomplete = _mm_subs_epu8(block, maxComplete);
+    }
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) != 0xFFFF) {
+        return -1;
+    }
+#elif defined(CSTRING_UTF8_NEON)
+    const uint8x16_t byte1High = vld1q_u8(utf8Byte1High);
+    const uint8x16_t byte1Low = vld1q_u8(utf8Byte1Low);
+    const uint8x16_t byte2High = vld1q_u8(utf8Byte2High);
+    const uint8x16_t maxComplete = vld1q_u8(utf8MaxComplete);
+    const uint8x16_t nibbleMask = vdupq_n_u8(0x0F);
+    uint8x16_t error = vdupq_n_u8(0);
+    uint8x16_t prevBlock = vdupq_n_u8(0);
+    uint8x16_t prevIncomplete = vdupq_n_u8(0);
+    for (; i + 16 <= length; i += 16) {
+        // long ASCII runs: 32 bytes at a time
+        for (; i + 32 <= length; i += 32) {
+            uint8x16_t next = vld1q_u8(s + i + 16);
+            if (vmaxvq_u8(vorrq_u8(vld1q_u8(s + i), next)) >= 0x80) {
+                break;
+            }
+            error = vorrq_u8(error, prevIncomplete);
+            prevBlock = next;
+            prevIncomplete = vdupq_n_u8(0);
+        }
+        if (i + 16 > length) {
+            break;
+        }
+
+        uint8x16_t block = vld1q_u8(s + i);
+        if (vmaxvq_u8(block) < 0x80) {
+            // ASCII block: a sequence of the previous block must not be continued
+            error = vorrq_u8(error, prevIncomplete);
+            prevBlock = block;
+            prevIncomplete = vdupq_n_u8(0);
+            continue;
+        }
+
+        // classify each pair of the previous and the current byte
+        uint8x16_t prev1 = vextq_u8(prevBlock, block, 15);
+        uint8x16_t specialCases = vandq_u8(
+                vandq_u8(vqtbl1q_u8(byte1High, vshrq_n_u8(prev1, 4)), vqtbl1q_u8(byte1Low, vandq_u8(prev1, nibbleMask))),
+                vqtbl1q_u8(byte2High, vshrq_n_u8(block, 4)));
+
+        // the third and fourth byte of 3 and 4 byte sequences must be continuations (TWO_CONTS) as well
+        uint8x16_t prev2 = vextq_u8(prevBlock, block, 14);
+        uint8x16_t prev3 = vextq_u8(prevBlock, block, 13);
+        uint8x16_t mustBeContinuation = vorrq_u8(vqsubq_u8(prev2, vdupq_n_u8(0xE0 - 0x80)),
+                                                 vqsubq_u8(prev3, vdupq_n_u8(0xF0 - 0x80)));
+        mustBeContinuation = vandq_u8(mustBeContinuation, vdupq_n_u8(0x80));
+        error = vorrq_u8(error, veorq_u8(mustBeContinuation, specialCases));
+
+        prevBlock = block;
+        prevIncomplete = vqsubq_u8(block, maxComplete);
+    }
+    if (vmaxvq_u8(error) != 0) {
+        return -1;
+    }
+#endif
+
+    // restart at a lead byte within the last 3 bytes if its sequence continues beyond the validated blocks
+    for (int back = 1; back <= 3 && i - back >= 0; ++back) {
+        uint8_t c = s[i - back];
+        if (c >= 0xC0) {
+            int sequenceLength = c >= 0xF0 ? 4 : c >= 0xE0 ? 3 : 2;
+            return sequenceLength > back ? i - back : i;
+        }
+    }
+    return i;
+}
+#endif
+
+bool CString::isValidUtf8(const char *data, int length) noexcept {
+    if (data == nullptr || length < 0) {
+        return false;
+    }
+
+    const uint8_t *s = (const uint8_t*)data;
+#if defined(__SSSE3__) || defined(CSTRING_UTF8_NEON)
+    int start = validateUtf8Blocks(s, length);
+    if (start < 0) {
+        return false;
+    }
+#else
+    int start = 0;
+#endif
+    for (int i = start; i < length;) {
+        // ASCII fast path: 16 bytes at a time within long runs, 8 bytes at a time between multi-byte sequences
+        for (; i + 16 <= length; i += 16) {
+            uint64_t word1;
+            uint64_t word2;
+            memcpy(&word1, s + i, sizeof(word1));
+            memcpy(&word2, s + i + 8, sizeof(word2));
+            if (((word1 | word2) & 0x8080808080808080ull) != 0) {
+                break;
+            }
+        }
+        if (i + 8 <= length) {
+            uint64_t word;
+            memcpy(&word, s + i, sizeof(word));
+            if ((word & 0x8080808080808080ull) == 0) {
+                i += 8;
+                continue;
+            }
+        }
+
+        if (i == length) {
+            break;
+        }
+        if (s[i] < 0x80) {
+            i++;
+            continue;
+        }
+        char32_t codePoint;
+        int sequenceLength = decodeUtf8(s + i, length - i, codePoint);
+        if (sequenceLength == 0) {
+            return false;
+        }
+        i += sequenceLength;
+    }
+
+    return true;
+}
+
 CString &CString::append(const char c) noexcept {
     return append(&c, 1);
 }
 
 CString& CString::append(const CString &other) noexcept {
+    if (other._buf == _buf && other.isAllocated()) {
+        // moving the current string to the top relocates other: resolve it after resizing
+        return append(other.slice(0, other.length()));
+    }
     return append(other.raw(), other.rawCapacity());
 }
 
@@ -72,7 +696,7 @@ CString& CString::append(const char *string) noexcept {
 }
 
 CString& CString::append(const char *string, int limit) noexcept {
-    if (!isAllocated()) {
+    if (!isAllocated() || !_unshare()) {
         return INVALID;
     }
 
@@ -85,7 +709,7 @@ CString& CString::append(const char *string, int limit) noexcept {
         const char* src = string;
         char *selfRaw = _rawUnchecked();
         char *dst = selfRaw + len;
-        char *end = selfRaw + maxCopy;
+        char *end = dst + maxCopy;
 
         for (;dst < end; ++src, ++dst) {
             *dst = *src;
@@ -97,7 +721,7 @@ CString& CString::append(const char *string, int limit) noexcept {
 
         *dst = '\0'; // ensure \0 at end
         int copied = src - string;
-        if (*src == '\0' || copied == limit) {
+        if (copied == limit || *src == '\0') {
             return *this;
         }
 
@@ -112,6 +736,26 @@ CString& CString::append(const char *string, int limit) noexcept {
     return *this;
 }
 
+CString &CString::append(const CStringSlice &slice) noexcept {
+    int sliceLength = slice.length();
+    if (!isAllocated() || sliceLength < 0 || !_unshare()) {
+        return INVALID;
+    }
+
+    int selfLength = _lengthUnchecked();
+    if (selfLength + sliceLength > _rawMaxLengthUnchecked() && resize(selfLength + sliceLength).isInvalid()) {
+        return INVALID;
+    }
+
+    // resolve slice after resize: content might have been relocated
+    // note: slice might refer to the current string => memmove
+    char *dst = _rawUnchecked() + selfLength;
+    memmove(dst, slice.raw(), sliceLength);
+    dst[sliceLength] = '\0';
+
+    return *this;
+}
+
 CString &CString::appendFormat(const char *format, ...) noexcept {
     va_list args;
     va_start(args, format);
@@ -119,7 +763,7 @@ CString &CString::appendFormat(const char *format, ...) noexcept {
 }
 
 CString &CString::appendFormatV(const char *format, va_list args) noexcept {
-    if (!isAllocated()) {
+    if (!isAllocated() || !_unshare()) {
         return INVALID;
     }
 
@@ -130,14 +774,19 @@ CString &CString::appendFormatV(const char *format, va_list args) noexcept {
         int maxSizeIncludingNull = initialMaxLen - len + 1;
         char *dst = _rawUnchecked()+len;
 
-        int requiredLengthExcludingNull = vsnprintf(dst, maxSizeIncludingNull, format, args);
+        // args are needed again if the string does not fit
+        va_list argsCopy;
+        va_copy(argsCopy, args);
+        int requiredLengthExcludingNull = vsnprintf(dst, maxSizeIncludingNull, format, argsCopy);
+        va_end(argsCopy);
         if (requiredLengthExcludingNull < maxSizeIncludingNull) {
             return *this;
         }
 
         *dst = '\0';
 
-        if (requiredLengthExcludingNull + 1 - maxSizeIncludingNull > _buf->unallocatedBytes()) {
+        if (requiredLengthExcludingNull + 1 - maxSizeIncludingNull > _buf->unallocatedBytes()
+            || (_isInline() && requiredLengthExcludingNull > _appendLimit())) {
             return INVALID;
         }
     }
@@ -150,7 +799,7 @@ CString &CString::appendFormatV(const char *format, va_list args) noexcept {
 }
 
 CString &CString::appendMost(const char c) noexcept {
-    if (!isAllocated() || _buf->unallocatedBytes() == 0) {
+    if (!isAllocated() || _appendLimit() == 0) {
         return *this;
     }
 
@@ -161,28 +810,28 @@ CString &CString::appendMost(const CString &other) noexcept {
     if (!isAllocated() || !other.isAllocated()) {
         return *this;
     }
-    return append(other._rawUnchecked(), std::min(_buf->unallocatedBytes(), other.length()));
+    return append(other._rawUnchecked(), std::min(_appendLimit(), other.length()));
 }
 
 CString &CString::appendMost(const std::string_view &other) noexcept {
     if (!isAllocated()) {
         return *this;
     }
-    return append(other.data(), std::min(_buf->unallocatedBytes(), (int)other.length()));
+    return append(other.data(), std::min(_appendLimit(), (int)other.length()));
 }
 
 CString &CString::appendMost(const char *string) noexcept {
     if (!isAllocated()) {
         return *this;
     }
-    return append(string, _buf->unallocatedBytes());
+    return append(string, _appendLimit());
 }
 
 CString &CString::appendMost(const char *string, int limit) noexcept {
     if (!isAllocated()) {
         return *this;
     }
-    return append(string, std::min(_buf->unallocatedBytes(), limit));
+    return append(string, std::min(_appendLimit(), limit));
 }
 
 CString &CString::appendMostFormat(const char *format, ...) noexcept {
@@ -192,7 +841,7 @@ CString &CString::appendMostFormat(const char *format, ...) noexcept {
 }
 
 CString &CString::appendMostFormatV(const char *format, va_list args) noexcept {
-    if (!isAllocated()) {
+    if (!isAllocated() || !_unshare()) {
         return INVALID;
     }
 
@@ -216,10 +865,207 @@ CString &CString::appendMostFormatV(const char *format, va_list args) noexcept {
     return *this;
 }
 
+CString &CString::appendMostUtf8(const std::string_view &other) noexcept {
+    if (!isAllocated()) {
+        return *this;
+    }
+
+    int otherLength = other.length();
+    return append(other.data(), utf8Boundary(other.data(), otherLength, std::min(_appendLimit(), otherLength)));
+}
+
+CString &CString::appendMostUtf8(const char *string) noexcept {
+    if (!isAllocated() || string == nullptr) {
+        return *this;
+    }
+
+    // string[limit] is either part of the string or its terminating \0
+    int limit = strnlen(string, _appendLimit());
+    return append(string, utf8Boundary(string, limit + (string[limit] != '\0'), limit));
+}
+
+CString &CString::appendBase64(const uint8_t *data, int length) noexcept {
+    if (length < 0 || (data == nullptr && length > 0) || length > INT_MAX / 4 * 3 - 3) {
+        return INVALID;
+    }
+
+    char *dst = _reserveAppend((length + 2) / 3 * 4);
+    if (dst == nullptr) {
+        return INVALID;
+    }
+    dst[encodeBase64(data, length, dst, base64Alphabet, true)] = '\0';
+    return *this;
+}
+
+CString &CString::appendBase64Decoded(const std::string_view &encoded) noexcept {
+    int decodedLength = base64DecodedLength(encoded.data(), encoded.length());
+    if (decodedLength < 0) {
+        return INVALID;
+    }
+
+    if (_appendRelocates(decodedLength)) {
+        // encoded may refer to a buffer area relocated by resizing: decode into a temporary string on top first
+        CString decoded = _buf->allocate(decodedLength);
+        bool isDecoded = !decoded.appendBase64Decoded(encoded).isInvalid() && !append(decoded).isInvalid();
+        decoded.deallocate();
+        return isDecoded ? *this : INVALID;
+    }
+
+    char *dst = _reserveAppend(decodedLength);
+    if (dst == nullptr) {
+        return INVALID;
+    }
+    if (!decodeBase64Unchecked(encoded.data(), decodedLength, (uint8_t *)dst)
+        || memchr(dst, '\0', decodedLength) != nullptr) {
+        *dst = '\0';
+        return INVALID;
+    }
+    dst[decodedLength] = '\0';
+    return *this;
+}
+
+CString &CString::appendBase64Url(const uint8_t *data, int length) noexcept {
+    if (length < 0 || (data == nullptr && length > 0) || length > INT_MAX / 4 * 3 - 3) {
+        return INVALID;
+    }
+
+    char *dst = _reserveAppend((int)(((int64_t)length * 4 + 2) / 3));
+    if (dst == nullptr) {
+        return INVALID;
+    }
+    dst[encodeBase64(data, length, dst, base64UrlAlphabet, false)] = '\0';
+    return *this;
+}
+
+CString &CString::appendCEscaped(const std::string_view &str) noexcept {
+    int escapedLength = measureEscaped<Escaping::C>(str);
+    char *dst = escapedLength < 0 ? nullptr : _reserveAppend(escapedLength);
+    if (dst == nullptr) {
+        return INVALID;
+    }
+    *writeEscaped<Escaping::C>(str, dst) = '\0';
+    return *this;
+}
+
+CString &CString::appendHex(const uint8_t *data, int length, bool upperCase) noexcept {
+    if (length < 0 || (data == nullptr && length > 0) || length > INT_MAX / 2) {
+        return INVALID;
+    }
+
+    char *dst = _reserveAppend(2 * length);
+    if (dst == nullptr) {
+        return INVALID;
+    }
+    encodeHex(data, length, dst, upperCase);
+    dst[2 * length] = '\0';
+    return *this;
+}
+
+CString &CString::appendHexDecoded(const std::string_view &encoded) noexcept {
+    if (encoded.length() % 2 != 0) {
+        return INVALID;
+    }
+
+    int decodedLength = encoded.length() / 2;
+    if (_appendRelocates(decodedLength)) {
+        // encoded may refer to a buffer area relocated by resizing: decode into a temporary string on top first
+        CString decoded = _buf->allocate(decodedLength);
+        bool isDecoded = !decoded.appendHexDecoded(encoded).isInvalid() && !append(decoded).isInvalid();
+        decoded.deallocate();
+        return isDecoded ? *this : INVALID;
+    }
+
+    char *dst = _reserveAppend(decodedLength);
+    if (dst == nullptr) {
+        return INVALID;
+    }
+    if (!decodeHexUnchecked(encoded.data(), decodedLength, (uint8_t *)dst)
+        || memchr(dst, '\0', decodedLength) != nullptr) {
+        *dst = '\0';
+        return INVALID;
+    }
+    dst[decodedLength] = '\0';
+    return *this;
+}
+
+CString &CString::appendJsonEscaped(const std::string_view &str) noexcept {
+    int escapedLength = measureEscaped<Escaping::JSON>(str);
+    char *dst = escapedLength < 0 ? nullptr : _reserveAppend(escapedLength);
+    if (dst == nullptr) {
+        return INVALID;
+    }
+    *writeEscaped<Escaping::JSON>(str, dst) = '\0';
+    return *this;
+}
+
+CString &CString::appendUrlEncoded(const std::string_view &str) noexcept {
+    int escapedLength = measureEscaped<Escaping::URL>(str);
+    char *dst = escapedLength < 0 ? nullptr : _reserveAppend(escapedLength);
+    if (dst == nullptr) {
+        return INVALID;
+    }
+    *writeEscaped<Escaping::URL>(str, dst) = '\0';
+    return *this;
+}
+
+CString &CString::appendJoin(const CString *strings, int count, const char *delimiter) noexcept {
+    if (!isAllocated() || count < 0 || (strings == nullptr && count > 0) || !_unshare()) {
+        return INVALID;
+    }
+
+    int delimiterLength = delimiter == nullptr ? 0 : strlen(delimiter);
+    int selfLength = _lengthUnchecked();
+    if (selfLength < 0) {
+        return INVALID;
+    }
+
+    // first pass: determine total length, such that the buffer area needs to be resized at most once
+    int joinedLength = count > 0 ? (count - 1) * delimiterLength : 0;
+    for (int i = 0; i < count; ++i) {
+        const CString &cur = strings[i];
+        int curLength = cur._buf == _buf && cur._handle == _handle ? selfLength : cur.length();
+        if (curLength < 0) {
+            return INVALID;
+        }
+        joinedLength += curLength;
+    }
+
+    if (selfLength + joinedLength > _rawMaxLengthUnchecked() && resize(selfLength + joinedLength).isInvalid()) {
+        return INVALID;
+    }
+
+    // second pass: resizing might have relocated any string of this buffer
+    // => resolve raw pointers again after resize, never before
+    char *self = _rawUnchecked();
+    char *dst = self + selfLength;
+    for (int i = 0; i < count; ++i) {
+        const CString &cur = strings[i];
+        if (i > 0 && delimiterLength > 0) {
+            memcpy(dst, delimiter, delimiterLength);
+            dst += delimiterLength;
+        }
+
+        // content of this string has not been changed before selfLength => copy from there
+        bool isSelf = cur._buf == _buf && cur._handle == _handle;
+        int curLength = isSelf ? selfLength : cur._lengthUnchecked();
+        memcpy(dst, isSelf ? self : cur._rawUnchecked(), curLength);
+        dst += curLength;
+    }
+    *dst = '\0';
+
+    return *this;
+}
+
 CString &CString::clear() noexcept {
     if (!isAllocated()) {
         return INVALID;
     }
+    if (_rawUnchecked()[0] == '\0') {
+        return *this;
+    }
+    if (!_unshare()) {
+        return INVALID;
+    }
 
     _rawUnchecked()[0] = '\0';
     return *this;
@@ -229,14 +1075,14 @@ CString CString::clone() const noexcept {
     if (!isAllocated()) {
         return INVALID;
     }
-    return _buf->push(_rawUnchecked());
+    return _pushCopy(_rawUnchecked(), INT_MAX);
 }
 
 CString CString::clone(int startIndex) const noexcept {
     if (!isAllocated() || startIndex < 0 || startIndex >= _rawCapacityUnchecked()) {
         return INVALID;
     }
-    return _buf->push(_rawUnchecked() + startIndex, _rawCapacityUnchecked() - startIndex);
+    return _pushCopy(_rawUnchecked() + startIndex, _rawCapacityUnchecked() - startIndex);
 }
 
 CString CString::clone(int startIndex, int length) const noexcept {
@@ -254,7 +1100,36 @@ CString CString::cloneWithLimit(int startIndex, int limit) const noexcept {
     if (!isAllocated() || startIndex < 0 || limit < 0 || startIndex >= _rawCapacityUnchecked()) {
         return INVALID;
     }
-    return _buf->push(_rawUnchecked() + startIndex, limit);
+    return _pushCopy(_rawUnchecked() + startIndex, limit);
+}
+
+CString CString::cloneWithLimitUtf8(int limit) const noexcept {
+    return cloneWithLimitUtf8(0, limit);
+}
+
+CString CString::cloneWithLimitUtf8(int startIndex, int limit) const noexcept {
+    if (!isAllocated() || startIndex < 0 || limit < 0 || startIndex >= _rawCapacityUnchecked()) {
+        return INVALID;
+    }
+
+    const char *start = _rawUnchecked() + startIndex;
+    int length = strnlen(start, _rawCapacityUnchecked() - startIndex);
+    return _pushCopy(start, utf8Boundary(start, length, limit));
+}
+
+CString CString::cloneShared() const noexcept {
+    if (!isAllocated()) {
+        return INVALID;
+    }
+    return _buf->share(*this);
+}
+
+CStringCodePointIterator CString::codePoints(int startIndex) const noexcept {
+    int len = length();
+    if (len < 0 || startIndex < 0 || startIndex > len) {
+        return CStringCodePointIterator(nullptr, 0, 0);
+    }
+    return CStringCodePointIterator(_rawUnchecked(), len, startIndex);
 }
 
 int CString::compare(const char *other) const noexcept {
@@ -318,7 +1193,45 @@ int CString::compare(const CString &other) const noexcept {
         return 1;
     }
 
-    return compare(other._rawUnchecked(), other._rawCapacityUnchecked());
+    return compare(other._rawUnchecked(), other._lengthUnchecked());
+}
+
+int CString::compare(const CStringSlice &other) const noexcept {
+    return compare(other.raw(), other.length());
+}
+
+int CString::decodeBase64(uint8_t *dst, int dstCapacity) const noexcept {
+    int len = length();
+    return len < 0 ? -1 : decodeBase64(_rawUnchecked(), len, dst, dstCapacity);
+}
+
+int CString::decodeBase64(const char *encoded, int length, uint8_t *dst, int dstCapacity) noexcept {
+    if (encoded == nullptr || length < 0 || dst == nullptr) {
+        return -1;
+    }
+
+    int decodedLength = base64DecodedLength(encoded, length);
+    if (decodedLength < 0 || decodedLength > dstCapacity || !decodeBase64Unchecked(encoded, decodedLength, dst)) {
+        return -1;
+    }
+    return decodedLength;
+}
+
+int CString::decodeHex(uint8_t *dst, int dstCapacity) const noexcept {
+    int len = length();
+    return len < 0 ? -1 : decodeHex(_rawUnchecked(), len, dst, dstCapacity);
+}
+
+int CString::decodeHex(const char *encoded, int length, uint8_t *dst, int dstCapacity) noexcept {
+    if (encoded == nullptr || length < 0 || length % 2 != 0 || dst == nullptr) {
+        return -1;
+    }
+
+    int decodedLength = length / 2;
+    if (decodedLength > dstCapacity || !decodeHexUnchecked(encoded, decodedLength, dst)) {
+        return -1;
+    }
+    return decodedLength;
 }
 
 bool CString::endsWith(const char c) const noexcept {
@@ -349,6 +1262,22 @@ bool CString::endsWith(const CString &str) const noexcept {
     return endsWith(str.raw());
 }
 
+bool CString::endsWith(const CStringSlice &str) const noexcept {
+    const char *rawStr = str.raw();
+    if (rawStr == nullptr) {
+        return false;
+    }
+    return endsWith(rawStr, str.length());
+}
+
+uint64_t CString::hash() const noexcept {
+    int len = length();
+    if (len < 0) {
+        return 0;
+    }
+    return hash(_rawUnchecked(), len);
+}
+
 int CString::indexOf(const char c, int startIndex) const noexcept {
     char anyOf[2] {c, '\0'};
     return indexOfAny(anyOf, startIndex);
@@ -381,6 +1310,14 @@ int CString::indexOf(const CString &str, int startIndex) const noexcept {
     return indexOf(str._rawUnchecked(), startIndex, strLen);
 }
 
+int CString::indexOf(const CStringSlice &str, int startIndex) const noexcept {
+    const char *rawStr = str.raw();
+    if (rawStr == nullptr) {
+        return -1;
+    }
+    return indexOf(rawStr, startIndex, str.length());
+}
+
 int CString::indexOfAny(const char *chars, int startIndex) const noexcept {
     return indexOfAny(chars, startIndex, strlen(chars));
 }
@@ -497,6 +1434,11 @@ int CString::lastIndexOfAny(std::function<bool(const char)> predicate, int start
 }
 
 CString& CString::resize(int maxLength) noexcept {
+    if (_isInline() && maxLength >= 0 && maxLength <= INLINE_MAX_LENGTH) {
+        // the inline capacity is fixed
+        _rawUnchecked()[maxLength] = '\0';
+        return *this;
+    }
     if (maxLength < 0 || !_moveToTop().isAllocated() || _buf->resizeTopmost(maxLength).isInvalid()) {
         return INVALID;
     }
@@ -504,12 +1446,27 @@ CString& CString::resize(int maxLength) noexcept {
     return *this;
 }
 
+CString& CString::resizeUtf8(int maxLength) noexcept {
+    if (maxLength < 0 || !isAllocated()) {
+        return INVALID;
+    }
+
+    // boundary must be determined before truncation: resize overwrites the byte at maxLength
+    int boundary = utf8Boundary(_rawUnchecked(), _lengthUnchecked(), maxLength);
+    if (resize(maxLength).isInvalid()) {
+        return INVALID;
+    }
+
+    _rawUnchecked()[boundary] = '\0';
+    return *this;
+}
+
 CString& CString::shrinkToFit() noexcept {
     return resize(length());
 }
 
 CString &CString::substring(int startIndex) noexcept {
-    return substring(startIndex, rawCapacity() - startIndex);
+    return substring(startIndex, rawMaxLength() - startIndex);
 }
 
 CString &CString::substring(int startIndex, int length) noexcept {
@@ -517,12 +1474,32 @@ CString &CString::substring(int startIndex, int length) noexcept {
         return INVALID;
     }
 
+    // a shared buffer area is copied only if the content changes
     char *self = _rawUnchecked();
+    if (startIndex == 0 && length < _rawCapacityUnchecked() && self[length] == '\0') {
+        return *this;
+    }
+    if (!_unshare()) {
+        return INVALID;
+    }
+
+    self = _rawUnchecked();
     memmove(self, self+startIndex, length);
     self[length] = '\0';
     return *this;
 }
 
+CStringSlice CString::slice(int startIndex) const noexcept {
+    return slice(startIndex, length() - startIndex);
+}
+
+CStringSlice CString::slice(int startIndex, int length) const noexcept {
+    if (!isAllocated() || startIndex < 0 || length < 0 || startIndex + length > _rawCapacityUnchecked()) {
+        return CStringSlice();
+    }
+    return CStringSlice(*this, startIndex, length);
+}
+
 bool CString::startsWith(const char c) const noexcept {
     if (!isAllocated() || _rawCapacityUnchecked() < 1) {
         return false;
@@ -547,6 +1524,14 @@ bool CString::startsWith(const CString &str) const noexcept {
     return startsWith(str.raw());
 }
 
+bool CString::startsWith(const CStringSlice &str) const noexcept {
+    const char *rawStr = str.raw();
+    if (rawStr == nullptr) {
+        return false;
+    }
+    return startsWith(rawStr, str.length());
+}
+
 CString& CString::toLower() noexcept {
     if (!isAllocated()) {
         return INVALID;
@@ -554,9 +1539,18 @@ CString& CString::toLower() noexcept {
 
     int count = 0;
     int maxCount = _rawCapacityUnchecked();
+    bool isUnshared = false;
 
     for (char* cur = _rawUnchecked(); *cur != '\0' && count < maxCount; ++cur, ++count) {
         if (*cur >= 'A' && *cur <= 'Z') {
+            // shared content is copied on the first change
+            if (!isUnshared) {
+                if (!_unshare()) {
+                    return INVALID;
+                }
+                isUnshared = true;
+                cur = _rawUnchecked() + count;
+            }
             *cur += 32;
         }
     }
@@ -571,9 +1565,18 @@ CString& CString::toUpper() noexcept {
 
     int count = 0;
     int maxCount = _rawCapacityUnchecked();
+    bool isUnshared = false;
 
     for (char* cur = _rawUnchecked(); *cur != '\0' && count < maxCount; ++cur, ++count) {
         if (*cur >= 'a' && *cur <= 'z') {
+            // shared content is copied on the first change
+            if (!isUnshared) {
+                if (!_unshare()) {
+                    return INVALID;
+                }
+                isUnshared = true;
+                cur = _rawUnchecked() + count;
+            }
             *cur -= 32;
         }
     }
@@ -581,18 +1584,111 @@ CString& CString::toUpper() noexcept {
     return *this;
 }
 
+CString &CString::urlDecode(bool plusAsSpace) noexcept {
+    if (!isAllocated() || !_unshare()) {
+        return INVALID;
+    }
+
+    char *self = _rawUnchecked();
+    int length = _lengthUnchecked();
+    const char *end = self + length;
+    const int8_t *hex = hexDecodeTable.values;
+
+    // first pass: validate, such that the content remains unchanged if not well-formed
+    for (const char *c = (const char*)memchr(self, '%', length); c != nullptr;
+         c = (const char*)memchr(c + 3, '%', end - c - 3)) {
+        if (end - c < 3 || (hex[(uint8_t)c[1]] | hex[(uint8_t)c[2]]) < 0 || (c[1] == '0' && c[2] == '0')) {
+            return INVALID;
+        }
+    }
+
+    // second pass: runs without escapes are moved as a whole
+    const char *escapes = plusAsSpace ? "%+" : "%";
+    const char *src = self;
+    char *dst = self;
+    while (src < end) {
+        int run = strcspn(src, escapes);
+        if (dst != src) {
+            memmove(dst, src, run);
+        }
+        src += run;
+        dst += run;
+        if (src == end) {
+            break;
+        }
+
+        if (*src == '+') {
+            *dst++ = ' ';
+            src++;
+        } else {
+            *dst++ = (char)(hex[(uint8_t)src[1]] << 4 | hex[(uint8_t)src[2]]);
+            src += 3;
+        }
+    }
+    *dst = '\0';
+
+    return *this;
+}
+
 CString& CString::_moveToTop() noexcept {
     if (!isAllocated()) {
         return INVALID;
     }
 
-    if (!_buf->moveToTop(*this)) {
+    if (_isInline()) {
+        // spill: the new buffer area is the topmost one
+        return _buf->spill(*this) ? *this : INVALID;
+    }
+
+    if (!_unshare() || !_buf->moveToTop(*this)) {
         return INVALID;
     }
 
     return *this;
 }
 
+bool CString::_unshare() noexcept {
+    return _buf->unshare(*this);
+}
+
+int CString::_appendLimit() const noexcept {
+    if (!_isInline()) {
+        return _buf->unallocatedBytes();
+    }
+    int length = _lengthUnchecked();
+    return std::max(INLINE_MAX_LENGTH - length, _buf->unallocatedBytes() - length - 1);
+}
+
+CString CString::_pushCopy(const char *string, int limit) const noexcept {
+    return _isInline() ? _buf->pushSmall(string, limit) : _buf->push(string, limit);
+}
+
+bool CString::_appendRelocates(int appendLength) const noexcept {
+    if (!isAllocated() || _isInline()) {
+        return false;
+    }
+    int selfLength = _lengthUnchecked();
+    return selfLength >= 0 && appendLength > _rawMaxLengthUnchecked() - selfLength
+           && _bufferIndexUnchecked() != _buf->numstrings() - 1;
+}
+
+char *CString::_reserveAppend(int appendLength) noexcept {
+    if (!isAllocated()) {
+        return nullptr;
+    }
+
+    int selfLength = _lengthUnchecked();
+    if (selfLength < 0 || appendLength > INT_MAX - 1 - selfLength || !_unshare()) {
+        return nullptr;
+    }
+    if (selfLength + appendLength > _rawMaxLengthUnchecked() && resize(selfLength + appendLength).isInvalid()) {
+        return nullptr;
+    }
+
+    // resolve after resize: content might have been relocated
+    return _rawUnchecked() + selfLength;
+}
+
 CString &CString::trim() noexcept {
     return trim(isspace);
 }
@@ -647,7 +1743,7 @@ CString &CString::trimStart(std::function<bool(char)> isCharToRemove) noexcept {
 
     char *s = _rawUnchecked();
     char *c = s;
-    char *e = s + _rawCapacityUnchecked();
+    char *e = s + _lengthUnchecked();
 
     while (c < e && isCharToRemove(*c)) {
         c++;
@@ -681,6 +1777,12 @@ CString &CString::trimEnd(const char *chars, int charsLengthExcludingNull) noexc
     if (endIndex == std::string_view::npos) {
         return clear();
     }
+    if ((int)endIndex + 1 == len) {
+        return *this;
+    }
+    if (!_unshare()) {
+        return INVALID;
+    }
 
     _rawUnchecked()[endIndex + 1] = '\0';
     return *this;
@@ -692,9 +1794,21 @@ CString &CString::trimEnd(std::function<bool(char)> isCharToRemove) noexcept {
     }
 
     char *s = _rawUnchecked();
-    for (char *c = s + _lengthUnchecked() - 1; c >= s && isCharToRemove(*c); --c) {
-        *c = '\0';
+    char *c = s + _lengthUnchecked() - 1;
+    while (c >= s && isCharToRemove(*c)) {
+        --c;
+    }
+
+    int endIndex = c - s + 1;
+    if (s[endIndex] == '\0') {
+        return *this;
     }
+    if (!_unshare()) {
+        return INVALID;
+    }
+
+    s = _rawUnchecked();
+    memset(s + endIndex, '\0', _lengthUnchecked() - endIndex);
     return *this;
 }
 
@@ -702,7 +1816,6 @@ CString &CString::deallocate() noexcept {
     if (_buf == nullptr) {
         return *this;
     }
-
     if (!_buf->remove(*this)) {
         return INVALID;
     }
@@ -778,8 +1891,16 @@ bool CString::operator!=(const std::string_view &str) const noexcept {
     return compare(str.data(), str.length()) != 0;
 }
 
+bool CString::operator==(const CStringSlice &str) const noexcept {
+    return compare(str) == 0;
+}
+
+bool CString::operator!=(const CStringSlice &str) const noexcept {
+    return compare(str) != 0;
+}
+
 char& CString::operator[](int index) noexcept {
-    if (!isAllocated() || index < 0 || index > _rawMaxLengthUnchecked()) {
+    if (!isAllocated() || index < 0 || index > _rawMaxLengthUnchecked() || !_unshare()) {
         static char NULLBUF;
         NULLBUF = '\0';
         return NULLBUF;
@@ -791,6 +1912,22 @@ CString::operator const std::string_view() const noexcept {
     return asStringView();
 }
 
+CString CStringBufferBase::share(const CString &cstring) noexcept {
+    return cstring.clone();
+}
+
+bool CStringBufferBase::unshare(const CString &) noexcept {
+    return true;
+}
+
+CString CStringBufferBase::pushSmall(const char *string, int limit) noexcept {
+    return push(string, limit);
+}
+
+bool CStringBufferBase::spill(const CString &) noexcept {
+    return false;
+}
+
 int CString::_lengthUnchecked() const noexcept {
     char* self = _rawUnchecked();
     char* end = (char*)memchr(self, '\0', _rawCapacityUnchecked());
@@ -802,6 +1939,10 @@ int CString::_lengthUnchecked() const noexcept {
     return end - self;
 }
 
+bool CString::_isInline() const noexcept {
+    return !isInvalid() && _buf->getIndex(*this) == INVALID_STRING_IDX && _buf->getRawString(*this) != nullptr;
+}
+
 int CString::_bufferIndexUnchecked() const noexcept {
     return _buf->getIndex(*this);
 }
@@ -817,3 +1958,199 @@ int CString::_rawCapacityUnchecked() const noexcept {
 int CString::_rawMaxLengthUnchecked() const noexcept {
     return std::max(0, _rawCapacityUnchecked() - 1);
 }
+
+const CString &CStringSlice::string() const noexcept {
+    return _string;
+}
+
+int CStringSlice::startIndex() const noexcept {
+    return _startIndex;
+}
+
+int CStringSlice::length() const noexcept {
+    if (isInvalid()) {
+        return -1;
+    }
+    return _length;
+}
+
+const char *CStringSlice::raw() const noexcept {
+    if (isInvalid()) {
+        return nullptr;
+    }
+    return _string._rawUnchecked() + _startIndex;
+}
+
+bool CStringSlice::isInvalid() const noexcept {
+    return !_string.isAllocated() || _startIndex + _length > _string._rawCapacityUnchecked();
+}
+
+bool CStringSlice::isEmpty() const noexcept {
+    return !isInvalid() && _length == 0;
+}
+
+CStringSlice CStringSlice::slice(int startIndex, int length) const noexcept {
+    if (isInvalid() || startIndex < 0 || length < 0 || startIndex + length > _length) {
+        return CStringSlice();
+    }
+    return CStringSlice(_string, _startIndex + startIndex, length);
+}
+
+CString CStringSlice::clone() const noexcept {
+    if (isInvalid()) {
+        return CString::INVALID;
+    }
+    return _string.cloneWithLimit(_startIndex, _length);
+}
+
+int CStringSlice::compare(const char *other) const noexcept {
+    if (other == nullptr) {
+        return isInvalid() ? 0 : 1;
+    }
+    return compare(other, strlen(other));
+}
+
+int CStringSlice::compare(const char *other, int otherLengthExcludingNull) const noexcept {
+    const char *rawSelf = raw();
+    if (rawSelf == other) {
+        return 0;
+    }
+
+    if (rawSelf == nullptr) {
+        return -1;
+    }
+    if (other == nullptr) {
+        return 1;
+    }
+
+    if (_length < otherLengthExcludingNull) {
+        return -1;
+    } else if (_length > otherLengthExcludingNull) {
+        return 1;
+    }
+
+    return memcmp(rawSelf, other, _length);
+}
+
+int CStringSlice::compare(const CStringSlice &other) const noexcept {
+    return compare(other.raw(), other.length());
+}
+
+bool CStringSlice::startsWith(const char *str) const noexcept {
+    if (str == nullptr) {
+        return false;
+    }
+    return startsWith(str, strlen(str));
+}
+
+bool CStringSlice::startsWith(const char *str, int strLengthExcludingNull) const noexcept {
+    const char *rawSelf = raw();
+    if (rawSelf == nullptr || str == nullptr || strLengthExcludingNull > _length) {
+        return false;
+    }
+    return memcmp(rawSelf, str, strLengthExcludingNull) == 0;
+}
+
+bool CStringSlice::endsWith(const char *str) const noexcept {
+    if (str == nullptr) {
+        return false;
+    }
+    return endsWith(str, strlen(str));
+}
+
+bool CStringSlice::endsWith(const char *str, int strLengthExcludingNull) const noexcept {
+    const char *rawSelf = raw();
+    if (rawSelf == nullptr || str == nullptr || strLengthExcludingNull > _length) {
+        return false;
+    }
+    return memcmp(rawSelf + _length - strLengthExcludingNull, str, strLengthExcludingNull) == 0;
+}
+
+uint64_t CStringSlice::hash() const noexcept {
+    const char *rawSelf = raw();
+    if (rawSelf == nullptr) {
+        return 0;
+    }
+    return CString::hash(rawSelf, _length);
+}
+
+int CStringSlice::indexOf(const char c, int startIndex) const noexcept {
+    return indexOf(&c, startIndex, 1);
+}
+
+int CStringSlice::indexOf(const char *str, int startIndex) const noexcept {
+    return indexOf(str, startIndex, strlen(str));
+}
+
+int CStringSlice::indexOf(const char *str, int startIndex, int strLenExcludingNull) const noexcept {
+    if (isInvalid() || startIndex < 0 || startIndex > _length) {
+        return -1;
+    }
+
+    std::string_view::size_type result = asStringView().find(str, startIndex, strLenExcludingNull);
+    return result == std::string_view::npos ? -1 : (int)result;
+}
+
+const std::string_view CStringSlice::asStringView() const noexcept {
+    const char *rawSelf = raw();
+    if (rawSelf == nullptr) {
+        return std::string_view();
+    }
+    return std::string_view(rawSelf, _length);
+}
+
+char CStringSlice::operator[](int index) const noexcept {
+    if (index < 0 || index >= _length || isInvalid()) {
+        return '\0';
+    }
+    return raw()[index];
+}
+
+bool CStringSlice::operator==(const char *str) const noexcept {
+    return compare(str) == 0;
+}
+
+bool CStringSlice::operator==(const std::string_view &str) const noexcept {
+    return compare(str.data(), str.length()) == 0;
+}
+
+bool CStringSlice::operator==(const CStringSlice &str) const noexcept {
+    return compare(str) == 0;
+}
+
+bool CStringSlice::operator!=(const char *str) const noexcept {
+    return compare(str) != 0;
+}
+
+bool CStringSlice::operator!=(const std::string_view &str) const noexcept {
+    return compare(str.data(), str.length()) != 0;
+}
+
+bool CStringSlice::operator!=(const CStringSlice &str) const noexcept {
+    return compare(str) != 0;
+}
+
+CStringSlice::operator const std::string_view() const noexcept {
+    return asStringView();
+}
+
+CStringCodePointIterator::CStringCodePointIterator(const char *data, int length, int startIndex) noexcept
+        : _data(data), _length(length), _index(startIndex) {}
+
+bool CStringCodePointIterator::next(char32_t &codePoint) noexcept {
+    if (_index >= _length) {
+        return false;
+    }
+
+    int sequenceLength = decodeUtf8((const uint8_t*)_data + _index, _length - _index, codePoint);
+    if (sequenceLength == 0) {
+        codePoint = 0xFFFD;
+        sequenceLength = 1;
+    }
+    _index += sequenceLength;
+    return true;
+}
+
+int CStringCodePointIterator::index() const noexcept {
+    return _index;
+}
@@ -11,11 +11,101 @@ void testAppendAfterClearNeedsResize() {
     TEST_ASSERT_EQUAL_STRING("123456", text.raw());
 }
 
+void testAppendFillsRemainingCapacityInPlace() {
+    CStringBuffer<32, 2> buffer;
+    CString text = buffer.allocate(8);
+    text.append("ab");
+    CString other = buffer.push("x");
+
+    // fits into the remaining capacity: the buffer area is not moved
+    text.append("cdef");
+    TEST_ASSERT_EQUAL_STRING("abcdef", text.raw());
+    TEST_ASSERT_EQUAL_INT(0, text.bufferIndex());
+    TEST_ASSERT_EQUAL_INT(1, other.bufferIndex());
+}
+
+void testAppendWithLimitDoesNotReadBeyondLimit() {
+    CStringBuffer<32, 2> buffer;
+    CString text = buffer.allocate(8);
+
+    // not terminated: exactly limit characters are read
+    const char unterminated[2] = {'x', 'y'};
+    text.append(unterminated, 2);
+    TEST_ASSERT_EQUAL_STRING("xy", text.raw());
+    text.append(unterminated, 1);
+    TEST_ASSERT_EQUAL_STRING("xyx", text.raw());
+}
+
+void testAppendStringOfSameBuffer() {
+    CStringBuffer<32, 4> buffer;
+    CString text = buffer.push("ab");
+    CString other = buffer.push("cde");
+
+    // text is moved to the top, which relocates other
+    text.append(other);
+    TEST_ASSERT_EQUAL_STRING("abcde", text.raw());
+    TEST_ASSERT_EQUAL_STRING("cde", other.raw());
+    text.append(text);
+    TEST_ASSERT_EQUAL_STRING("abcdeabcde", text.raw());
+}
+
+void testAppendStringOfSameBufferRelocated() {
+    CStringBuffer<32, 6> buffer;
+    CString first = buffer.push("ab");
+    CString middle = buffer.push("cd");
+    CString last = buffer.push("ef");
+
+    // the topmost string moves down when first is moved to the top
+    first.append(last);
+    TEST_ASSERT_EQUAL_STRING("abef", first.raw());
+    TEST_ASSERT_EQUAL_STRING("ef", last.raw());
+    TEST_ASSERT_EQUAL_STRING("cd", middle.raw());
+
+    // the topmost string grows in place
+    first.append(middle);
+    TEST_ASSERT_EQUAL_STRING("abefcd", first.raw());
+    TEST_ASSERT_EQUAL_INT(2, first.bufferIndex());
+
+    // a shared area is copied before appending the string it was shared with
+    CString clone = middle.cloneShared();
+    clone.append(middle);
+    TEST_ASSERT_EQUAL_STRING("cdcd", clone.raw());
+    TEST_ASSERT_EQUAL_STRING("cd", middle.raw());
+
+    // without capacity to grow, neither string changes
+    CStringBuffer<8, 2> full;
+    CString x = full.push("abc");
+    CString y = full.push("def");
+    TEST_ASSERT_EQUAL_INT(true, x.append(y).isInvalid());
+    TEST_ASSERT_EQUAL_STRING("abc", x.raw());
+    TEST_ASSERT_EQUAL_STRING("def", y.raw());
+}
+
+void testAppendFormatExceedingCapacity() {
+    CStringBuffer<64, 4> buffer;
+    CString text = buffer.allocate(4).append("ab");
+    CString other = buffer.push("other");
+
+    // the first attempt formats into the remaining capacity, the second one after moving text to the top
+    text.appendFormat("%s-%d-%s", "first", 12345, "last");
+    TEST_ASSERT_EQUAL_STRING("abfirst-12345-last", text.raw());
+    TEST_ASSERT_EQUAL_STRING("other", other.raw());
+
+    // the topmost string grows into the unallocated area
+    text.appendFormat("%c%d%s", '/', 67890, "/end");
+    TEST_ASSERT_EQUAL_STRING("abfirst-12345-last/67890/end", text.raw());
+}
+
 void runTestAppend() {
     const char* prevFile = Unity.TestFile;
     Unity.TestFile = __FILE__;
 
     RUN_TEST(testAppendAfterClearNeedsResize);
+    RUN_TEST(testAppendFillsRemainingCapacityInPlace);
+    RUN_TEST(testAppendWithLimitDoesNotReadBeyondLimit);
+    RUN_TEST(testAppendStringOfSameBuffer);
+    RUN_TEST(testAppendStringOfSameBufferRelocated);
+    RUN_TEST(testAppendFormatExceedingCapacity);
 
     Unity.TestFile = prevFile;
 }
\ No newline at end of file
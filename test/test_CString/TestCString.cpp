@@ -1,10 +1,18 @@
 #include <unity.h>
 
 #include "TestAppend.h"
+#include "TestCloneShared.h"
+#include "TestEncoding.h"
 #include "TestEndsWith.h"
+#include "TestEscaping.h"
+#include "TestHash.h"
 #include "TestIndexOf.h"
+#include "TestJoin.h"
+#include "TestSlice.h"
+#include "TestSmallString.h"
 #include "TestStartsWith.h"
 #include "TestTrim.h"
+#include "TestUtf8.h"
 
 void testLength() {
     CStringBuffer<10, 1> buffer;
@@ -117,6 +125,21 @@ void testToUpper() {
     TEST_ASSERT_EQUAL_STRING("ABCDEFGHIJKLMNOPQRSTUVWXYZABCDEFGHIJKLMNOPQRSTUVWXYZäöüßÄÖÜáàâÁÀÂ\x01\x02\x03\x04\x05\x06\x07\x08\x09\x0a\x0b\x0c\x0d\x0e\x0f\x10\x11\x12\x13\x14\x15\x16\x17\x18\x19\x1a\x1b\x1c\x1d\x1e\x1f !\"#$%&'()*+´-./0123456789:;<=>?@[\\]^_`{|}~\x7f", s2.raw());
 }
 
+void testCompareWithSpareCapacity() {
+    CStringBuffer<64, 4> buffer;
+    CString spare = buffer.allocate(20).append("abc");
+    CString exact = buffer.push("abc");
+    CString greater = buffer.allocate(20).append("abd");
+
+    TEST_ASSERT_EQUAL_INT(21, spare.rawCapacity());
+    TEST_ASSERT_EQUAL_INT(0, exact.compare(spare));
+    TEST_ASSERT_EQUAL_INT(0, spare.compare(exact));
+    TEST_ASSERT_EQUAL_INT(true, exact == spare);
+    TEST_ASSERT_EQUAL_INT(false, exact != spare);
+    TEST_ASSERT_EQUAL_INT(true, exact.compare(greater) < 0);
+    TEST_ASSERT_EQUAL_INT(true, greater.compare(spare) > 0);
+}
+
 void setUp() {};
 void tearDown() {};
 
@@ -130,12 +153,21 @@ int main(int argc, char **argv)
     RUN_TEST(testToUpper);
     RUN_TEST(testDeallocateFirst);
     RUN_TEST(testDeallocateLast);
+    RUN_TEST(testCompareWithSpareCapacity);
 
     runTestAppend();
+    runTestCloneShared();
+    runTestEncoding();
     runTestEndsWith();
+    runTestEscaping();
+    runTestHash();
     runTestIndexOf();
+    runTestJoin();
+    runTestSlice();
+    runTestSmallString();
     runTestStartsWith();
     runTestTrim();
+    runTestUtf8();
 
     return UNITY_END();
 }
\ No newline at end of file
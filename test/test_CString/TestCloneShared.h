@@ -0,0 +1,224 @@
+#include "CString.h"
+#include <unity.h>
+
+void testCloneSharedSharesBufferArea() {
+    CStringBuffer<64, 4, 2> buffer;
+    CString source = buffer.push("content-type");
+    int allocated = buffer.allocatedBytes();
+
+    CString clone = source.cloneShared();
+    TEST_ASSERT_EQUAL_INT(true, clone.isAllocated());
+    TEST_ASSERT_EQUAL_PTR(source.raw(), clone.raw());
+    TEST_ASSERT_EQUAL_INT(allocated, buffer.allocatedBytes());
+    TEST_ASSERT_EQUAL_INT(1, buffer.numstrings());
+    TEST_ASSERT_EQUAL_INT(source.bufferIndex(), clone.bufferIndex());
+
+    // modifications not changing the content do not copy
+    clone.trim().toLower();
+    clone.trimEnd('x');
+    clone.substring(0);
+    TEST_ASSERT_EQUAL_PTR(source.raw(), clone.raw());
+    TEST_ASSERT_EQUAL_INT(allocated, buffer.allocatedBytes());
+
+    // small strings are copied
+    CString small = buffer.pushSmall("small");
+    CString smallClone = small.cloneShared();
+    TEST_ASSERT_EQUAL_INT(true, smallClone.isInline());
+    TEST_ASSERT_EQUAL_STRING("small", smallClone.raw());
+    TEST_ASSERT_EQUAL_INT(true, small.raw() != smallClone.raw());
+}
+
+void testCloneSharedCopiesOnWrite() {
+    CStringBuffer<64, 4> buffer;
+    CString source = buffer.push("Content-Type");
+    CString clone = source.cloneShared();
+    CString other = source.cloneShared();
+
+    clone.toLower();
+    TEST_ASSERT_EQUAL_STRING("content-type", clone.raw());
+    TEST_ASSERT_EQUAL_STRING("Content-Type", source.raw());
+    TEST_ASSERT_EQUAL_INT(true, source.raw() != clone.raw());
+    TEST_ASSERT_EQUAL_INT(2, buffer.numstrings());
+
+    // the source is copied as well if still shared
+    source.append(": text/html");
+    TEST_ASSERT_EQUAL_STRING("Content-Type: text/html", source.raw());
+    TEST_ASSERT_EQUAL_STRING("Content-Type", other.raw());
+    TEST_ASSERT_EQUAL_STRING("content-type", clone.raw());
+
+    // the last sharer modifies the area in place
+    const char *otherRaw = other.raw();
+    other[0] = 'c';
+    TEST_ASSERT_EQUAL_PTR(otherRaw, other.raw());
+    TEST_ASSERT_EQUAL_STRING("content-Type", other.raw());
+
+    // copying requires capacity
+    CStringBuffer<16, 4> small;
+    CString full = small.push("0123456789");
+    CString fullClone = full.cloneShared();
+    TEST_ASSERT_EQUAL_INT(true, fullClone.clear().isInvalid());
+    TEST_ASSERT_EQUAL_STRING("0123456789", full.raw());
+}
+
+void testCloneSharedRemove() {
+    CStringBuffer<64, 4> buffer;
+    CString first = buffer.push("first");
+    CString source = buffer.push("shared");
+    CString clone = source.cloneShared();
+    CString last = buffer.push("last");
+
+    // removing a sharer keeps the area for the others
+    source.deallocate();
+    TEST_ASSERT_EQUAL_INT(false, source.isAllocated());
+    TEST_ASSERT_EQUAL_STRING("shared", clone.raw());
+    TEST_ASSERT_EQUAL_INT(3, buffer.numstrings());
+
+    // the last sharer modifies in place, indexes remain consistent after moving and removing
+    clone.append("!");
+    TEST_ASSERT_EQUAL_STRING("shared!", clone.raw());
+    TEST_ASSERT_EQUAL_INT(2, clone.bufferIndex());
+    TEST_ASSERT_EQUAL_INT(1, last.bufferIndex());
+
+    CString clone2 = first.cloneShared();
+    last.append("!");
+    first.deallocate();
+    TEST_ASSERT_EQUAL_STRING("first", clone2.raw());
+    TEST_ASSERT_EQUAL_STRING("shared!", clone.raw());
+    TEST_ASSERT_EQUAL_STRING("last!", last.raw());
+
+    // removing the area by index invalidates all sharers
+    CString clone3 = clone2.cloneShared();
+    TEST_ASSERT_EQUAL_INT(true, buffer.remove(clone2.bufferIndex()));
+    TEST_ASSERT_EQUAL_INT(false, clone2.isAllocated());
+    TEST_ASSERT_EQUAL_INT(false, clone3.isAllocated());
+    TEST_ASSERT_EQUAL_INT(2, buffer.numstrings());
+    TEST_ASSERT_EQUAL_STRING("shared!", clone.raw());
+    TEST_ASSERT_EQUAL_STRING("last!", last.raw());
+}
+
+void testCloneSharedMoveToTop() {
+    CStringBuffer<64, 6> buffer;
+    CString source = buffer.push("abc");
+    CString clone = source.cloneShared();
+    CString other = buffer.push("def");
+
+    // moving a shared area moves all sharers
+    TEST_ASSERT_EQUAL_INT(true, buffer.moveToTop(clone));
+    TEST_ASSERT_EQUAL_INT(1, source.bufferIndex());
+    TEST_ASSERT_EQUAL_INT(1, clone.bufferIndex());
+    TEST_ASSERT_EQUAL_INT(0, other.bufferIndex());
+
+    // removing the topmost sharer keeps the area on top
+    clone.deallocate();
+    CString appended = buffer.appendToTopmost("d");
+    TEST_ASSERT_EQUAL_INT(true, appended == source);
+    TEST_ASSERT_EQUAL_STRING("abcd", source.raw());
+
+    // removing the last area while shared
+    CString clone2 = source.cloneShared();
+    TEST_ASSERT_EQUAL_INT(true, buffer.pop());
+    TEST_ASSERT_EQUAL_INT(false, source.isAllocated());
+    TEST_ASSERT_EQUAL_INT(false, clone2.isAllocated());
+    TEST_ASSERT_EQUAL_INT(true, buffer.peek() == other);
+    TEST_ASSERT_EQUAL_STRING("x", buffer.push("x").raw());
+    TEST_ASSERT_EQUAL_STRING("def", other.raw());
+}
+
+void testCloneSharedExhaustsHandles() {
+    // both handles are in use by a single string
+    CStringBuffer<64, 2> buffer;
+    CString a = buffer.push("a");
+    CString clone = a.cloneShared();
+    TEST_ASSERT_EQUAL_INT(1, buffer.numstrings());
+    TEST_ASSERT_EQUAL_INT(true, buffer.push("b").isInvalid());
+    TEST_ASSERT_EQUAL_INT(true, buffer.pushUnallocated(1).isInvalid());
+    TEST_ASSERT_EQUAL_INT(true, a.cloneShared().isInvalid());
+
+    // copying on write keeps the handle
+    TEST_ASSERT_EQUAL_STRING("ab", clone.append("b").raw());
+    TEST_ASSERT_EQUAL_STRING("a", a.raw());
+    TEST_ASSERT_EQUAL_INT(2, buffer.numstrings());
+
+    // the handles run out with the topmost string not being the first one
+    CStringBuffer<64, 3> other;
+    other.push("x");
+    CString y = other.push("y");
+    CString yClone = y.cloneShared();
+    TEST_ASSERT_EQUAL_INT(true, other.push("z").isInvalid());
+    yClone.deallocate();
+    TEST_ASSERT_EQUAL_STRING("z", other.push("z").raw());
+    TEST_ASSERT_EQUAL_STRING("y", y.raw());
+}
+
+void testCloneSharedFailsWithoutCapacity() {
+    // all modifications require a copy of the shared area, which does not fit
+    std::function<CString&(CString&)> modifications[] = {
+        [](CString& s) -> CString& { return s.clear(); },
+        [](CString& s) -> CString& { return s.toLower(); },
+        [](CString& s) -> CString& { return s.toUpper(); },
+        [](CString& s) -> CString& { return s.trim(); },
+        [](CString& s) -> CString& { return s.trim(' '); },
+        [](CString& s) -> CString& { return s.trim(" "); },
+        [](CString& s) -> CString& { return s.trim(" ", 1); },
+        [](CString& s) -> CString& { return s.trim([](char c) { return c == ' '; }); },
+        [](CString& s) -> CString& { return s.trimStart(); },
+        [](CString& s) -> CString& { return s.trimStart(' '); },
+        [](CString& s) -> CString& { return s.trimStart(" "); },
+        [](CString& s) -> CString& { return s.trimStart(" ", 1); },
+        [](CString& s) -> CString& { return s.trimStart([](char c) { return c == ' '; }); },
+        [](CString& s) -> CString& { return s.trimEnd(); },
+        [](CString& s) -> CString& { return s.trimEnd(' '); },
+        [](CString& s) -> CString& { return s.trimEnd(" "); },
+        [](CString& s) -> CString& { return s.trimEnd(" ", 1); },
+        [](CString& s) -> CString& { return s.trimEnd([](char c) { return c == ' '; }); },
+        [](CString& s) -> CString& { return s.substring(1); },
+        [](CString& s) -> CString& { return s.substring(1, 2); },
+        [](CString& s) -> CString& { return s.shrinkToFit(); },
+        [](CString& s) -> CString& { return s.resize(3); },
+        [](CString& s) -> CString& { return s.resizeUtf8(3); },
+        [](CString& s) -> CString& { return s.urlDecode(); },
+        [](CString& s) -> CString& { return s.append('x'); },
+        [](CString& s) -> CString& { return s.append(s.slice(1, 2)); },
+        [](CString& s) -> CString& { return s.appendFormat("%d", 1); },
+        [](CString& s) -> CString& { return s.appendMost("x"); },
+        [](CString& s) -> CString& { return s.appendMostFormat("%d", 1); },
+        [](CString& s) -> CString& { return s.appendMostUtf8("x"); },
+        [](CString& s) -> CString& { return s.appendHex((const uint8_t *) "x", 1); },
+        [](CString& s) -> CString& { return s.appendJoin(&s, 1, ","); },
+        [](CString& s) -> CString& { return s = "x"; },
+    };
+
+    for (auto &modify : modifications) {
+        CStringBuffer<8, 4> buffer;
+        CString source = buffer.push(" Ab%41 ");
+        CString clone = source.cloneShared();
+        TEST_ASSERT_EQUAL_INT(0, buffer.unallocatedBytes());
+
+        TEST_ASSERT_EQUAL_INT(true, modify(clone).isInvalid());
+        TEST_ASSERT_EQUAL_STRING(" Ab%41 ", clone.raw());
+        TEST_ASSERT_EQUAL_STRING(" Ab%41 ", source.raw());
+        TEST_ASSERT_EQUAL_PTR(source.raw(), clone.raw());
+    }
+
+    // operator[] refers to a dummy \0
+    CStringBuffer<8, 4> buffer;
+    CString source = buffer.push(" Ab%41 ");
+    CString clone = source.cloneShared();
+    clone[1] = 'a';
+    TEST_ASSERT_EQUAL_INT('\0', clone[1]);
+    TEST_ASSERT_EQUAL_STRING(" Ab%41 ", source.raw());
+}
+
+void runTestCloneShared() {
+    const char* prevFile = Unity.TestFile;
+    Unity.TestFile = __FILE__;
+
+    RUN_TEST(testCloneSharedSharesBufferArea);
+    RUN_TEST(testCloneSharedCopiesOnWrite);
+    RUN_TEST(testCloneSharedRemove);
+    RUN_TEST(testCloneSharedMoveToTop);
+    RUN_TEST(testCloneSharedExhaustsHandles);
+    RUN_TEST(testCloneSharedFailsWithoutCapacity);
+
+    Unity.TestFile = prevFile;
+}
@@ -0,0 +1,154 @@
+#include <unity.h>
+#include "CString.h"
+
+void testAppendHex() {
+    CStringBuffer<100, 2> buffer;
+    CString s1 = buffer.push("id=");
+    uint8_t data[20];
+    for (int i = 0; i < 20; ++i) {
+        data[i] = i * 13 + 7;
+    }
+
+    // 20 bytes: vectorized block of 16 and scalar tail
+    TEST_ASSERT_EQUAL_INT(false, s1.appendHex(data, 20).isInvalid());
+    TEST_ASSERT_EQUAL_STRING("id=0714212e3b4855626f7c8996a3b0bdcad7e4f1fe", s1.raw());
+    TEST_ASSERT_EQUAL_INT(false, s1.clear().appendHex(data + 16, 4, true).isInvalid());
+    TEST_ASSERT_EQUAL_STRING("D7E4F1FE", s1.raw());
+    TEST_ASSERT_EQUAL_INT(false, s1.appendHex(nullptr, 0).isInvalid());
+    TEST_ASSERT_EQUAL_INT(true, s1.appendHex(nullptr, 1).isInvalid());
+    TEST_ASSERT_EQUAL_INT(true, CString::INVALID.appendHex(data, 1).isInvalid());
+}
+
+void testAppendHexInsufficientBuffer() {
+    CStringBuffer<10, 1> buffer;
+    CString s1 = buffer.push("ab");
+    uint8_t data[4] = {1, 2, 3, 4};
+
+    TEST_ASSERT_EQUAL_INT(true, s1.appendHex(data, 4).isInvalid());
+    TEST_ASSERT_EQUAL_STRING("ab", s1.raw());
+}
+
+void testDecodeHex() {
+    CStringBuffer<40, 2> buffer;
+    CString s1 = buffer.push("00ff7Fa0");
+    CString s2 = buffer.push("0g");
+    uint8_t data[4];
+
+    TEST_ASSERT_EQUAL_INT(4, s1.decodeHex(data, 4));
+    TEST_ASSERT_EQUAL_INT(0x00, data[0]);
+    TEST_ASSERT_EQUAL_INT(0xFF, data[1]);
+    TEST_ASSERT_EQUAL_INT(0x7F, data[2]);
+    TEST_ASSERT_EQUAL_INT(0xA0, data[3]);
+    TEST_ASSERT_EQUAL_INT(-1, s1.decodeHex(data, 3));
+    TEST_ASSERT_EQUAL_INT(-1, s2.decodeHex(data, 4));
+    TEST_ASSERT_EQUAL_INT(-1, CString::decodeHex("abc", 3, data, 4));
+    TEST_ASSERT_EQUAL_INT(-1, CString::INVALID.decodeHex(data, 4));
+
+    TEST_ASSERT_EQUAL_INT(false, s2.clear().appendHexDecoded("48692c").isInvalid());
+    TEST_ASSERT_EQUAL_STRING("Hi,", s2.raw());
+    TEST_ASSERT_EQUAL_INT(true, s2.appendHexDecoded("4100").isInvalid());
+    TEST_ASSERT_EQUAL_INT(true, s2.appendHexDecoded("4x").isInvalid());
+    TEST_ASSERT_EQUAL_STRING("Hi,", s2.raw());
+}
+
+void testAppendBase64() {
+    CStringBuffer<80, 1> buffer;
+    CString s1 = buffer.push("");
+    const uint8_t data[] = {0xFB, 0xFF, 0xBF, 'a', 'b'};
+
+    const char *expected[] = {"", "+w==", "+/8=", "+/+/", "+/+/YQ==", "+/+/YWI="};
+    const char *expectedUrl[] = {"", "-w", "-_8", "-_-_", "-_-_YQ", "-_-_YWI"};
+    for (int length = 0; length <= 5; ++length) {
+        TEST_ASSERT_EQUAL_INT(false, s1.clear().appendBase64(data, length).isInvalid());
+        TEST_ASSERT_EQUAL_STRING(expected[length], s1.raw());
+        TEST_ASSERT_EQUAL_INT(false, s1.clear().appendBase64Url(data, length).isInvalid());
+        TEST_ASSERT_EQUAL_STRING(expectedUrl[length], s1.raw());
+    }
+}
+
+void testDecodeBase64() {
+    CStringBuffer<80, 2> buffer;
+    CString s1 = buffer.push("+/+/YWI=");
+    CString s2 = buffer.push("");
+    uint8_t data[8];
+
+    TEST_ASSERT_EQUAL_INT(5, s1.decodeBase64(data, 8));
+    TEST_ASSERT_EQUAL_INT(0xFB, data[0]);
+    TEST_ASSERT_EQUAL_INT(0xBF, data[2]);
+    TEST_ASSERT_EQUAL_INT('b', data[4]);
+    TEST_ASSERT_EQUAL_INT(5, CString::decodeBase64("-_-_YWI", 7, data, 8));
+    TEST_ASSERT_EQUAL_INT(0xFB, data[0]);
+    TEST_ASSERT_EQUAL_INT(1, CString::decodeBase64("YQ==", 4, data, 8));
+    TEST_ASSERT_EQUAL_INT(-1, CString::decodeBase64("YQ==", 4, data, 0));
+    TEST_ASSERT_EQUAL_INT(-1, CString::decodeBase64("Y", 1, data, 8));
+    TEST_ASSERT_EQUAL_INT(-1, CString::decodeBase64("Y===", 4, data, 8));
+    TEST_ASSERT_EQUAL_INT(-1, CString::decodeBase64("YQ=a", 4, data, 8));
+    TEST_ASSERT_EQUAL_INT(0, CString::decodeBase64("", 0, data, 8));
+
+    TEST_ASSERT_EQUAL_INT(false, s2.appendBase64Decoded("SGVsbG8sIHdvcmxk").isInvalid());
+    TEST_ASSERT_EQUAL_STRING("Hello, world", s2.raw());
+    TEST_ASSERT_EQUAL_INT(true, s2.appendBase64Decoded("AA==").isInvalid());
+    TEST_ASSERT_EQUAL_STRING("Hello, world", s2.raw());
+}
+
+void testBase64RoundTrip() {
+    CStringBuffer<200, 1> buffer;
+    CString s1 = buffer.push("");
+    uint8_t data[100];
+    uint8_t decoded[100];
+    for (int i = 0; i < 100; ++i) {
+        data[i] = i * 37 + 11;
+    }
+
+    for (int length = 0; length <= 100; length += 7) {
+        TEST_ASSERT_EQUAL_INT(false, s1.clear().appendBase64(data, length).isInvalid());
+        TEST_ASSERT_EQUAL_INT(length, s1.decodeBase64(decoded, 100));
+        TEST_ASSERT_EQUAL_MEMORY(data, decoded, length);
+
+        TEST_ASSERT_EQUAL_INT(false, s1.clear().appendHex(data, length).isInvalid());
+        TEST_ASSERT_EQUAL_INT(length, s1.decodeHex(decoded, 100));
+        TEST_ASSERT_EQUAL_MEMORY(data, decoded, length);
+    }
+}
+
+void testDecodeStringOfSameBuffer() {
+    CStringBuffer<80, 4> buffer;
+    CString text = buffer.push("x:");
+    CString hex = buffer.push("48656c6c6f");
+    CString base64 = buffer.push("LCB3b3JsZA==");
+
+    // resizing text moves it to the top, which relocates the encoded strings
+    TEST_ASSERT_EQUAL_INT(false, text.appendHexDecoded(hex.asStringView()).isInvalid());
+    TEST_ASSERT_EQUAL_STRING("x:Hello", text.raw());
+    TEST_ASSERT_EQUAL_STRING("48656c6c6f", hex.raw());
+    CString first = buffer.getCString(0);
+    TEST_ASSERT_EQUAL_INT(false, first.appendBase64Decoded(base64.asStringView()).isInvalid());
+    TEST_ASSERT_EQUAL_STRING("48656c6c6f, world", first.raw());
+    TEST_ASSERT_EQUAL_STRING("LCB3b3JsZA==", base64.raw());
+    TEST_ASSERT_EQUAL_INT(3, buffer.numstrings());
+
+    // the string itself
+    TEST_ASSERT_EQUAL_INT(false, hex.clear().append("4142").appendHexDecoded(hex.asStringView()).isInvalid());
+    TEST_ASSERT_EQUAL_STRING("4142AB", hex.raw());
+
+    // content remains unchanged if malformed
+    CString malformed = buffer.push("4x");
+    TEST_ASSERT_EQUAL_INT(true, text.appendHexDecoded(malformed.asStringView()).isInvalid());
+    TEST_ASSERT_EQUAL_STRING("x:Hello", text.raw());
+    TEST_ASSERT_EQUAL_INT(4, buffer.numstrings());
+}
+
+void runTestEncoding() {
+    const char* prevFile = Unity.TestFile;
+    Unity.TestFile = __FILE__;
+
+    RUN_TEST(testAppendHex);
+    RUN_TEST(testAppendHexInsufficientBuffer);
+    RUN_TEST(testDecodeHex);
+    RUN_TEST(testAppendBase64);
+    RUN_TEST(testDecodeBase64);
+    RUN_TEST(testBase64RoundTrip);
+    RUN_TEST(testDecodeStringOfSameBuffer);
+
+    Unity.TestFile = prevFile;
+}
@@ -0,0 +1,88 @@
+#include <unity.h>
+#include "CString.h"
+
+void testAppendJsonEscaped() {
+    CStringBuffer<120, 1> buffer;
+    CString s1 = buffer.push("{\"msg\": \"");
+
+    TEST_ASSERT_EQUAL_INT(false, s1.appendJsonEscaped("say \"hi\"\\\n\t\x01 gr\xC3\xBC\xC3\x9F" "e").isInvalid());
+    TEST_ASSERT_EQUAL_STRING("{\"msg\": \"say \\\"hi\\\"\\\\\\n\\t\\u0001 gr\xC3\xBC\xC3\x9F" "e", s1.raw());
+    TEST_ASSERT_EQUAL_INT(false, s1.clear().appendJsonEscaped("").isInvalid());
+    TEST_ASSERT_EQUAL_STRING("", s1.raw());
+
+    // escapes within and after a block of 16 characters
+    TEST_ASSERT_EQUAL_INT(false, s1.appendJsonEscaped("0123456789abcd\"f0123456789abcdef\x1f").isInvalid());
+    TEST_ASSERT_EQUAL_STRING("0123456789abcd\\\"f0123456789abcdef\\u001f", s1.raw());
+    TEST_ASSERT_EQUAL_INT(true, CString::INVALID.appendJsonEscaped("a").isInvalid());
+}
+
+void testAppendEscapedInsufficientBuffer() {
+    CStringBuffer<10, 1> buffer;
+    CString s1 = buffer.push("ab");
+
+    TEST_ASSERT_EQUAL_INT(true, s1.appendJsonEscaped("\"\"\"\"").isInvalid());
+    TEST_ASSERT_EQUAL_STRING("ab", s1.raw());
+    TEST_ASSERT_EQUAL_INT(false, s1.appendJsonEscaped("\"\"\"").isInvalid());
+    TEST_ASSERT_EQUAL_STRING("ab\\\"\\\"\\\"", s1.raw());
+}
+
+void testAppendUrlEncoded() {
+    CStringBuffer<120, 1> buffer;
+    CString s1 = buffer.push("q=");
+
+    TEST_ASSERT_EQUAL_INT(false, s1.appendUrlEncoded("a b/c?d=e&f~g.h_i-j\xC3\xBC").isInvalid());
+    TEST_ASSERT_EQUAL_STRING("q=a%20b%2Fc%3Fd%3De%26f~g.h_i-j%C3%BC", s1.raw());
+    TEST_ASSERT_EQUAL_INT(false, s1.clear().appendUrlEncoded("ABCXYZabcxyz0189-._~/").isInvalid());
+    TEST_ASSERT_EQUAL_STRING("ABCXYZabcxyz0189-._~%2F", s1.raw());
+}
+
+void testUrlDecode() {
+    CStringBuffer<80, 3> buffer;
+    CString s1 = buffer.push("a%20b%2Fc+d%c3%BC");
+    CString s2 = buffer.push("a+b%2");
+    CString s3 = buffer.push("%00");
+
+    TEST_ASSERT_EQUAL_INT(false, s1.urlDecode(true).isInvalid());
+    TEST_ASSERT_EQUAL_STRING("a b/c d\xC3\xBC", s1.raw());
+    TEST_ASSERT_EQUAL_INT(true, s2.urlDecode(true).isInvalid());
+    TEST_ASSERT_EQUAL_STRING("a+b%2", s2.raw());
+    TEST_ASSERT_EQUAL_INT(true, s3.urlDecode().isInvalid());
+    TEST_ASSERT_EQUAL_INT(false, s2.clear().append("a+b%2B").urlDecode().isInvalid());
+    TEST_ASSERT_EQUAL_STRING("a+b+", s2.raw());
+}
+
+void testUrlEncodeRoundTrip() {
+    CStringBuffer<800, 1> buffer;
+    CString s1 = buffer.push("");
+    char data[255];
+    for (int i = 0; i < 255; ++i) {
+        data[i] = (char)(i + 1);
+    }
+
+    TEST_ASSERT_EQUAL_INT(false, s1.appendUrlEncoded(std::string_view(data, 255)).isInvalid());
+    TEST_ASSERT_EQUAL_INT(false, s1.urlDecode().isInvalid());
+    TEST_ASSERT_EQUAL_INT(255, s1.length());
+    TEST_ASSERT_EQUAL_MEMORY(data, s1.raw(), 255);
+}
+
+void testAppendCEscaped() {
+    CStringBuffer<80, 1> buffer;
+    CString s1 = buffer.push("");
+
+    TEST_ASSERT_EQUAL_INT(false, s1.appendCEscaped("a\"b\\c\n\t\a\x01\x7f\xC3\xBC").isInvalid());
+    TEST_ASSERT_EQUAL_STRING("a\\\"b\\\\c\\n\\t\\a\\001\\177\\303\\274", s1.raw());
+}
+
+void runTestEscaping() {
+    const char* prevFile = Unity.TestFile;
+    Unity.TestFile = __FILE__;
+
+    RUN_TEST(testAppendJsonEscaped);
+    RUN_TEST(testAppendEscapedInsufficientBuffer);
+    RUN_TEST(testAppendUrlEncoded);
+    RUN_TEST(testUrlDecode);
+    RUN_TEST(testUrlEncodeRoundTrip);
+    RUN_TEST(testAppendCEscaped);
+
+    Unity.TestFile = prevFile;
+}
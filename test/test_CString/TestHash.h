@@ -0,0 +1,112 @@
+#include <unity.h>
+#include "CString.h"
+
+void testHashEqualContent() {
+    CStringBuffer<200, 2> buffer1;
+    CStringBuffer<200, 1> buffer2;
+    CString s1 = buffer1.push("Content-Type");
+    CString s2 = buffer2.push("Content-Type");
+
+    TEST_ASSERT_EQUAL_UINT64(s1.hash(), s2.hash());
+    TEST_ASSERT_EQUAL_UINT64(CString::hash("Content-Type"), s1.hash());
+    TEST_ASSERT_EQUAL_UINT64(CString::hash(std::string_view("Content-Type")), s1.hash());
+    TEST_ASSERT_EQUAL_UINT64(CString::hash("Content-Type-Options", 12), s1.hash());
+
+    // hash depends on content, not on the buffer area's capacity
+    s1.resize(100);
+    TEST_ASSERT_EQUAL_UINT64(s2.hash(), s1.hash());
+}
+
+void testHashDiffersForDifferentContent() {
+    // cover all input length classes: 0, 1-3, 4-16, 17-48, > 48
+    const char *text = "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+    uint64_t hashes[72];
+
+    for (int len = 0; len < 72; ++len) {
+        hashes[len] = CString::hash(text, len);
+        for (int prev = 0; prev < len; ++prev) {
+            TEST_ASSERT_NOT_EQUAL(hashes[prev], hashes[len]);
+        }
+    }
+
+    TEST_ASSERT_NOT_EQUAL(CString::hash("Host"), CString::hash("host"));
+    TEST_ASSERT_NOT_EQUAL(CString::hash("ab"), CString::hash("ba"));
+}
+
+void testHashIsConstexpr() {
+    constexpr uint64_t hostHash = CString::hash("Host");
+    static_assert(hostHash != CString::hash("Accept"));
+
+    CStringBuffer<20, 1> buffer;
+    CString s1 = buffer.push("Host");
+
+    int matched = 0;
+    switch (s1.hash()) {
+        case CString::hash("Accept"):
+            matched = 1;
+            break;
+        case CString::hash("Host"):
+            matched = 2;
+            break;
+        default:
+            break;
+    }
+    TEST_ASSERT_EQUAL_INT(2, matched);
+}
+
+void testHashLongInput() {
+    CStringBuffer<600, 2> buffer;
+    CString s1 = buffer.allocate(256);
+    for (int i = 0; i < 256; ++i) {
+        s1.append((char)('a' + i % 26));
+    }
+    CString s2 = s1.clone();
+    TEST_ASSERT_EQUAL_UINT64(s1.hash(), s2.hash());
+
+    s2[200] = 'A';
+    TEST_ASSERT_NOT_EQUAL(s1.hash(), s2.hash());
+}
+
+void testHashUnallocated() {
+    CStringBuffer<20, 2> buffer;
+    CString s1 = buffer.allocate();
+    CString s2 = buffer.push("x").deallocate();
+
+    TEST_ASSERT_EQUAL_UINT64(CString::hash(""), s1.hash());
+    TEST_ASSERT_EQUAL_UINT64(0, s2.hash());
+    TEST_ASSERT_EQUAL_UINT64(0, CString::INVALID.hash());
+}
+
+void testHashSlice() {
+    CStringBuffer<30, 1> buffer;
+    CString s1 = buffer.push("Host: example.org");
+
+    TEST_ASSERT_EQUAL_UINT64(CString::hash("Host"), s1.slice(0, 4).hash());
+    TEST_ASSERT_EQUAL_UINT64(CString::hash("example.org"), s1.slice(6).hash());
+    TEST_ASSERT_EQUAL_UINT64(0, CStringSlice().hash());
+}
+
+void testStdHash() {
+    CStringBuffer<30, 3> buffer;
+    CString s1 = buffer.push("a");
+    CString s2 = buffer.push("b");
+
+    TEST_ASSERT_EQUAL_UINT64((size_t)s1.hash(), std::hash<CString>{}(s1));
+    TEST_ASSERT_EQUAL_UINT64((size_t)s2.slice(0).hash(), std::hash<CStringSlice>{}(s2.slice(0)));
+    TEST_ASSERT_NOT_EQUAL(std::hash<CString>{}(s1), std::hash<CString>{}(s2));
+}
+
+void runTestHash() {
+    const char* prevFile = Unity.TestFile;
+    Unity.TestFile = __FILE__;
+
+    RUN_TEST(testHashEqualContent);
+    RUN_TEST(testHashDiffersForDifferentContent);
+    RUN_TEST(testHashIsConstexpr);
+    RUN_TEST(testHashLongInput);
+    RUN_TEST(testHashUnallocated);
+    RUN_TEST(testHashSlice);
+    RUN_TEST(testStdHash);
+
+    Unity.TestFile = prevFile;
+}
@@ -0,0 +1,145 @@
+#include <array>
+#include <unity.h>
+#include "CString.h"
+
+void testAppendJoin() {
+    CStringBuffer<30, 4> buffer;
+    CString s1 = buffer.push("a");
+    CString s2 = buffer.push("bc");
+    CString s3 = buffer.push("def");
+    CString target = buffer.push("list:");
+
+    CString strings[] = {s1, s2, s3};
+    target.appendJoin(strings, ", ");
+
+    TEST_ASSERT_EQUAL_INT(false, target.isInvalid());
+    TEST_ASSERT_EQUAL_STRING("list:a, bc, def", target.raw());
+    TEST_ASSERT_EQUAL_INT(15, target.rawMaxLength());
+    TEST_ASSERT_EQUAL_STRING("a", s1.raw());
+    TEST_ASSERT_EQUAL_STRING("bc", s2.raw());
+    TEST_ASSERT_EQUAL_STRING("def", s3.raw());
+}
+
+void testAppendJoinRelocatesTarget() {
+    CStringBuffer<30, 4> buffer;
+    CString target = buffer.push("x=");
+    CString s1 = buffer.push("12");
+    CString s2 = buffer.push("34");
+
+    std::array<CString, 2> strings{s1, s2};
+    target.appendJoin(strings, "|");
+
+    TEST_ASSERT_EQUAL_INT(false, target.isInvalid());
+    TEST_ASSERT_EQUAL_INT(2, target.bufferIndex());
+    TEST_ASSERT_EQUAL_STRING("x=12|34", target.raw());
+    TEST_ASSERT_EQUAL_STRING("12", s1.raw());
+    TEST_ASSERT_EQUAL_STRING("34", s2.raw());
+}
+
+void testAppendJoinIncludingSelf() {
+    CStringBuffer<30, 2> buffer;
+    CString target = buffer.push("ab");
+    CString other = buffer.push("c");
+
+    CString strings[] = {target, other, target};
+    target.appendJoin(strings, "-");
+
+    TEST_ASSERT_EQUAL_STRING("abab-c-ab", target.raw());
+    TEST_ASSERT_EQUAL_STRING("c", other.raw());
+}
+
+void testAppendJoinInline() {
+    CStringBuffer<30, 2> buffer;
+    CString target = buffer.allocate(10);
+    CString other = buffer.push("b");
+    char *rawBefore = target.raw();
+
+    CString strings[] = {other, other};
+    target.appendJoin(strings, nullptr);
+
+    TEST_ASSERT_EQUAL_INT(true, rawBefore == target.raw());
+    TEST_ASSERT_EQUAL_INT(0, target.bufferIndex());
+    TEST_ASSERT_EQUAL_STRING("bb", target.raw());
+}
+
+void testAppendJoinEmptyRange() {
+    CStringBuffer<10, 1> buffer;
+    CString target = buffer.push("abc");
+
+    target.appendJoin(nullptr, 0, ",");
+
+    TEST_ASSERT_EQUAL_INT(false, target.isInvalid());
+    TEST_ASSERT_EQUAL_STRING("abc", target.raw());
+}
+
+void testAppendJoinInsufficientCapacity() {
+    CStringBuffer<12, 3> buffer;
+    CString s1 = buffer.push("1234");
+    CString target = buffer.push("56");
+
+    CString strings[] = {s1, s1};
+    CString result = target.appendJoin(strings, ",");
+
+    TEST_ASSERT_EQUAL_INT(true, result.isInvalid());
+    TEST_ASSERT_EQUAL_STRING("56", target.raw());
+    TEST_ASSERT_EQUAL_STRING("1234", s1.raw());
+}
+
+void testAppendJoinUnallocatedString() {
+    CStringBuffer<20, 3> buffer;
+    CString s1 = buffer.push("1234");
+    CString s2 = buffer.push("56");
+    CString target = buffer.allocate();
+    s2.deallocate();
+
+    CString strings[] = {s1, s2};
+    CString result = target.appendJoin(strings, ",");
+
+    TEST_ASSERT_EQUAL_INT(true, result.isInvalid());
+    TEST_ASSERT_EQUAL_STRING("", target.raw());
+}
+
+void testPushJoin() {
+    CStringBuffer<30, 4> buffer;
+    CString s1 = buffer.push("GET");
+    CString s2 = buffer.push("HEAD");
+    CString s3 = buffer.push("POST");
+
+    CString joined = buffer.pushJoin(std::array<CString, 3>{s1, s2, s3}, ", ");
+
+    TEST_ASSERT_EQUAL_INT(false, joined.isInvalid());
+    TEST_ASSERT_EQUAL_INT(3, joined.bufferIndex());
+    TEST_ASSERT_EQUAL_STRING("GET, HEAD, POST", joined.raw());
+    TEST_ASSERT_EQUAL_INT(16, joined.rawCapacity());
+    TEST_ASSERT_EQUAL_INT(30, buffer.allocatedBytes());
+}
+
+void testPushJoinInsufficientCapacity() {
+    CStringBuffer<20, 4> buffer;
+    CString s1 = buffer.push("GET");
+    CString s2 = buffer.push("HEAD");
+
+    CString strings[] = {s1, s2, s1, s2};
+    CString joined = buffer.pushJoin(strings, ", ");
+
+    TEST_ASSERT_EQUAL_INT(true, joined.isInvalid());
+    TEST_ASSERT_EQUAL_INT(2, buffer.numstrings());
+    TEST_ASSERT_EQUAL_INT(9, buffer.allocatedBytes());
+}
+
+void runTestJoin() {
+    const char* prevFile = Unity.TestFile;
+    Unity.TestFile = __FILE__;
+
+    RUN_TEST(testAppendJoin);
+    RUN_TEST(testAppendJoinRelocatesTarget);
+    RUN_TEST(testAppendJoinIncludingSelf);
+    RUN_TEST(testAppendJoinInline);
+    RUN_TEST(testAppendJoinEmptyRange);
+    RUN_TEST(testAppendJoinInsufficientCapacity);
+    RUN_TEST(testAppendJoinUnallocatedString);
+    RUN_TEST(testPushJoin);
+    RUN_TEST(testPushJoinInsufficientCapacity);
+
+    Unity.TestFile = prevFile;
+}
@@ -0,0 +1,178 @@
+#include <unity.h>
+#include "CString.h"
+
+void testSlice() {
+    CStringBuffer<30, 1> buffer;
+    CString s1 = buffer.push("Host: example.org");
+
+    CStringSlice name = s1.slice(0, 4);
+    CStringSlice value = s1.slice(6);
+
+    TEST_ASSERT_EQUAL_INT(false, name.isInvalid());
+    TEST_ASSERT_EQUAL_INT(4, name.length());
+    TEST_ASSERT_EQUAL_INT(0, name.startIndex());
+    TEST_ASSERT_EQUAL_INT(true, name == "Host");
+    TEST_ASSERT_EQUAL_INT(true, name != "Hos");
+    TEST_ASSERT_EQUAL_INT(11, value.length());
+    TEST_ASSERT_EQUAL_INT(6, value.startIndex());
+    TEST_ASSERT_EQUAL_INT(true, value == "example.org");
+    TEST_ASSERT_EQUAL_INT(true, value.asStringView() == "example.org");
+    TEST_ASSERT_EQUAL_INT('e', value[0]);
+    TEST_ASSERT_EQUAL_INT('\0', value[11]);
+    TEST_ASSERT_EQUAL_INT(true, s1.raw() + 6 == value.raw());
+}
+
+void testSliceOutOfRange() {
+    CStringBuffer<10, 1> buffer;
+    CString s1 = buffer.push("12345");
+
+    TEST_ASSERT_EQUAL_INT(true, s1.slice(-1, 2).isInvalid());
+    TEST_ASSERT_EQUAL_INT(true, s1.slice(2, -1).isInvalid());
+    TEST_ASSERT_EQUAL_INT(true, s1.slice(4, 3).isInvalid());
+    TEST_ASSERT_EQUAL_INT(false, s1.slice(4, 2).isInvalid());
+    TEST_ASSERT_EQUAL_INT(true, s1.slice(5).isEmpty());
+    TEST_ASSERT_EQUAL_INT(true, CString::INVALID.slice(0, 0).isInvalid());
+    TEST_ASSERT_EQUAL_INT(-1, CStringSlice().length());
+    TEST_ASSERT_EQUAL_INT(true, CStringSlice().raw() == nullptr);
+}
+
+void testSliceFollowsRelocation() {
+    CStringBuffer<30, 3> buffer;
+    CString s1 = buffer.push("abc");
+    CString s2 = buffer.push("key=value");
+    CString s3 = buffer.push("xyz");
+
+    CStringSlice value = s2.slice(4, 5);
+    std::string_view staleView = value.asStringView();
+
+    s1.deallocate();
+    TEST_ASSERT_EQUAL_INT(true, staleView.data() != value.raw());
+    TEST_ASSERT_EQUAL_INT(true, value == "value");
+
+    buffer.moveToTop(s2);
+    TEST_ASSERT_EQUAL_INT(true, value == "value");
+
+    s3.append("123456");
+    TEST_ASSERT_EQUAL_INT(true, value == "value");
+    TEST_ASSERT_EQUAL_STRING("xyz123456", s3.raw());
+}
+
+void testSliceInvalidatedByDeallocate() {
+    CStringBuffer<30, 2> buffer;
+    CString s1 = buffer.push("abc");
+    CString s2 = buffer.push("def");
+
+    CStringSlice slice = s1.slice(0, 2);
+    s1.deallocate();
+
+    TEST_ASSERT_EQUAL_INT(true, slice.isInvalid());
+    TEST_ASSERT_EQUAL_INT(-1, slice.length());
+    TEST_ASSERT_EQUAL_INT(true, slice != "ab");
+    TEST_ASSERT_EQUAL_STRING("def", s2.raw());
+}
+
+void testSliceInvalidatedByShrink() {
+    CStringBuffer<30, 1> buffer;
+    CString s1 = buffer.push("abcdef");
+
+    CStringSlice slice = s1.slice(3, 3);
+    s1.resize(4);
+
+    TEST_ASSERT_EQUAL_INT(true, slice.isInvalid());
+    TEST_ASSERT_EQUAL_INT(false, s1.slice(3, 2).isInvalid());
+}
+
+void testSliceOfSlice() {
+    CStringBuffer<30, 1> buffer;
+    CString s1 = buffer.push("GET /index.html HTTP/1.1");
+
+    CStringSlice path = s1.slice(4, 11);
+    CStringSlice extension = path.slice(7, 4);
+
+    TEST_ASSERT_EQUAL_INT(true, extension == "html");
+    TEST_ASSERT_EQUAL_INT(11, extension.startIndex());
+    TEST_ASSERT_EQUAL_INT(true, path.slice(7, 5).isInvalid());
+}
+
+void testSliceSearch() {
+    CStringBuffer<30, 1> buffer;
+    CString s1 = buffer.push("a=1;b=22;c=333");
+
+    CStringSlice middle = s1.slice(4, 4);
+    TEST_ASSERT_EQUAL_INT(1, middle.indexOf('='));
+    TEST_ASSERT_EQUAL_INT(2, middle.indexOf("22"));
+    TEST_ASSERT_EQUAL_INT(-1, middle.indexOf(';'));
+    TEST_ASSERT_EQUAL_INT(-1, middle.indexOf("22", 3));
+    TEST_ASSERT_EQUAL_INT(true, middle.startsWith("b="));
+    TEST_ASSERT_EQUAL_INT(false, middle.startsWith("b=22;"));
+    TEST_ASSERT_EQUAL_INT(true, middle.endsWith("22"));
+    TEST_ASSERT_EQUAL_INT(false, middle.endsWith("3"));
+}
+
+void testCStringAcceptsSlice() {
+    CStringBuffer<40, 3> buffer;
+    CString s1 = buffer.push("content-type");
+    CString s2 = buffer.push("type");
+    CString s3 = buffer.push("content");
+
+    CStringSlice type = s1.slice(8, 4);
+    CStringSlice content = s1.slice(0, 7);
+
+    TEST_ASSERT_EQUAL_INT(0, s2.compare(type));
+    TEST_ASSERT_EQUAL_INT(true, s2 == type);
+    TEST_ASSERT_EQUAL_INT(true, s3 != type);
+    TEST_ASSERT_EQUAL_INT(8, s1.indexOf(type));
+    TEST_ASSERT_EQUAL_INT(-1, s1.indexOf(type, 9));
+    TEST_ASSERT_EQUAL_INT(true, s1.startsWith(content));
+    TEST_ASSERT_EQUAL_INT(false, s1.startsWith(type));
+    TEST_ASSERT_EQUAL_INT(true, s1.endsWith(type));
+    TEST_ASSERT_EQUAL_INT(false, s1.endsWith(content));
+    TEST_ASSERT_EQUAL_INT(-1, s1.indexOf(CStringSlice()));
+}
+
+void testAppendSlice() {
+    CStringBuffer<40, 2> buffer;
+    CString s1 = buffer.push("key=value");
+    CString s2 = buffer.push("x");
+
+    s1.append(s2.slice(0));
+    TEST_ASSERT_EQUAL_STRING("key=valuex", s1.raw());
+
+    s2.append(s1.slice(4, 5));
+    TEST_ASSERT_EQUAL_STRING("xvalue", s2.raw());
+
+    s1.append(s1.slice(0, 3));
+    TEST_ASSERT_EQUAL_STRING("key=valuexkey", s1.raw());
+    TEST_ASSERT_EQUAL_STRING("xvalue", s2.raw());
+
+    TEST_ASSERT_EQUAL_INT(true, s1.append(CStringSlice()).isInvalid());
+    TEST_ASSERT_EQUAL_STRING("key=valuexkey", s1.raw());
+}
+
+void testCloneSlice() {
+    CStringBuffer<30, 2> buffer;
+    CString s1 = buffer.push("key=value");
+
+    CString value = s1.slice(4, 5).clone();
+    TEST_ASSERT_EQUAL_STRING("value", value.raw());
+    TEST_ASSERT_EQUAL_INT(1, value.bufferIndex());
+    TEST_ASSERT_EQUAL_INT(true, CStringSlice().clone().isInvalid());
+}
+
+void runTestSlice() {
+    const char* prevFile = Unity.TestFile;
+    Unity.TestFile = __FILE__;
+
+    RUN_TEST(testSlice);
+    RUN_TEST(testSliceOutOfRange);
+    RUN_TEST(testSliceFollowsRelocation);
+    RUN_TEST(testSliceInvalidatedByDeallocate);
+    RUN_TEST(testSliceInvalidatedByShrink);
+    RUN_TEST(testSliceOfSlice);
+    RUN_TEST(testSliceSearch);
+    RUN_TEST(testCStringAcceptsSlice);
+    RUN_TEST(testAppendSlice);
+    RUN_TEST(testCloneSlice);
+
+    Unity.TestFile = prevFile;
+}
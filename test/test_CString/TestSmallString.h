@@ -0,0 +1,208 @@
+#include <stdlib.h>
+#include <unity.h>
+#include "CString.h"
+
+void testSmallStringIsInline() {
+    CStringBuffer<16, 1, 4> buffer;
+    CString status = buffer.pushSmall("200 OK");
+    CString method = buffer.pushSmall("GET /index.html", 3);
+    CString empty = buffer.allocateSmall();
+
+    // a CString remains a handle
+    TEST_ASSERT_EQUAL_INT(sizeof(void *) + alignof(void *), sizeof(CString));
+
+    TEST_ASSERT_EQUAL_INT(true, status.isInline());
+    TEST_ASSERT_EQUAL_INT(true, status.isAllocated());
+    TEST_ASSERT_EQUAL_INT(false, status.isInvalid());
+    TEST_ASSERT_EQUAL_INT(INVALID_STRING_IDX, status.bufferIndex());
+    TEST_ASSERT_EQUAL_INT(0, buffer.numstrings());
+    TEST_ASSERT_EQUAL_INT(16, buffer.unallocatedBytes());
+    TEST_ASSERT_EQUAL_INT(14, status.rawMaxLength());
+    TEST_ASSERT_EQUAL_INT(true, empty.isEmpty());
+
+    TEST_ASSERT_EQUAL_STRING("GET", method.raw());
+    TEST_ASSERT_EQUAL_INT(6, status.length());
+    TEST_ASSERT_EQUAL_INT(4, status.indexOf("OK"));
+    TEST_ASSERT_EQUAL_INT(true, status.startsWith("200"));
+    TEST_ASSERT_EQUAL_INT(0, status.compare("200 OK"));
+    TEST_ASSERT_EQUAL_INT(true, status.asStringView() == "200 OK");
+    TEST_ASSERT_EQUAL_INT(true, status.hash() == CString::hash("200 OK"));
+
+    CString regular = buffer.push("GET");
+    TEST_ASSERT_EQUAL_INT(true, regular == method);
+    TEST_ASSERT_EQUAL_INT(0, method.compare(regular));
+    TEST_ASSERT_EQUAL_INT(false, regular.isInline());
+
+    // a longer string is pushed to the buffer
+    TEST_ASSERT_EQUAL_INT(true, buffer.pushSmall("0123456789abcde").isInvalid());
+
+    // the table is full: pushed to the buffer
+    CStringBuffer<16, 1, 1> full;
+    TEST_ASSERT_EQUAL_INT(true, full.pushSmall("a").isInline());
+    CString pushed = full.pushSmall("b");
+    TEST_ASSERT_EQUAL_INT(false, pushed.isInline());
+    TEST_ASSERT_EQUAL_INT(0, pushed.bufferIndex());
+
+    // buffers without table push all strings to the buffer
+    CStringBuffer<16, 1> none;
+    TEST_ASSERT_EQUAL_INT(0, none.pushSmall("a").bufferIndex());
+}
+
+void testSmallStringSpills() {
+    CStringBuffer<32, 2, 2> buffer;
+    CString value = buffer.pushSmall("0123456789");
+    CString other = buffer.push("x");
+
+    value.append("abcd");
+    TEST_ASSERT_EQUAL_INT(true, value.isInline());
+    TEST_ASSERT_EQUAL_INT(1, buffer.numstrings());
+
+    // exceeds the inline capacity: moved to a buffer area on top
+    value.append('e');
+    TEST_ASSERT_EQUAL_INT(false, value.isInline());
+    TEST_ASSERT_EQUAL_STRING("0123456789abcde", value.raw());
+    TEST_ASSERT_EQUAL_INT(1, value.bufferIndex());
+    TEST_ASSERT_EQUAL_STRING("x", other.raw());
+    TEST_ASSERT_EQUAL_INT(true, buffer.peek() == value);
+    TEST_ASSERT_EQUAL_INT(true, buffer.getCString(1) == value);
+
+    // the area of a spilled string is moved and removed as any other
+    TEST_ASSERT_EQUAL_INT(true, other.append("yz").isAllocated());
+    TEST_ASSERT_EQUAL_STRING("0123456789abcde", value.raw());
+    TEST_ASSERT_EQUAL_INT(0, value.bufferIndex());
+    TEST_ASSERT_EQUAL_INT(true, buffer.remove(value));
+    TEST_ASSERT_EQUAL_INT(false, value.isAllocated());
+    TEST_ASSERT_EQUAL_INT(1, buffer.numstrings());
+    TEST_ASSERT_EQUAL_STRING("xyz", other.raw());
+
+    CString formatted = buffer.allocateSmall().appendFormat("%d", 12345);
+    TEST_ASSERT_EQUAL_INT(true, formatted.isInline());
+    TEST_ASSERT_EQUAL_INT(true, formatted.appendFormat("%s", "6789abcdef0123456789abcdef").isInvalid());
+    TEST_ASSERT_EQUAL_STRING("12345", formatted.raw());
+    TEST_ASSERT_EQUAL_INT(true, formatted.isInline());
+
+    // the buffer is exhausted: appends as much as fits inline
+    buffer.allocateRemaining();
+    formatted.appendMost("6789abcdef");
+    TEST_ASSERT_EQUAL_STRING("123456789abcde", formatted.raw());
+    TEST_ASSERT_EQUAL_INT(true, formatted.isInline());
+}
+
+void testSmallStringCopies() {
+    CStringBuffer<64, 2, 4> buffer;
+    CString original = buffer.pushSmall(" Text ");
+    CString copy = original;
+    CString clone = original.clone(1, 4);
+
+    // copies refer to the same string, clones are independent small strings
+    copy.toLower().trim();
+    TEST_ASSERT_EQUAL_STRING("text", copy.raw());
+    TEST_ASSERT_EQUAL_STRING("text", original.raw());
+    TEST_ASSERT_EQUAL_INT(true, clone.isInline());
+    TEST_ASSERT_EQUAL_STRING("Text", clone.raw());
+    clone[0] = 'N';
+    TEST_ASSERT_EQUAL_STRING("Next", clone.raw());
+    TEST_ASSERT_EQUAL_STRING("text", original.raw());
+
+    CString strings[] = {clone, copy};
+    clone.appendJoin(strings, 2, "+");
+    TEST_ASSERT_EQUAL_STRING("NextNext+text", clone.raw());
+    TEST_ASSERT_EQUAL_INT(0, buffer.numstrings());
+
+    // a copy refers to the spilled string as well
+    CString spilled = copy;
+    copy.append(" spilled to the buffer");
+    TEST_ASSERT_EQUAL_INT(false, spilled.isInline());
+    TEST_ASSERT_EQUAL_STRING("text spilled to the buffer", spilled.raw());
+
+    // slices and string views resolve the content through the handle
+    CStringSlice slice = clone.slice(4, 5);
+    TEST_ASSERT_EQUAL_INT(true, slice == "Next+");
+    clone.append(" and more");
+    TEST_ASSERT_EQUAL_INT(false, clone.isInline());
+    clone[8] = '-';
+    TEST_ASSERT_EQUAL_INT(true, slice == "Next-");
+    TEST_ASSERT_EQUAL_INT(true, buffer.pushSmall("view").asStringView() == "view");
+
+    clone.deallocate();
+    TEST_ASSERT_EQUAL_INT(false, clone.isAllocated());
+    CString other = buffer.pushSmall("other");
+    TEST_ASSERT_EQUAL_INT(true, buffer.remove(other));
+    TEST_ASSERT_EQUAL_INT(false, other.isAllocated());
+    TEST_ASSERT_EQUAL_INT(false, buffer.remove(other));
+}
+
+void testSmallStringRemoveAll() {
+    CStringBuffer<32, 2, 2> buffer;
+    CString small = buffer.pushSmall("small");
+    TEST_ASSERT_EQUAL_INT(true, buffer.removeAll());
+    TEST_ASSERT_EQUAL_INT(false, small.isAllocated());
+    TEST_ASSERT_EQUAL_INT(false, buffer.removeAll());
+
+    // entries are reused
+    CString first = buffer.pushSmall("1");
+    CString second = buffer.pushSmall("2");
+    first.deallocate();
+    TEST_ASSERT_EQUAL_INT(true, buffer.pushSmall("3").isInline());
+    TEST_ASSERT_EQUAL_STRING("2", second.raw());
+}
+
+void testSmallStringMoveToTop() {
+    CStringBuffer<16, 2, 1> buffer;
+    CString regular = buffer.push("a");
+    CString small = buffer.pushSmall("x");
+
+    // has no buffer area
+    TEST_ASSERT_EQUAL_INT(false, buffer.moveToTop(small));
+    TEST_ASSERT_EQUAL_INT(1, buffer.numstrings());
+    TEST_ASSERT_EQUAL_STRING("a", regular.raw());
+    TEST_ASSERT_EQUAL_STRING("x", small.raw());
+}
+
+void testSmallStringSameAsRegular() {
+    CStringBuffer<256, 2, 1> buffer;
+    srand(7);
+    for (int step = 0; step < 500; ++step) {
+        buffer.removeAll();
+        CString small = buffer.pushSmall("");
+        CString regular = buffer.push("");
+        for (int i = 0; i < 6; ++i) {
+            char text[8];
+            snprintf(text, sizeof(text), "%.*s", rand() % 6, " aBc-Z");
+            switch (rand() % 4) {
+                case 0:
+                    small.trim();
+                    regular.trim();
+                    break;
+                case 1:
+                    small.toLower();
+                    regular.toLower();
+                    break;
+                default:
+                    small.append(text);
+                    regular.append(text);
+            }
+            TEST_ASSERT_EQUAL_STRING(regular.raw(), small.raw());
+            TEST_ASSERT_EQUAL_INT(0, small.compare(regular));
+            TEST_ASSERT_EQUAL_INT(regular.indexOf("c"), small.indexOf("c"));
+            TEST_ASSERT_EQUAL_INT(true, regular.asStringView() == small.asStringView());
+            // spilled strings remain in the buffer
+            TEST_ASSERT_EQUAL_INT(true, small.isInline() ? small.length() <= CString::INLINE_MAX_LENGTH
+                                                         : small.bufferIndex() != INVALID_STRING_IDX);
+        }
+    }
+}
+
+void runTestSmallString() {
+    const char* prevFile = Unity.TestFile;
+    Unity.TestFile = __FILE__;
+
+    RUN_TEST(testSmallStringIsInline);
+    RUN_TEST(testSmallStringSpills);
+    RUN_TEST(testSmallStringCopies);
+    RUN_TEST(testSmallStringRemoveAll);
+    RUN_TEST(testSmallStringMoveToTop);
+    RUN_TEST(testSmallStringSameAsRegular);
+
+    Unity.TestFile = prevFile;
+}
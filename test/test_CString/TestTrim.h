@@ -137,6 +137,28 @@ void testTrimStartPredicate() {
     TEST_ASSERT_EQUAL_STRING("", s6.raw());
 }
 
+void testTrimStartKeepsFollowingString() {
+    CStringBuffer<30, 2> buffer;
+    CString s1 = buffer.push("0123");
+    CString s2 = buffer.push("4567");
+
+    std::function<bool(const char)> predicateAny = [](const char c) {
+        return true;
+    };
+
+    TEST_ASSERT_EQUAL_STRING("0123", s1.substring(0).raw());
+    TEST_ASSERT_EQUAL_STRING("4567", s2.raw());
+    TEST_ASSERT_EQUAL_STRING("0123", s1.trimStart('x').raw());
+    TEST_ASSERT_EQUAL_STRING("4567", s2.raw());
+    TEST_ASSERT_EQUAL_STRING("123", s1.substring(1).raw());
+    TEST_ASSERT_EQUAL_STRING("4567", s2.raw());
+
+    // the predicate is not applied beyond the terminating \0
+    TEST_ASSERT_EQUAL_STRING("", s1.trimStart(predicateAny).raw());
+    TEST_ASSERT_EQUAL_INT(true, s1.isAllocated());
+    TEST_ASSERT_EQUAL_STRING("4567", s2.raw());
+}
+
 void testTrimEndWhitespace() {
     CStringBuffer<30, 1> buffer;
     CString s1 = buffer.push(" \t\n\v\f\r123\r\f\v\n\t ");
@@ -420,6 +442,7 @@ void runTestTrim() {
     RUN_TEST(testTrimStartSingleCharacter);
     RUN_TEST(testTrimStartCharacterSet);
     RUN_TEST(testTrimStartPredicate);
+    RUN_TEST(testTrimStartKeepsFollowingString);
     RUN_TEST(testTrimEndWhitespace);
     RUN_TEST(testTrimEndSingleCharacter);
     RUN_TEST(testTrimEndCharacterSet);
@@ -0,0 +1,189 @@
+#include <unity.h>
+#include "CString.h"
+
+void testIsValidUtf8() {
+    CStringBuffer<120, 4> buffer;
+    CString ascii = buffer.push("plain ascii text, long enough for the fast path");
+    CString mixed = buffer.push("gr\xC3\xBC\xC3\x9F \xE2\x82\xAC \xF0\x9F\x98\x80");
+    CString truncated = buffer.push("abc\xE2\x82");
+    CString empty = buffer.push("");
+
+    TEST_ASSERT_EQUAL_INT(true, ascii.isValidUtf8());
+    TEST_ASSERT_EQUAL_INT(true, mixed.isValidUtf8());
+    TEST_ASSERT_EQUAL_INT(false, truncated.isValidUtf8());
+    TEST_ASSERT_EQUAL_INT(true, empty.isValidUtf8());
+    TEST_ASSERT_EQUAL_INT(false, CString::INVALID.isValidUtf8());
+}
+
+void testIsValidUtf8RejectsIllFormedSequences() {
+    // overlong, surrogate, above U+10FFFF, stray continuation, invalid lead bytes
+    const char *illFormed[] = {"\xC0\xAF", "\xE0\x9F\xBF", "\xED\xA0\x80", "\xF4\x90\x80\x80", "\x80", "\xF5\x80\x80\x80",
+                               "\xE2\x28\xA1", "\xFF"};
+    for (const char *data : illFormed) {
+        TEST_ASSERT_EQUAL_INT(false, CString::isValidUtf8(data, strlen(data)));
+    }
+
+    const char *wellFormed[] = {"\x7F", "\xC2\x80", "\xE0\xA0\x80", "\xED\x9F\xBF", "\xEE\x80\x80", "\xF0\x90\x80\x80",
+                                "\xF4\x8F\xBF\xBF"};
+    for (const char *data : wellFormed) {
+        TEST_ASSERT_EQUAL_INT(true, CString::isValidUtf8(data, strlen(data)));
+    }
+
+    // non-ASCII byte following a block of 16 ASCII characters
+    TEST_ASSERT_EQUAL_INT(false, CString::isValidUtf8("0123456789abcdef\x80", 17));
+    TEST_ASSERT_EQUAL_INT(true, CString::isValidUtf8("0123456789abcde\xC3\xBC", 17));
+    TEST_ASSERT_EQUAL_INT(false, CString::isValidUtf8(nullptr, 0));
+}
+
+/// @brief Straightforward validation according to the unicode standard (table 3-7).
+static bool isValidUtf8Reference(const uint8_t *s, int length) {
+    for (int i = 0; i < length;) {
+        uint8_t c = s[i];
+        int n = c < 0x80 ? 1 : c >= 0xC2 && c <= 0xDF ? 2 : c >= 0xE0 && c <= 0xEF ? 3 : c >= 0xF0 && c <= 0xF4 ? 4 : 0;
+        if (n == 0 || i + n > length) {
+            return false;
+        }
+        uint8_t min = c == 0xE0 ? 0xA0 : c == 0xF0 ? 0x90 : 0x80;
+        uint8_t max = c == 0xED ? 0x9F : c == 0xF4 ? 0x8F : 0xBF;
+        if (n > 1 && (s[i + 1] < min || s[i + 1] > max)) {
+            return false;
+        }
+        for (int k = 2; k < n; ++k) {
+            if ((s[i + k] & 0xC0) != 0x80) {
+                return false;
+            }
+        }
+        i += n;
+    }
+    return true;
+}
+
+void testIsValidUtf8AtBlockBoundaries() {
+    const char *sequences[] = {"\xE0\xA0\x80", "\xED\x9F\xBF", "\xF0\x90\x80\x80", "\xC3\xBC", "\xE2\x82\xAC",
+                               "\xF0\x9F\x98\x80", "\xF4\x8F\xBF\xBF", "\xC0\xAF", "\xE0\x9F\xBF", "\xED\xA0\x80",
+                               "\xF4\x90\x80\x80", "\x80", "\xFF", "\xE2\x82", "\xF0\x9F\x98", "\xC3"};
+
+    // each sequence at each position within and at the end of 48 bytes, such that it crosses each block boundary
+    uint8_t data[48];
+    for (const char *sequence : sequences) {
+        int sequenceLength = strlen(sequence);
+        for (int length = sequenceLength; length <= (int)sizeof(data); ++length) {
+            for (int offset = 0; offset + sequenceLength <= length; ++offset) {
+                memset(data, 'a', sizeof(data));
+                memcpy(data + offset, sequence, sequenceLength);
+                TEST_ASSERT_EQUAL_INT(isValidUtf8Reference(data, length), CString::isValidUtf8((char *)data, length));
+            }
+        }
+    }
+
+    // random concatenation of well-formed sequences and single bytes breaking them
+    const char *tokens[] = {"x", "yz", "\xC3\xBC", "\xE0\xA0\x80", "\xE2\x82\xAC", "\xED\x9F\xBF", "\xEF\xBF\xBF",
+                            "\xF0\x90\x80\x80", "\xF4\x8F\xBF\xBF", "\x80", "\x9F", "\xA0", "\xC2", "\xE0", "\xED",
+                            "\xF0", "\xF4", "\xF5"};
+    uint32_t random = 12345;
+    uint8_t text[100];
+    for (int round = 0; round < 20000; ++round) {
+        int length = 0;
+        int maxLength = round % 96;
+        while (length < maxLength) {
+            random = random * 1103515245 + 12345;
+            // mostly well-formed: single bytes are picked rarely
+            int token = (random >> 16) % 64 == 0 ? 9 + (random >> 22) % 9 : (random >> 22) % 9;
+            int tokenLength = strlen(tokens[token]);
+            memcpy(text + length, tokens[token], tokenLength);
+            length += tokenLength;
+        }
+        TEST_ASSERT_EQUAL_INT(isValidUtf8Reference(text, length), CString::isValidUtf8((char *)text, length));
+    }
+}
+
+void testCodePointLength() {
+    CStringBuffer<60, 2> buffer;
+    CString s1 = buffer.push("gr\xC3\xBC\xC3\x9F \xE2\x82\xAC \xF0\x9F\x98\x80 and some ascii");
+    CString s2 = buffer.push("");
+
+    TEST_ASSERT_EQUAL_INT(30, s1.length());
+    TEST_ASSERT_EQUAL_INT(23, s1.codePointLength());
+    TEST_ASSERT_EQUAL_INT(0, s2.codePointLength());
+    TEST_ASSERT_EQUAL_INT(-1, CString::INVALID.codePointLength());
+}
+
+void testCodePoints() {
+    CStringBuffer<20, 1> buffer;
+    CString s1 = buffer.push("a\xC3\xBC\x80\xE2\x82\xAC\xF0\x9F\x98\x80");
+    const char32_t expected[] = {'a', 0xFC, 0xFFFD, 0x20AC, 0x1F600};
+    const int expectedIndex[] = {1, 3, 4, 7, 11};
+
+    CStringCodePointIterator it = s1.codePoints();
+    char32_t codePoint;
+    for (int i = 0; i < 5; ++i) {
+        TEST_ASSERT_EQUAL_INT(true, it.next(codePoint));
+        TEST_ASSERT_EQUAL_INT(expected[i], codePoint);
+        TEST_ASSERT_EQUAL_INT(expectedIndex[i], it.index());
+    }
+    TEST_ASSERT_EQUAL_INT(false, it.next(codePoint));
+
+    CStringCodePointIterator fromIndex = s1.codePoints(4);
+    TEST_ASSERT_EQUAL_INT(true, fromIndex.next(codePoint));
+    TEST_ASSERT_EQUAL_INT(0x20AC, codePoint);
+    TEST_ASSERT_EQUAL_INT(false, CString::INVALID.codePoints().next(codePoint));
+    TEST_ASSERT_EQUAL_INT(false, s1.codePoints(12).next(codePoint));
+}
+
+void testAppendMostUtf8() {
+    CStringBuffer<10, 2> buffer;
+    CString s1 = buffer.push("ab");
+
+    // 7 bytes unallocated: the euro sign would be split
+    s1.appendMostUtf8("cde\xC3\xBC\xE2\x82\xAC");
+    TEST_ASSERT_EQUAL_STRING("abcde\xC3\xBC", s1.raw());
+    TEST_ASSERT_EQUAL_INT(true, s1.isValidUtf8());
+
+    CStringBuffer<10, 2> buffer2;
+    CString s2 = buffer2.push("ab");
+    s2.appendMostUtf8(std::string_view("cdefg\xF0\x9F\x98\x80"));
+    TEST_ASSERT_EQUAL_STRING("abcdefg", s2.raw());
+
+    CStringBuffer<10, 2> buffer3;
+    CString s3 = buffer3.push("ab");
+    s3.appendMostUtf8("cdef\xC3\xBC");
+    TEST_ASSERT_EQUAL_STRING("abcdef\xC3\xBC", s3.raw());
+}
+
+void testCloneWithLimitUtf8() {
+    CStringBuffer<40, 4> buffer;
+    CString s1 = buffer.push("a\xE2\x82\xAC" "b");
+
+    TEST_ASSERT_EQUAL_STRING("a", s1.cloneWithLimitUtf8(3).raw());
+    TEST_ASSERT_EQUAL_STRING("a\xE2\x82\xAC", s1.cloneWithLimitUtf8(4).raw());
+    TEST_ASSERT_EQUAL_STRING("\xE2\x82\xAC" "b", s1.cloneWithLimitUtf8(1, 10).raw());
+    TEST_ASSERT_EQUAL_INT(true, s1.cloneWithLimitUtf8(-1).isInvalid());
+}
+
+void testResizeUtf8() {
+    CStringBuffer<20, 1> buffer;
+    CString s1 = buffer.push("a\xE2\x82\xAC" "b");
+
+    TEST_ASSERT_EQUAL_INT(false, s1.resizeUtf8(3).isInvalid());
+    TEST_ASSERT_EQUAL_INT(3, s1.rawMaxLength());
+    TEST_ASSERT_EQUAL_STRING("a", s1.raw());
+    TEST_ASSERT_EQUAL_INT(false, s1.resizeUtf8(10).isInvalid());
+    TEST_ASSERT_EQUAL_STRING("a", s1.raw());
+    TEST_ASSERT_EQUAL_INT(true, s1.resizeUtf8(-1).isInvalid());
+}
+
+void runTestUtf8() {
+    const char* prevFile = Unity.TestFile;
+    Unity.TestFile = __FILE__;
+
+    RUN_TEST(testIsValidUtf8);
+    RUN_TEST(testIsValidUtf8RejectsIllFormedSequences);
+    RUN_TEST(testIsValidUtf8AtBlockBoundaries);
+    RUN_TEST(testCodePointLength);
+    RUN_TEST(testCodePoints);
+    RUN_TEST(testAppendMostUtf8);
+    RUN_TEST(testCloneWithLimitUtf8);
+    RUN_TEST(testResizeUtf8);
+
+    Unity.TestFile = prevFile;
+}
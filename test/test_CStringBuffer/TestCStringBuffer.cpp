@@ -1,6 +1,10 @@
 #include "CString.h"
 #include <unity.h>
 
+#ifdef CSTRING_HAS_WRITEV
+#include <sys/wait.h>
+#endif
+
 void testAllocate() {
     CStringBuffer<10, 1> buffer;
     CString s = buffer.allocate();
@@ -135,6 +139,30 @@ void testAppendToEmptyBufferArea() {
     TEST_ASSERT_EQUAL_INT(0, s1[9]);
 }
 
+void testFormatAccountsRemainingCapacity() {
+    CStringBuffer<32, 2> buffer;
+    TEST_ASSERT_EQUAL_INT(true, buffer.appendToTopmostFormat("%d", 42).isInvalid());
+    TEST_ASSERT_EQUAL_INT(32, buffer.unallocatedBytes());
+
+    CString s1 = buffer.pushFormat("%s", "hello world");
+    TEST_ASSERT_EQUAL_STRING("hello world", s1.raw());
+    TEST_ASSERT_EQUAL_INT(12, buffer.allocatedBytes());
+    TEST_ASSERT_EQUAL_INT(20, buffer.unallocatedBytes());
+
+    TEST_ASSERT_EQUAL_INT(true, buffer.appendToTopmostFormat(" %d", 42).isAllocated());
+    TEST_ASSERT_EQUAL_STRING("hello world 42", s1.raw());
+    TEST_ASSERT_EQUAL_INT(17, buffer.unallocatedBytes());
+
+    TEST_ASSERT_EQUAL_INT(true, s1.appendFormat("%c", '!').isAllocated());
+    TEST_ASSERT_EQUAL_STRING("hello world 42!", s1.raw());
+    TEST_ASSERT_EQUAL_INT(16, buffer.unallocatedBytes());
+    TEST_ASSERT_EQUAL_INT(buffer.capacity(), buffer.allocatedBytes() + buffer.unallocatedBytes());
+
+    // the accounted capacity is actually available
+    TEST_ASSERT_EQUAL_INT(true, buffer.allocate(15).isAllocated());
+    TEST_ASSERT_EQUAL_INT(0, buffer.unallocatedBytes());
+}
+
 void testMoveToTopRemainingCapacityIsMoreThanStringToMove() {
     CStringBuffer<50, 4> buffer;
     CString s1 = buffer.push("1234");
@@ -205,6 +233,41 @@ void testMoveToTopNoChange() {
     TEST_ASSERT_EQUAL_STRING("567", s2.raw());
 }
 
+void testMoveToTopThenPop() {
+    CStringBuffer<9, 2> buffer;
+    CString s1 = buffer.push("1234");
+    CString s2 = buffer.push("567");
+
+    TEST_ASSERT_EQUAL_INT(true, buffer.moveToTop(s1));
+    TEST_ASSERT_EQUAL_INT(true, buffer.pop());
+    TEST_ASSERT_EQUAL_INT(false, s1.isAllocated());
+    TEST_ASSERT_EQUAL_STRING("567", s2.raw());
+    TEST_ASSERT_EQUAL_INT(true, buffer.peek() == s2);
+}
+
+void testMoveToTopThenAppend() {
+    CStringBuffer<20, 3> buffer;
+    CString s1 = buffer.push("12");
+    CString s2 = buffer.push("34");
+
+    // the moved string becomes the topmost one
+    TEST_ASSERT_EQUAL_INT(true, buffer.moveToTop(s1));
+    TEST_ASSERT_EQUAL_INT(true, buffer.peek() == s1);
+    CString appended = buffer.appendToTopmost("5");
+    TEST_ASSERT_EQUAL_INT(true, appended == s1);
+    TEST_ASSERT_EQUAL_STRING("125", s1.raw());
+    CString resized = buffer.resizeTopmost(5);
+    TEST_ASSERT_EQUAL_INT(true, resized == s1);
+    TEST_ASSERT_EQUAL_INT(6, s1.rawCapacity());
+    TEST_ASSERT_EQUAL_STRING("34", s2.raw());
+
+    // new strings are pushed on top of it
+    CString s3 = buffer.push("6");
+    TEST_ASSERT_EQUAL_INT(true, buffer.peek() == s3);
+    TEST_ASSERT_EQUAL_INT(true, buffer.pop());
+    TEST_ASSERT_EQUAL_INT(true, buffer.peek() == s1);
+}
+
 void testIncreaseSize() {
     CStringBuffer<10, 2> buffer;
     CString s1 = buffer.push("12345");
@@ -332,6 +395,263 @@ void testRemoveLastString() {
     TEST_ASSERT_EQUAL_STRING(0, s4.raw());
 }
 
+void testSerialize() {
+    CStringBuffer<50, 4> buffer;
+    CString s1 = buffer.push("1234");
+    CString s2 = buffer.allocate(8);
+    s2 += "567";
+    buffer.push("");
+    buffer.moveToTop(s1);
+
+    char image[100];
+    int imageLength = 0;
+    int serializedLength = buffer.serialize([&](const char *data, int length) {
+        memcpy(image + imageLength, data, length);
+        imageLength += length;
+        return true;
+    });
+    // magic, 3 header varints, 3 table varints, 15 data bytes
+    TEST_ASSERT_EQUAL_INT(4 + 3 + 3 + 15, serializedLength);
+    TEST_ASSERT_EQUAL_INT(serializedLength, imageLength);
+
+    // restore into a smaller buffer replacing its content
+    CStringBuffer<16, 3> restored;
+    restored.push("old");
+    TEST_ASSERT_EQUAL_INT(true, restored.deserialize(image, imageLength));
+    TEST_ASSERT_EQUAL_INT(3, restored.numstrings());
+    TEST_ASSERT_EQUAL_INT(1, restored.unallocatedBytes());
+    TEST_ASSERT_EQUAL_STRING("567", restored.getRawString(0));
+    TEST_ASSERT_EQUAL_INT(9, restored.getRawStringCapacity(0));
+    TEST_ASSERT_EQUAL_STRING("", restored.getRawString(1));
+    TEST_ASSERT_EQUAL_STRING("1234", restored.peek().raw());
+
+    // restored strings behave like pushed ones
+    TEST_ASSERT_EQUAL_STRING("1234!", restored.peek().append("!").raw());
+    TEST_ASSERT_EQUAL_INT(true, restored.remove(0));
+    TEST_ASSERT_EQUAL_STRING("X", restored.push("X").raw());
+    TEST_ASSERT_EQUAL_STRING("1234!", restored.getRawString(1));
+
+    // empty buffer
+    CStringBuffer<8, 1> empty;
+    imageLength = 0;
+    TEST_ASSERT_EQUAL_INT(7, empty.serialize([&](const char *data, int length) {
+        memcpy(image + imageLength, data, length);
+        imageLength += length;
+        return true;
+    }));
+    TEST_ASSERT_EQUAL_INT(true, restored.deserialize(image, imageLength));
+    TEST_ASSERT_EQUAL_INT(0, restored.numstrings());
+    TEST_ASSERT_EQUAL_INT(16, restored.unallocatedBytes());
+
+    TEST_ASSERT_EQUAL_INT(-1, buffer.serialize([](const char *data, int length) { return false; }));
+}
+
+void testDeserializeInvalidImage() {
+    CStringBuffer<50, 4> buffer;
+    buffer.push("1234");
+    buffer.push("567");
+    char image[100];
+    int imageLength = 0;
+    buffer.serialize([&](const char *data, int length) {
+        memcpy(image + imageLength, data, length);
+        imageLength += length;
+        return true;
+    });
+
+    CStringBuffer<50, 4> restored;
+    restored.push("unchanged");
+
+    // truncated
+    for (int length = 0; length < imageLength; ++length) {
+        TEST_ASSERT_EQUAL_INT(false, restored.deserialize(image, length));
+    }
+    TEST_ASSERT_EQUAL_INT(false, restored.deserialize(nullptr, imageLength));
+
+    // too few strings or bytes
+    CStringBuffer<50, 1> fewStrings;
+    TEST_ASSERT_EQUAL_INT(false, fewStrings.deserialize(image, imageLength));
+    CStringBuffer<8, 4> fewBytes;
+    TEST_ASSERT_EQUAL_INT(false, fewBytes.deserialize(image, imageLength));
+
+    // capacities not matching data length: header 7 bytes, table 2 bytes
+    image[7] = 4;
+    TEST_ASSERT_EQUAL_INT(false, restored.deserialize(image, imageLength));
+    image[7] = 5;
+
+    // buffer area not terminated by \0
+    image[13] = 'x';
+    TEST_ASSERT_EQUAL_INT(false, restored.deserialize(image, imageLength));
+    image[13] = '\0';
+
+    // varint exceeding 32 bits: 2^32 strings, not truncated to 0
+    const char overflow[] = {'C', 'S', 'B', 1, (char)0x80, (char)0x80, (char)0x80, (char)0x80, 0x10, 0, 0};
+    TEST_ASSERT_EQUAL_INT(false, restored.deserialize(overflow, sizeof(overflow)));
+    const char maximum[] = {'C', 'S', 'B', 1, (char)0xFF, (char)0xFF, (char)0xFF, (char)0xFF, 0x0F, 0, 0};
+    TEST_ASSERT_EQUAL_INT(false, restored.deserialize(maximum, sizeof(maximum)));
+    TEST_ASSERT_EQUAL_INT(1, restored.numstrings());
+
+    // wrong magic
+    image[0] = 'X';
+    TEST_ASSERT_EQUAL_INT(false, restored.deserialize(image, imageLength));
+    image[0] = 'C';
+
+    TEST_ASSERT_EQUAL_INT(1, restored.numstrings());
+    TEST_ASSERT_EQUAL_STRING("unchanged", restored.getRawString(0));
+    TEST_ASSERT_EQUAL_INT(true, restored.deserialize(image, imageLength));
+    TEST_ASSERT_EQUAL_STRING("567", restored.getRawString(1));
+}
+
+void testCompact() {
+    CStringBuffer<20, 4> buffer;
+    CString s1 = buffer.push("1234");
+    CString s2 = buffer.push("567");
+    CString s3 = buffer.push("89");
+    s1.substring(2);
+    s2.clear();
+    TEST_ASSERT_EQUAL_INT(8, buffer.unallocatedBytes());
+
+    TEST_ASSERT_EQUAL_INT(5, buffer.compact());
+    TEST_ASSERT_EQUAL_INT(13, buffer.unallocatedBytes());
+    TEST_ASSERT_EQUAL_STRING("34", s1.raw());
+    TEST_ASSERT_EQUAL_INT(3, s1.rawCapacity());
+    TEST_ASSERT_EQUAL_STRING("", s2.raw());
+    TEST_ASSERT_EQUAL_INT(1, s2.rawCapacity());
+    TEST_ASSERT_EQUAL_STRING("89", s3.raw());
+    TEST_ASSERT_EQUAL_PTR(s2.raw() + 1, s3.raw());
+
+    // topmost string grows into the released bytes
+    TEST_ASSERT_EQUAL_STRING("89abcdef", s3.append("abcdef").raw());
+    TEST_ASSERT_EQUAL_INT(0, buffer.compact());
+}
+
+void testReserveTail() {
+    CStringBuffer<100, 4> buffer;
+    CString s1 = buffer.push("1234");
+
+    char *first = (char *)buffer.reserveTail(10);
+    TEST_ASSERT_NOT_NULL(first);
+    TEST_ASSERT_EQUAL_INT(0, (uintptr_t)first % alignof(std::max_align_t));
+    char *second = (char *)buffer.reserveTail(3, 64);
+    TEST_ASSERT_NOT_NULL(second);
+    TEST_ASSERT_EQUAL_INT(0, (uintptr_t)second % 64);
+    TEST_ASSERT_EQUAL_INT(true, second < first);
+    TEST_ASSERT_EQUAL_INT(buffer.capacity() - 5, buffer.unallocatedBytes() + buffer.reservedTailBytes());
+    TEST_ASSERT_NULL(buffer.reserveTail(100));
+    TEST_ASSERT_NULL(buffer.reserveTail(1, 3));
+    memset(first, 'x', 10);
+    memset(second, 'y', 3);
+
+    // strings are limited to the unallocated area
+    int unallocated = buffer.unallocatedBytes();
+    TEST_ASSERT_EQUAL_INT(true, buffer.allocate(unallocated).isInvalid());
+    TEST_ASSERT_EQUAL_INT(true, buffer.allocate(unallocated - 1).isAllocated());
+    TEST_ASSERT_EQUAL_INT(0, buffer.unallocatedBytes());
+    buffer.pop();
+    TEST_ASSERT_EQUAL_INT(true, s1.appendFormat("%0*d", unallocated + 1, 0).isInvalid());
+    TEST_ASSERT_EQUAL_STRING("1234", s1.raw());
+    TEST_ASSERT_EQUAL_INT('x', first[9]);
+    TEST_ASSERT_EQUAL_INT('y', second[2]);
+
+    // released in reverse order only
+    TEST_ASSERT_EQUAL_INT(false, buffer.releaseTail(first, 10));
+    TEST_ASSERT_EQUAL_INT(true, buffer.releaseTail(second, 3));
+    TEST_ASSERT_EQUAL_INT(unallocated + alignof(std::max_align_t), buffer.unallocatedBytes());
+    buffer.removeAll();
+    TEST_ASSERT_EQUAL_INT('x', first[9]);
+    buffer.releaseTail();
+    TEST_ASSERT_EQUAL_INT(0, buffer.reservedTailBytes());
+    TEST_ASSERT_EQUAL_INT(buffer.capacity(), buffer.unallocatedBytes());
+}
+
+#ifdef CSTRING_HAS_WRITEV
+int readAll(int fd, char *dst, int capacity) {
+    int total = 0;
+    for (int n; total < capacity && (n = read(fd, dst + total, capacity - total)) > 0;) {
+        total += n;
+    }
+    return total;
+}
+
+void testWriteTo() {
+    CStringBuffer<40, 4> buffer;
+    buffer.push("first");
+    buffer.push("");
+    buffer.push("third");
+    buffer.push(10).append("fourth");
+
+    int fds[2];
+    TEST_ASSERT_EQUAL_INT(0, pipe(fds));
+    TEST_ASSERT_EQUAL_INT(20, buffer.writeTo(fds[1], "\n"));
+    TEST_ASSERT_EQUAL_INT(16, buffer.writeRange(0, 4, fds[1]));
+    TEST_ASSERT_EQUAL_INT(15, buffer.writeRange(2, 4, fds[1], ", "));
+    TEST_ASSERT_EQUAL_INT(0, buffer.writeRange(1, 1, fds[1], ", "));
+    close(fds[1]);
+
+    char result[64];
+    int length = readAll(fds[0], result, sizeof(result));
+    close(fds[0]);
+    TEST_ASSERT_EQUAL_INT(51, length);
+    TEST_ASSERT_EQUAL_STRING_LEN("first\n\nthird\nfourth\nfirstthirdfourththird, fourth, ", result, 51);
+
+    TEST_ASSERT_EQUAL_INT(-1, buffer.writeRange(2, 1, 1));
+    TEST_ASSERT_EQUAL_INT(-1, buffer.writeRange(0, 5, 1));
+    TEST_ASSERT_EQUAL_INT(-1, buffer.writeTo(-1));
+}
+
+void testWriteToUnterminatedString() {
+    CStringBuffer<20, 2> buffer;
+    CString first = buffer.push("abc");
+    buffer.push("de");
+
+    // terminating \0 overwritten: at most rawMaxLength characters are written
+    first.raw()[3] = 'x';
+    int fds[2];
+    TEST_ASSERT_EQUAL_INT(0, pipe(fds));
+    TEST_ASSERT_EQUAL_INT(7, buffer.writeTo(fds[1], "\n"));
+    close(fds[1]);
+
+    char result[16];
+    int length = readAll(fds[0], result, sizeof(result));
+    close(fds[0]);
+    TEST_ASSERT_EQUAL_INT(7, length);
+    TEST_ASSERT_EQUAL_STRING_LEN("abc\nde\n", result, 7);
+}
+
+void testWriteToLargerThanPipeCapacity() {
+    // more data than a pipe accepts at once: partial writes need to be continued
+    static CStringBuffer<200000, 3> buffer;
+    for (int i = 0; i < 3; ++i) {
+        char *s = buffer.push(60000).raw();
+        for (int j = 0; j < 60000; ++j) {
+            s[j] = (char)('a' + (i + j) % 26);
+        }
+        s[60000] = '\0';
+    }
+
+    int fds[2];
+    TEST_ASSERT_EQUAL_INT(0, pipe(fds));
+    pid_t reader = fork();
+    if (reader == 0) {
+        close(fds[1]);
+        static char result[200000];
+        int length = readAll(fds[0], result, sizeof(result));
+        bool isValid = length == 180003;
+        for (int i = 0; isValid && i < 3; ++i) {
+            isValid = memcmp(result + i * 60001, buffer.getRawString(i), 60000) == 0 && result[i * 60001 + 60000] == '|';
+        }
+        _exit(isValid ? 0 : 1);
+    }
+
+    close(fds[0]);
+    TEST_ASSERT_EQUAL_INT(180003, buffer.writeTo(fds[1], "|"));
+    close(fds[1]);
+
+    int status = -1;
+    waitpid(reader, &status, 0);
+    TEST_ASSERT_EQUAL_INT(0, status);
+}
+#endif
+
 void setUp() {};
 void tearDown() {};
 
@@ -347,15 +667,27 @@ int main(int argc, char **argv)
     RUN_TEST(testAppendEmptyStringWithBufferCompletelyAllocated);
     RUN_TEST(testAppendNonEmptyStringWithBufferCompletelyAllocated);
     RUN_TEST(testAppendToEmptyBufferArea);
+    RUN_TEST(testFormatAccountsRemainingCapacity);
     RUN_TEST(testMoveToTopRemainingCapacityIsMoreThanStringToMove);
     RUN_TEST(testMoveToTopNoCapacityRemaining);
     RUN_TEST(testMoveToTopNoChange);
+    RUN_TEST(testMoveToTopThenPop);
+    RUN_TEST(testMoveToTopThenAppend);
     RUN_TEST(testIncreaseSize);
     RUN_TEST(testReduceSizeShortenString);
     RUN_TEST(testReduceSizeShrinkToFit);
     RUN_TEST(testIncreaseSizeBeyondCapacity);
     RUN_TEST(testRemoveFirstString);
     RUN_TEST(testRemoveLastString);
+    RUN_TEST(testSerialize);
+    RUN_TEST(testDeserializeInvalidImage);
+    RUN_TEST(testCompact);
+    RUN_TEST(testReserveTail);
+#ifdef CSTRING_HAS_WRITEV
+    RUN_TEST(testWriteTo);
+    RUN_TEST(testWriteToUnterminatedString);
+    RUN_TEST(testWriteToLargerThanPipeCapacity);
+#endif
 
     return UNITY_END();
 }
\ No newline at end of file
@@ -0,0 +1,130 @@
+#include "CStringBufferPool.h"
+#include <unity.h>
+
+#ifdef CSTRING_HAS_ATOMIC
+#include <thread>
+
+typedef CStringBufferPool<CStringBuffer<64, 4>, 2> Pool;
+
+void testAcquireAndRecycle() {
+    Pool pool;
+    CStringBuffer<64, 4> *first = pool.acquire();
+    CStringBuffer<64, 4> *second = pool.acquire();
+    TEST_ASSERT_NOT_NULL(first);
+    TEST_ASSERT_NOT_NULL(second);
+    TEST_ASSERT_EQUAL_INT(true, first != second);
+    TEST_ASSERT_NULL(pool.acquire());
+
+    first->push("content");
+    TEST_ASSERT_EQUAL_INT(true, pool.recycle(first));
+    CStringBuffer<64, 4> *recycled = pool.acquire();
+    TEST_ASSERT_EQUAL_PTR(first, recycled);
+    TEST_ASSERT_EQUAL_INT(0, recycled->numstrings());
+
+    CStringBuffer<64, 4> foreign;
+    TEST_ASSERT_EQUAL_INT(false, pool.recycle(&foreign));
+    TEST_ASSERT_EQUAL_INT(false, pool.handoff(&foreign));
+    TEST_ASSERT_EQUAL_INT(false, pool.handoff(nullptr));
+}
+
+void testHandoff() {
+    Pool pool;
+    Pool::Batch batch;
+    TEST_ASSERT_EQUAL_INT(false, pool.receive(batch));
+
+    CStringBuffer<64, 4> *first = pool.acquire();
+    CString line = first->push("line 1");
+    first->push("line 2");
+    CStringBuffer<64, 4> *second = pool.acquire();
+    second->push("a");
+    second->push("b");
+    second->push("c");
+
+    TEST_ASSERT_EQUAL_INT(true, pool.handoff(first));
+    TEST_ASSERT_EQUAL_INT(false, pool.handoff(second, 2, 4));
+    TEST_ASSERT_EQUAL_INT(false, pool.handoff(second, 2, 1));
+    TEST_ASSERT_EQUAL_INT(true, pool.handoff(second, 1, 3));
+
+    // received in order of handoff, strings are read in place
+    TEST_ASSERT_EQUAL_INT(true, pool.receive(batch));
+    TEST_ASSERT_EQUAL_PTR(first, batch.buffer);
+    TEST_ASSERT_EQUAL_INT(0, batch.first);
+    TEST_ASSERT_EQUAL_INT(2, batch.last);
+    TEST_ASSERT_EQUAL_PTR(line.raw(), batch.buffer->getRawString(0));
+    pool.recycle(batch.buffer);
+
+    TEST_ASSERT_EQUAL_INT(true, pool.receive(batch));
+    TEST_ASSERT_EQUAL_PTR(second, batch.buffer);
+    TEST_ASSERT_EQUAL_INT(1, batch.first);
+    TEST_ASSERT_EQUAL_INT(3, batch.last);
+    TEST_ASSERT_EQUAL_STRING("b", batch.buffer->getRawString(batch.first));
+    TEST_ASSERT_EQUAL_INT(false, pool.receive(batch));
+}
+
+void testConcurrentHandoff() {
+    constexpr int numThreads = 4;
+    constexpr int numBatches = 1000;
+    static CStringBufferPool<CStringBuffer<256, 8>, 4> pool;
+
+    std::thread producers[numThreads];
+    for (int t = 0; t < numThreads; ++t) {
+        producers[t] = std::thread([t] {
+            for (int i = 0; i < numBatches;) {
+                CStringBuffer<256, 8> *buffer = pool.acquire();
+                if (buffer == nullptr) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                for (int j = 0; j < 8; ++j) {
+                    buffer->pushFormat("%d %d %d", t, i, j);
+                }
+                pool.handoff(buffer);
+                i++;
+            }
+        });
+    }
+
+    int next[numThreads]{};
+    for (int received = 0; received < numThreads * numBatches;) {
+        CStringBufferPool<CStringBuffer<256, 8>, 4>::Batch batch;
+        if (!pool.receive(batch)) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        int t, i, j;
+        TEST_ASSERT_EQUAL_INT(8, batch.last);
+        for (int k = batch.first; k < batch.last; ++k) {
+            TEST_ASSERT_EQUAL_INT(3, sscanf(batch.buffer->getRawString(k), "%d %d %d", &t, &i, &j));
+            TEST_ASSERT_EQUAL_INT(next[t], i);
+            TEST_ASSERT_EQUAL_INT(k, j);
+        }
+        next[t]++;
+        pool.recycle(batch.buffer);
+        received++;
+    }
+
+    for (std::thread &producer : producers) {
+        producer.join();
+    }
+}
+#endif
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+
+#ifdef CSTRING_HAS_ATOMIC
+    RUN_TEST(testAcquireAndRecycle);
+    RUN_TEST(testHandoff);
+    RUN_TEST(testConcurrentHandoff);
+#endif
+
+    return UNITY_END();
+}
@@ -0,0 +1,99 @@
+#include "CStringBufferResource.h"
+#include <unity.h>
+
+#ifdef CSTRING_HAS_PMR
+#include <new>
+#include <string>
+#include <vector>
+
+typedef CStringBuffer<1024, 8> Buffer;
+
+void testContainersShareBuffer() {
+    Buffer buffer;
+    CString s1 = buffer.push("header");
+    CStringBufferResource<Buffer> resource(buffer);
+    {
+        std::pmr::vector<int> numbers(&resource);
+        numbers.reserve(16);
+        for (int i = 0; i < 16; ++i) {
+            numbers.push_back(i);
+        }
+        std::pmr::string text("a string exceeding small string optimization", &resource);
+
+        char *begin = buffer.unallocatedArea();
+        char *end = begin + buffer.unallocatedBytes() + buffer.reservedTailBytes();
+        TEST_ASSERT_EQUAL_INT(true, (char *)numbers.data() >= begin && (char *)numbers.data() < end);
+        TEST_ASSERT_EQUAL_INT(true, text.data() >= begin && text.data() < end);
+        TEST_ASSERT_EQUAL_INT(0, (uintptr_t)numbers.data() % alignof(int));
+
+        // strings and containers do not overlap
+        CString s2 = buffer.allocate(buffer.unallocatedBytes() - 1);
+        TEST_ASSERT_EQUAL_INT(true, s2.isAllocated());
+        memset(s2.raw(), 'x', s2.rawCapacity() - 1);
+        TEST_ASSERT_EQUAL_INT(15, numbers[15]);
+        TEST_ASSERT_EQUAL_STRING("a string exceeding small string optimization", text.c_str());
+        TEST_ASSERT_EQUAL_STRING("header", s1.raw());
+        buffer.pop();
+    }
+
+    // released in reverse order of allocation
+    TEST_ASSERT_EQUAL_INT(true, buffer.reservedTailBytes() < (int)alignof(std::max_align_t));
+    resource.release();
+    TEST_ASSERT_EQUAL_INT(0, buffer.reservedTailBytes());
+    TEST_ASSERT_EQUAL_INT(buffer.capacity() - 7, buffer.unallocatedBytes());
+}
+
+void testGrowingContainer() {
+    Buffer buffer;
+    CStringBufferResource<Buffer> resource(buffer);
+    std::pmr::vector<char> bytes(&resource);
+    for (int i = 0; i < 200; ++i) {
+        bytes.push_back((char)i);
+    }
+    TEST_ASSERT_EQUAL_INT(199, (uint8_t)bytes[199]);
+
+    // growing vector: previous allocations are deferred
+    TEST_ASSERT_EQUAL_INT(true, buffer.reservedTailBytes() > 256);
+    TEST_ASSERT_EQUAL_INT(true, buffer.push("string").isAllocated());
+}
+
+void testExhausted() {
+    CStringBuffer<64, 2> buffer;
+    CStringBufferResource<CStringBuffer<64, 2>> resource(buffer);
+    std::pmr::vector<char> bytes(&resource);
+
+    bool thrown = false;
+    try {
+        bytes.resize(100);
+    } catch (const std::bad_alloc &) {
+        thrown = true;
+    }
+    TEST_ASSERT_EQUAL_INT(true, thrown);
+
+    // falls back to the upstream resource
+    CStringBufferResource<CStringBuffer<64, 2>> fallback(buffer, std::pmr::new_delete_resource());
+    std::pmr::vector<char> large(100, 'x', &fallback);
+    std::pmr::vector<char> small(10, 'y', &fallback);
+    TEST_ASSERT_EQUAL_INT(true, large.data() < (char *)&buffer || large.data() >= (char *)(&buffer + 1));
+    TEST_ASSERT_EQUAL_INT(true, small.data() >= (char *)&buffer && small.data() < (char *)(&buffer + 1));
+}
+#endif
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+
+#ifdef CSTRING_HAS_PMR
+    RUN_TEST(testContainersShareBuffer);
+    RUN_TEST(testGrowingContainer);
+    RUN_TEST(testExhausted);
+#endif
+
+    return UNITY_END();
+}
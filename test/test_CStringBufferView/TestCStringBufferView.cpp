@@ -0,0 +1,251 @@
+#include "CStringBufferView.h"
+#include <unity.h>
+#include <stdlib.h>
+
+void testCreateOnCallerMemory() {
+    char data[32];
+    alignas(4) char metadata[CStringBufferView::metadataSize(4)];
+    CStringBufferView buffer(data, sizeof(data), metadata, sizeof(metadata), 4);
+    TEST_ASSERT_EQUAL_INT(true, buffer.isAttached());
+    TEST_ASSERT_EQUAL_INT(32, buffer.capacity());
+    TEST_ASSERT_EQUAL_INT(4, buffer.remainingStrings());
+
+    CString a = buffer.push("a");
+    CString b = buffer.push("bb");
+    CString c = buffer.pushFormat("%d", 333);
+    TEST_ASSERT_EQUAL_PTR(data, a.raw());
+    TEST_ASSERT_EQUAL_STRING("333", c.raw());
+    TEST_ASSERT_EQUAL_INT(2 + 3 + 4, buffer.allocatedBytes());
+
+    a += "aa";
+    TEST_ASSERT_EQUAL_STRING("aaa", a.raw());
+    TEST_ASSERT_EQUAL_INT(2, a.bufferIndex());
+    TEST_ASSERT_EQUAL_INT(true, buffer.remove(b));
+    TEST_ASSERT_EQUAL_INT(false, b.isAllocated());
+    TEST_ASSERT_EQUAL_STRING("333", c.raw());
+    TEST_ASSERT_EQUAL_INT(true, buffer.push("too long for the remaining capacity").isInvalid());
+
+    buffer.detach();
+    TEST_ASSERT_EQUAL_INT(false, buffer.isAttached());
+    TEST_ASSERT_EQUAL_INT(false, c.isAllocated());
+    TEST_ASSERT_EQUAL_INT(0, buffer.capacity());
+    TEST_ASSERT_EQUAL_INT(true, buffer.push("x").isInvalid());
+}
+
+void testCreateRejectsInvalidRegions() {
+    char data[16];
+    alignas(4) char metadata[CStringBufferView::metadataSize(4) + 1];
+    CStringBufferView buffer;
+
+    TEST_ASSERT_EQUAL_INT(false, buffer.create(nullptr, 16, metadata, sizeof(metadata), 4));
+    TEST_ASSERT_EQUAL_INT(false, buffer.create(data, 0, metadata, sizeof(metadata), 4));
+    TEST_ASSERT_EQUAL_INT(false, buffer.create(data, 16, nullptr, sizeof(metadata), 4));
+    TEST_ASSERT_EQUAL_INT(false, buffer.create(data, 16, metadata, sizeof(metadata) - 2, 4));
+    TEST_ASSERT_EQUAL_INT(false, buffer.create(data, 16, metadata + 1, sizeof(metadata) - 1, 4));
+    TEST_ASSERT_EQUAL_INT(false, buffer.create(data, 16, metadata, sizeof(metadata), 0));
+    TEST_ASSERT_EQUAL_INT(false, buffer.isAttached());
+    TEST_ASSERT_EQUAL_INT(true, buffer.create(data, 16, metadata, sizeof(metadata), 4));
+}
+
+void testAttachAtOtherAddress() {
+    char data[64];
+    alignas(4) char metadata[CStringBufferView::metadataSize(8)];
+    CStringBufferView buffer(data, sizeof(data), metadata, sizeof(metadata), 8);
+    buffer.push("first");
+    buffer.push("second");
+    buffer.push("third");
+    buffer.remove(1);
+
+    // regions copied elsewhere, e.g. into shared memory
+    char copiedData[64];
+    alignas(4) char copiedMetadata[sizeof(metadata)];
+    memcpy(copiedData, data, sizeof(data));
+    memcpy(copiedMetadata, metadata, sizeof(metadata));
+
+    CStringBufferView attached;
+    TEST_ASSERT_EQUAL_INT(true, attached.attach(copiedData, sizeof(copiedData), copiedMetadata, sizeof(copiedMetadata)));
+    TEST_ASSERT_EQUAL_INT(2, attached.numstrings());
+    TEST_ASSERT_EQUAL_PTR(copiedData, attached.getRawString(0));
+    TEST_ASSERT_EQUAL_STRING("third", attached.peek().raw());
+    TEST_ASSERT_EQUAL_STRING("third!", attached.peek().append("!").raw());
+    TEST_ASSERT_EQUAL_STRING("third", buffer.peek().raw());
+
+    // capacity and metadata must match
+    TEST_ASSERT_EQUAL_INT(false, attached.attach(copiedData, 32, copiedMetadata, sizeof(copiedMetadata)));
+    TEST_ASSERT_EQUAL_INT(false, attached.attach(copiedData, 64, copiedMetadata, sizeof(copiedMetadata) - 1));
+    uint32_t *offsets = (uint32_t *)(copiedMetadata + 16);
+    offsets[2] = 65;
+    TEST_ASSERT_EQUAL_INT(false, attached.attach(copiedData, 64, copiedMetadata, sizeof(copiedMetadata)));
+    TEST_ASSERT_EQUAL_INT(false, attached.isAttached());
+}
+
+void testSameSemanticsAsCStringBuffer() {
+    CStringBuffer<128, 8> expected;
+    char data[128];
+    alignas(4) char metadata[CStringBufferView::metadataSize(8)];
+    CStringBufferView actual(data, sizeof(data), metadata, sizeof(metadata), 8);
+    CString expectedStrings[8];
+    CString actualStrings[8];
+
+    srand(42);
+    for (int step = 0; step < 5000; ++step) {
+        int slot = rand() % 8;
+        char text[24];
+        snprintf(text, sizeof(text), "%.*s", rand() % 20, "abcdefghijklmnopqrstuvwxyz");
+        switch (rand() % 5) {
+            case 0:
+                expectedStrings[slot] = expected.push(text);
+                actualStrings[slot] = actual.push(text);
+                break;
+            case 1:
+                expectedStrings[slot].append(text);
+                actualStrings[slot].append(text);
+                break;
+            case 2:
+                expected.remove(expectedStrings[slot]);
+                actual.remove(actualStrings[slot]);
+                break;
+            case 3:
+                expectedStrings[slot].trimStart("abc");
+                actualStrings[slot].trimStart("abc");
+                break;
+            default:
+                expected.moveToTop(expectedStrings[slot]);
+                actual.moveToTop(actualStrings[slot]);
+        }
+
+        TEST_ASSERT_EQUAL_INT(expected.numstrings(), actual.numstrings());
+        TEST_ASSERT_EQUAL_INT(expected.unallocatedBytes(), actual.unallocatedBytes());
+        for (int i = 0; i < expected.numstrings(); ++i) {
+            TEST_ASSERT_EQUAL_STRING(expected.getRawString(i), actual.getRawString(i));
+            TEST_ASSERT_EQUAL_INT(expected.getRawStringCapacity(i), actual.getRawStringCapacity(i));
+        }
+        for (int i = 0; i < 8; ++i) {
+            TEST_ASSERT_EQUAL_INT(expectedStrings[i].isAllocated(), actualStrings[i].isAllocated());
+        }
+    }
+}
+
+void testSharesAndSmallStrings() {
+    char data[48];
+    alignas(4) char metadata[CStringBufferView::metadataSize(4, 2)];
+    CStringBufferView buffer(data, sizeof(data), metadata, sizeof(metadata), 4, 2);
+    CString source = buffer.push("Shared");
+    CString clone = source.cloneShared();
+    CString small = buffer.pushSmall("small");
+    TEST_ASSERT_EQUAL_PTR(source.raw(), clone.raw());
+    TEST_ASSERT_EQUAL_INT(true, small.isInline());
+    TEST_ASSERT_EQUAL_INT(1, buffer.numstrings());
+
+    // sharers and small strings are part of the metadata
+    char copiedData[48];
+    alignas(4) char copiedMetadata[sizeof(metadata)];
+    memcpy(copiedData, data, sizeof(data));
+    memcpy(copiedMetadata, metadata, sizeof(metadata));
+    CStringBufferView attached;
+    TEST_ASSERT_EQUAL_INT(true, attached.attach(copiedData, sizeof(copiedData), copiedMetadata, sizeof(copiedMetadata)));
+    TEST_ASSERT_EQUAL_INT(1, attached.numstrings());
+    TEST_ASSERT_EQUAL_STRING("shared", attached.getCString(0).toLower().raw());
+    TEST_ASSERT_EQUAL_INT(2, attached.numstrings());
+    memcpy(copiedData, data, sizeof(data));
+    memcpy(copiedMetadata, metadata, sizeof(metadata));
+
+    // copies on write
+    clone.toLower();
+    TEST_ASSERT_EQUAL_STRING("shared", clone.raw());
+    TEST_ASSERT_EQUAL_STRING("Shared", source.raw());
+    TEST_ASSERT_EQUAL_INT(2, buffer.numstrings());
+    small.append(" string spilled");
+    TEST_ASSERT_EQUAL_INT(false, small.isInline());
+    TEST_ASSERT_EQUAL_STRING("small string spilled", small.raw());
+
+    // the number of sharers must match the handles
+    uint8_t *sharers = (uint8_t *)copiedMetadata + 16 + 4 * 5 + 6;
+    sharers[0] = 0;
+    TEST_ASSERT_EQUAL_INT(false, attached.attach(copiedData, 48, copiedMetadata, sizeof(copiedMetadata)));
+    sharers[0] = 1;
+    TEST_ASSERT_EQUAL_INT(true, attached.attach(copiedData, 48, copiedMetadata, sizeof(copiedMetadata)));
+}
+
+void testReserveTailAndUnallocated() {
+    alignas(std::max_align_t) char data[64];
+    alignas(4) char metadata[CStringBufferView::metadataSize(4)];
+    CStringBufferView buffer(data, sizeof(data), metadata, sizeof(metadata), 4);
+    buffer.push("  padded  ");
+
+    void *reserved = buffer.reserveTail(16);
+    TEST_ASSERT_EQUAL_PTR(data + 64 - 16, reserved);
+    TEST_ASSERT_EQUAL_INT(64 - 16 - 11, buffer.unallocatedBytes());
+
+    // data read into the unallocated area
+    memcpy(buffer.unallocatedArea(), "line", 4);
+    CString line = buffer.pushUnallocated(4);
+    TEST_ASSERT_EQUAL_STRING("line", line.raw());
+    TEST_ASSERT_EQUAL_INT(true, buffer.pushUnallocated(64 - 16 - 16).isInvalid());
+
+    TEST_ASSERT_EQUAL_INT(true, buffer.getCString(0).trim().isAllocated());
+    TEST_ASSERT_EQUAL_INT(4, buffer.compact());
+    TEST_ASSERT_EQUAL_STRING("padded", buffer.getRawString(0));
+    TEST_ASSERT_EQUAL_STRING("line", line.raw());
+    TEST_ASSERT_EQUAL_INT(64 - 16 - 12, buffer.unallocatedBytes());
+
+    TEST_ASSERT_EQUAL_INT(true, buffer.releaseTail(reserved, 16));
+    TEST_ASSERT_EQUAL_INT(64 - 12, buffer.unallocatedBytes());
+
+    // a detached view reserves nothing
+    buffer.detach();
+    TEST_ASSERT_EQUAL_PTR(nullptr, buffer.reserveTail(1));
+}
+
+void testSerializeAcrossBufferTypes() {
+    char data[64];
+    alignas(4) char metadata[CStringBufferView::metadataSize(4)];
+    CStringBufferView view(data, sizeof(data), metadata, sizeof(metadata), 4);
+    view.push("first");
+    view.push("second");
+
+    char image[128];
+    int length = 0;
+    auto writer = [&](const char *chunk, int chunkLength) {
+        memcpy(image + length, chunk, chunkLength);
+        length += chunkLength;
+        return true;
+    };
+    int size = view.serialize(writer);
+    TEST_ASSERT_EQUAL_INT(length, size);
+
+    // images are exchanged with CStringBuffer in both directions
+    CStringBuffer<64, 4> buffer;
+    TEST_ASSERT_EQUAL_INT(true, buffer.deserialize(image, length));
+    TEST_ASSERT_EQUAL_STRING("second", buffer.peek().raw());
+    buffer.push("third");
+    length = 0;
+    buffer.serialize(writer);
+    TEST_ASSERT_EQUAL_INT(true, view.deserialize(image, length));
+    TEST_ASSERT_EQUAL_INT(3, view.numstrings());
+    TEST_ASSERT_EQUAL_STRING("third", view.peek().raw());
+
+    view.detach();
+    TEST_ASSERT_EQUAL_INT(false, view.deserialize(image, length));
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(testCreateOnCallerMemory);
+    RUN_TEST(testCreateRejectsInvalidRegions);
+    RUN_TEST(testAttachAtOtherAddress);
+    RUN_TEST(testSameSemanticsAsCStringBuffer);
+    RUN_TEST(testSharesAndSmallStrings);
+    RUN_TEST(testReserveTailAndUnallocated);
+    RUN_TEST(testSerializeAcrossBufferTypes);
+
+    return UNITY_END();
+}
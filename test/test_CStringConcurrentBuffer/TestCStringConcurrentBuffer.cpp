@@ -0,0 +1,154 @@
+#include "CStringConcurrentBuffer.h"
+#include <unity.h>
+
+#ifdef CSTRING_HAS_ATOMIC
+#include <thread>
+
+// collects drained strings separated by ','
+struct Collector {
+    char content[1024] = "";
+    int numstrings = 0;
+
+    void operator()(const char *string, int length) {
+        TEST_ASSERT_EQUAL_INT(length, (int)strlen(string));
+        strcat(content, string);
+        strcat(content, ",");
+        numstrings++;
+    }
+};
+
+void testPushAndDrain() {
+    CStringConcurrentBuffer<32, 4> buffer;
+    TEST_ASSERT_EQUAL_INT(true, buffer.push("first"));
+    TEST_ASSERT_EQUAL_INT(true, buffer.push(std::string_view("second string", 6)));
+    TEST_ASSERT_EQUAL_INT(true, buffer.push(""));
+
+    Collector collector;
+    TEST_ASSERT_EQUAL_INT(3, buffer.drain(collector));
+    TEST_ASSERT_EQUAL_STRING("first,second,,", collector.content);
+    TEST_ASSERT_EQUAL_INT(0, buffer.drain(collector));
+}
+
+void testAppendToSlab() {
+    CStringConcurrentBuffer<32, 4> buffer;
+    auto slab = buffer.reserve(10);
+    TEST_ASSERT_EQUAL_INT(false, slab.isInvalid());
+    TEST_ASSERT_EQUAL_INT(11, slab.rawCapacity());
+    TEST_ASSERT_EQUAL_INT(true, slab.append("abc"));
+    TEST_ASSERT_EQUAL_INT(true, slab.appendFormat("%d", 1234));
+    TEST_ASSERT_EQUAL_STRING("abc1234", slab.raw());
+
+    // doesn't fit: unchanged
+    TEST_ASSERT_EQUAL_INT(false, slab.append("abcd"));
+    TEST_ASSERT_EQUAL_INT(false, slab.appendFormat("%d", 5678));
+    TEST_ASSERT_EQUAL_STRING("abc1234", slab.raw());
+    TEST_ASSERT_EQUAL_INT(true, slab.append("abcd", 3));
+    TEST_ASSERT_EQUAL_INT(10, slab.length());
+
+    TEST_ASSERT_EQUAL_INT(true, slab.commit());
+    TEST_ASSERT_EQUAL_INT(true, slab.isInvalid());
+    TEST_ASSERT_EQUAL_INT(false, slab.commit());
+    TEST_ASSERT_EQUAL_INT(false, slab.append("x"));
+
+    Collector collector;
+    TEST_ASSERT_EQUAL_INT(1, buffer.drain(collector));
+    TEST_ASSERT_EQUAL_STRING("abc1234abc,", collector.content);
+}
+
+void testDrainInReservationOrder() {
+    CStringConcurrentBuffer<32, 4> buffer;
+    auto first = buffer.reserve(4);
+    first.append("1");
+    TEST_ASSERT_EQUAL_INT(true, buffer.push("2"));
+    {
+        // committed implicitly
+        auto third = buffer.reserve(4);
+        third.append("3");
+    }
+
+    Collector collector;
+    TEST_ASSERT_EQUAL_INT(0, buffer.drain(collector));
+    first.commit();
+    TEST_ASSERT_EQUAL_INT(3, buffer.drain(collector));
+    TEST_ASSERT_EQUAL_STRING("1,2,3,", collector.content);
+}
+
+void testReuseAfterDrain() {
+    CStringConcurrentBuffer<8, 2> buffer;
+    TEST_ASSERT_EQUAL_INT(false, buffer.push("12345678"));
+    TEST_ASSERT_EQUAL_INT(true, buffer.push("1234"));
+    TEST_ASSERT_EQUAL_INT(false, buffer.push("5678"));
+    TEST_ASSERT_EQUAL_INT(true, buffer.push("56"));
+    TEST_ASSERT_EQUAL_INT(false, buffer.push(""));
+
+    Collector collector;
+    TEST_ASSERT_EQUAL_INT(2, buffer.drain(collector));
+    TEST_ASSERT_EQUAL_INT(true, buffer.push("5678"));
+    TEST_ASSERT_EQUAL_INT(1, buffer.drain(collector));
+    TEST_ASSERT_EQUAL_STRING("1234,56,5678,", collector.content);
+}
+
+void testConcurrentProducers() {
+    constexpr int numThreads = 8;
+    constexpr int numStrings = 2000;
+    static CStringConcurrentBuffer<256, 16> buffer;
+
+    std::atomic<int> running{numThreads};
+    std::thread producers[numThreads];
+    for (int t = 0; t < numThreads; ++t) {
+        producers[t] = std::thread([&running, t] {
+            for (int i = 0; i < numStrings;) {
+                auto slab = buffer.reserve(15);
+                if (slab.isInvalid()) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                slab.appendFormat("%d %d", t, i++);
+            }
+            running--;
+        });
+    }
+
+    // strings of each producer are drained in order
+    int next[numThreads]{};
+    int numDrained = 0;
+    auto consume = [&](const char *string, int length) {
+        int t, i;
+        TEST_ASSERT_EQUAL_INT(2, sscanf(string, "%d %d", &t, &i));
+        TEST_ASSERT_EQUAL_INT(next[t]++, i);
+        numDrained++;
+    };
+    while (running > 0) {
+        if (buffer.drain(consume) == 0) {
+            std::this_thread::yield();
+        }
+    }
+    buffer.drain(consume);
+
+    for (std::thread &producer : producers) {
+        producer.join();
+    }
+    TEST_ASSERT_EQUAL_INT(numThreads * numStrings, numDrained);
+}
+#endif
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+
+#ifdef CSTRING_HAS_ATOMIC
+    RUN_TEST(testPushAndDrain);
+    RUN_TEST(testAppendToSlab);
+    RUN_TEST(testDrainInReservationOrder);
+    RUN_TEST(testReuseAfterDrain);
+    RUN_TEST(testConcurrentProducers);
+#endif
+
+    return UNITY_END();
+}
@@ -0,0 +1,165 @@
+#include "CStringGlob.h"
+#include <unity.h>
+#include <random>
+
+void testMatchesGlob() {
+    CStringBuffer<60, 3> buffer;
+    CString s1 = buffer.push("/api/v1/items/42");
+    CString s2 = buffer.push("/api/v1/items/");
+    CString s3 = buffer.push("/api/v1/users/42");
+
+    TEST_ASSERT_EQUAL_INT(true, s1.matchesGlob("/api/*/items/?*"));
+    TEST_ASSERT_EQUAL_INT(false, s2.matchesGlob("/api/*/items/?*"));
+    TEST_ASSERT_EQUAL_INT(false, s3.matchesGlob("/api/*/items/?*"));
+    TEST_ASSERT_EQUAL_INT(true, s3.matchesGlob("*"));
+    TEST_ASSERT_EQUAL_INT(true, s3.matchesGlob("/api/v[0-9]/*"));
+    TEST_ASSERT_EQUAL_INT(false, s3.matchesGlob("/api/v[!0-9]/*"));
+    TEST_ASSERT_EQUAL_INT(false, s3.matchesGlob("/api"));
+    TEST_ASSERT_EQUAL_INT(false, s3.matchesGlob("[0-9"));
+    TEST_ASSERT_EQUAL_INT(false, CString::INVALID.matchesGlob("*"));
+}
+
+void testCharacterClassesAndEscapes() {
+    CStringGlob<> glob("[]a-c][!x-z][^a]\\*\\?[a-]");
+
+    TEST_ASSERT_EQUAL_INT(false, glob.isInvalid());
+    TEST_ASSERT_EQUAL_INT(0, glob.numCaptures());
+    TEST_ASSERT_EQUAL_INT(true, glob.matches("]wb*?-", 6));
+    TEST_ASSERT_EQUAL_INT(true, glob.matches("bAb*?a", 6));
+    TEST_ASSERT_EQUAL_INT(false, glob.matches("dwb*?-", 6));
+    TEST_ASSERT_EQUAL_INT(false, glob.matches("byb*?-", 6));
+    TEST_ASSERT_EQUAL_INT(false, glob.matches("bwa*?-", 6));
+    TEST_ASSERT_EQUAL_INT(false, glob.matches("bwbx?-", 6));
+    TEST_ASSERT_EQUAL_INT(false, glob.matches("bwb*?b", 6));
+    TEST_ASSERT_EQUAL_INT(true, CStringGlob<>("").matches("", 0));
+    TEST_ASSERT_EQUAL_INT(false, CStringGlob<>("").matches("a", 1));
+}
+
+void testCaptures() {
+    CStringGlob<> glob("/api/*/items/?*");
+    CStringBuffer<40, 1> buffer;
+    CString s1 = buffer.push("/api/v1/beta/items/42");
+
+    CStringGlobCapture captures[3]{};
+    TEST_ASSERT_EQUAL_INT(3, glob.numCaptures());
+    TEST_ASSERT_EQUAL_INT(true, s1.matchesGlob(glob, captures));
+    TEST_ASSERT_EQUAL_INT(5, captures[0].index);
+    TEST_ASSERT_EQUAL_INT(7, captures[0].length);
+    TEST_ASSERT_EQUAL_INT(19, captures[1].index);
+    TEST_ASSERT_EQUAL_INT(1, captures[1].length);
+    TEST_ASSERT_EQUAL_INT(20, captures[2].index);
+    TEST_ASSERT_EQUAL_INT(1, captures[2].length);
+    TEST_ASSERT_EQUAL_INT(true, s1.slice(captures[0].index, captures[0].length) == "v1/beta");
+
+    CStringGlobCapture starCaptures[3]{};
+    TEST_ASSERT_EQUAL_INT(true, CStringGlob<>("**a*").matches("xxay", 4, starCaptures));
+    TEST_ASSERT_EQUAL_INT(0, starCaptures[0].length);
+    TEST_ASSERT_EQUAL_INT(0, starCaptures[1].index);
+    TEST_ASSERT_EQUAL_INT(2, starCaptures[1].length);
+    TEST_ASSERT_EQUAL_INT(3, starCaptures[2].index);
+    TEST_ASSERT_EQUAL_INT(1, starCaptures[2].length);
+}
+
+void testMatchingStopsAtEndOfString() {
+    CStringGlob<> glob("ab*");
+
+    TEST_ASSERT_EQUAL_INT(true, glob.matches("abc\0d", 5));
+    TEST_ASSERT_EQUAL_INT(true, glob.matches("abcd", 2));
+    TEST_ASSERT_EQUAL_INT(false, glob.matches("abcd", 1));
+    TEST_ASSERT_EQUAL_INT(false, glob.matches(nullptr, 1));
+}
+
+bool matchesRecursive(const char *pattern, const char *data) {
+    if (*pattern == '\0') {
+        return *data == '\0';
+    }
+    if (*pattern == '*') {
+        return matchesRecursive(pattern + 1, data) || (*data != '\0' && matchesRecursive(pattern, data + 1));
+    }
+    return *data != '\0' && (*pattern == '?' || *pattern == *data) && matchesRecursive(pattern + 1, data + 1);
+}
+
+void testMatchesBruteForce() {
+    std::mt19937 random(42);
+    char pattern[8];
+    char data[12];
+
+    for (int round = 0; round < 20000; ++round) {
+        int patternLength = random() % sizeof(pattern);
+        for (int i = 0; i < patternLength; ++i) {
+            pattern[i] = "ab*?"[random() % 4];
+        }
+        pattern[patternLength] = '\0';
+
+        int dataLength = random() % sizeof(data);
+        for (int i = 0; i < dataLength; ++i) {
+            data[i] = "ab"[random() % 2];
+        }
+        data[dataLength] = '\0';
+
+        TEST_ASSERT_EQUAL_INT(matchesRecursive(pattern, data), CStringGlob<>(pattern).matches(data, dataLength));
+    }
+}
+
+void testBuildAtCompileTime() {
+    constexpr CStringGlob<8, 1> glob("*.[ch]");
+    static_assert(!glob.isInvalid());
+    static_assert(glob.matches("main.c", 6));
+    static_assert(!glob.matches("main.cpp", 8));
+
+    TEST_ASSERT_EQUAL_INT(1, glob.numCaptures());
+}
+
+void testCapacityExceeded() {
+    TEST_ASSERT_EQUAL_INT(true, (CStringGlob<4, 1>("abcde").isInvalid()));
+    TEST_ASSERT_EQUAL_INT(true, (CStringGlob<4, 1>("[a][b]").isInvalid()));
+    TEST_ASSERT_EQUAL_INT(true, (CStringGlob<4, 1>("ab\\").isInvalid()));
+    TEST_ASSERT_EQUAL_INT(false, (CStringGlob<4, 1>("ab\\*").isInvalid()));
+}
+
+void testMatchesGlobSizedFromPattern() {
+    CStringBuffer<600, 4> buffer;
+    CString path = buffer.push("/api/v1/organizations/acme/members/bob");
+
+    // 33 tokens and 5 character classes exceed the default tables
+    TEST_ASSERT_EQUAL_INT(true, CStringGlob<>("/api/v1/organizations/*/members/*").isInvalid());
+    TEST_ASSERT_EQUAL_INT(true, path.matchesGlob("/api/v1/organizations/*/members/*"));
+    TEST_ASSERT_EQUAL_INT(false, path.matchesGlob("/api/v1/organizations/*/members/*x"));
+    TEST_ASSERT_EQUAL_INT(true, path.matchesGlob("/[a][p][i]/[v][0-9]/*"));
+
+    // patterns exceeding 255 tokens never match
+    char pattern[300];
+    memset(pattern, 'a', sizeof(pattern) - 1);
+    pattern[sizeof(pattern) - 1] = '\0';
+    CString as = buffer.push(pattern);
+    pattern[UINT8_MAX - 1] = '*';
+    pattern[UINT8_MAX] = '\0';
+    TEST_ASSERT_EQUAL_INT(true, as.matchesGlob(pattern));
+    pattern[UINT8_MAX - 1] = 'a';
+    pattern[UINT8_MAX] = '*';
+    pattern[UINT8_MAX + 1] = '\0';
+    TEST_ASSERT_EQUAL_INT(false, as.matchesGlob(pattern));
+    TEST_ASSERT_EQUAL_INT(true, (CStringGlob<UINT8_MAX, 32>(pattern).isInvalid()));
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(testMatchesGlob);
+    RUN_TEST(testCharacterClassesAndEscapes);
+    RUN_TEST(testCaptures);
+    RUN_TEST(testMatchingStopsAtEndOfString);
+    RUN_TEST(testMatchesBruteForce);
+    RUN_TEST(testBuildAtCompileTime);
+    RUN_TEST(testCapacityExceeded);
+    RUN_TEST(testMatchesGlobSizedFromPattern);
+
+    return UNITY_END();
+}
@@ -0,0 +1,123 @@
+#include "CStringInternPool.h"
+#include <unity.h>
+
+void testInternReturnsSameIdForEqualStrings() {
+    CStringInternPool<50, 4> pool;
+    uint8_t host = pool.intern("Host");
+    uint8_t accept = pool.intern("Accept");
+    uint8_t host2 = pool.intern("Host");
+
+    TEST_ASSERT_EQUAL_INT(0, host);
+    TEST_ASSERT_EQUAL_INT(1, accept);
+    TEST_ASSERT_EQUAL_INT(host, host2);
+    TEST_ASSERT_EQUAL_INT(2, pool.numstrings());
+    TEST_ASSERT_EQUAL_INT(50 - 5 - 7, pool.unallocatedBytes());
+    TEST_ASSERT_EQUAL_STRING("Host", pool.getRawString(host));
+    TEST_ASSERT_EQUAL_STRING("Accept", pool.getRawString(accept));
+}
+
+void testInternWithLimit() {
+    CStringInternPool<50, 4> pool;
+    uint8_t id1 = pool.intern("Hostname", 4);
+    uint8_t id2 = pool.intern(std::string_view("Host"));
+    uint8_t id3 = pool.intern("Hostname");
+
+    TEST_ASSERT_EQUAL_INT(id1, id2);
+    TEST_ASSERT_NOT_EQUAL(id1, id3);
+    TEST_ASSERT_EQUAL_STRING("Host", pool.getRawString(id1));
+    TEST_ASSERT_EQUAL_STRING("Hostname", pool.getRawString(id3));
+}
+
+void testInternPrefixesAreDistinct() {
+    CStringInternPool<50, 4> pool;
+    uint8_t empty = pool.intern("");
+    uint8_t a = pool.intern("a");
+    uint8_t ab = pool.intern("ab");
+
+    TEST_ASSERT_EQUAL_INT(3, pool.numstrings());
+    TEST_ASSERT_EQUAL_INT(empty, pool.find(""));
+    TEST_ASSERT_EQUAL_INT(a, pool.find("a"));
+    TEST_ASSERT_EQUAL_INT(ab, pool.find("ab"));
+}
+
+void testInternCString() {
+    CStringBuffer<20, 2> buffer;
+    CString s1 = buffer.push("gzip");
+
+    CStringInternPool<50, 4> pool;
+    uint8_t id = pool.intern(s1);
+
+    TEST_ASSERT_EQUAL_INT(id, pool.intern("gzip"));
+    TEST_ASSERT_EQUAL_INT(INVALID_STRING_IDX, pool.intern(CString::INVALID));
+}
+
+void testGetStringView() {
+    CStringInternPool<50, 4> pool;
+    uint8_t host = pool.intern("Host");
+    uint8_t accept = pool.intern("Accept");
+
+    TEST_ASSERT_EQUAL_INT(true, pool.getStringView(host) == "Host");
+    TEST_ASSERT_EQUAL_INT(6, pool.getStringView(accept).length());
+    TEST_ASSERT_EQUAL_PTR(pool.getRawString(accept), pool.getStringView(accept).data());
+    TEST_ASSERT_NULL(pool.getStringView(2).data());
+    TEST_ASSERT_NULL(pool.getStringView(INVALID_STRING_IDX).data());
+}
+
+void testFindDoesNotIntern() {
+    CStringInternPool<50, 4> pool;
+    pool.intern("GET");
+
+    TEST_ASSERT_EQUAL_INT(0, pool.find("GET"));
+    TEST_ASSERT_EQUAL_INT(INVALID_STRING_IDX, pool.find("POST"));
+    TEST_ASSERT_EQUAL_INT(INVALID_STRING_IDX, pool.find(nullptr));
+    TEST_ASSERT_EQUAL_INT(1, pool.numstrings());
+}
+
+void testInternFull() {
+    CStringInternPool<50, 2> pool;
+    TEST_ASSERT_EQUAL_INT(0, pool.intern("a"));
+    TEST_ASSERT_EQUAL_INT(1, pool.intern("b"));
+    TEST_ASSERT_EQUAL_INT(INVALID_STRING_IDX, pool.intern("c"));
+    TEST_ASSERT_EQUAL_INT(1, pool.intern("b"));
+    TEST_ASSERT_EQUAL_INT(0, pool.remainingStrings());
+
+    CStringInternPool<5, 4> smallPool;
+    TEST_ASSERT_EQUAL_INT(0, smallPool.intern("abc"));
+    TEST_ASSERT_EQUAL_INT(INVALID_STRING_IDX, smallPool.intern("def"));
+    TEST_ASSERT_EQUAL_INT(INVALID_STRING_IDX, smallPool.find("def"));
+}
+
+void testInternManyStrings() {
+    CStringInternPool<2000, 200> pool;
+    char str[8];
+
+    for (int i = 0; i < 200; ++i) {
+        snprintf(str, sizeof(str), "k%d", i);
+        TEST_ASSERT_EQUAL_INT(i, pool.intern(str));
+    }
+    for (int i = 0; i < 200; ++i) {
+        snprintf(str, sizeof(str), "k%d", i);
+        TEST_ASSERT_EQUAL_INT(i, pool.find(str));
+        TEST_ASSERT_EQUAL_STRING(str, pool.getRawString(i));
+    }
+    TEST_ASSERT_EQUAL_INT(INVALID_STRING_IDX, pool.find("k200"));
+}
+
+void setUp() {};
+void tearDown() {};
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(testInternReturnsSameIdForEqualStrings);
+    RUN_TEST(testInternWithLimit);
+    RUN_TEST(testInternPrefixesAreDistinct);
+    RUN_TEST(testInternCString);
+    RUN_TEST(testGetStringView);
+    RUN_TEST(testFindDoesNotIntern);
+    RUN_TEST(testInternFull);
+    RUN_TEST(testInternManyStrings);
+
+    return UNITY_END();
+}
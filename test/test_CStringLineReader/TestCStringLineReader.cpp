@@ -0,0 +1,156 @@
+#include "CStringLineReader.h"
+#include <unity.h>
+
+int pipeWithContent(const char *content, int length) {
+    int fds[2];
+    if (pipe(fds) != 0 || write(fds[1], content, length) != length) {
+        return -1;
+    }
+    close(fds[1]);
+    return fds[0];
+}
+
+void testReadLines() {
+    CStringBuffer<64, 4> buffer;
+    const char content[] = "first\nsecond\r\n\nlast";
+    int fd = pipeWithContent(content, sizeof(content) - 1);
+    CStringLineReader<CStringBuffer<64, 4>> reader(buffer, fd);
+
+    TEST_ASSERT_EQUAL_STRING("first", reader.readLine().raw());
+    TEST_ASSERT_EQUAL_STRING("second", reader.readLine().raw());
+    TEST_ASSERT_EQUAL_STRING("", reader.readLine().raw());
+    TEST_ASSERT_EQUAL_INT(false, reader.isEof());
+    TEST_ASSERT_EQUAL_STRING("last", reader.readLine().raw());
+    TEST_ASSERT_EQUAL_INT(true, reader.readLine().isInvalid());
+    TEST_ASSERT_EQUAL_INT(true, reader.isEof());
+    TEST_ASSERT_EQUAL_INT(false, reader.isError());
+    TEST_ASSERT_EQUAL_INT(4, buffer.numstrings());
+
+    // lines are read in place: strings are adjacent
+    TEST_ASSERT_EQUAL_INT(true, buffer.getRawString(1) == buffer.getRawString(0) + 6);
+    close(fd);
+}
+
+void testReadLinesInBatches() {
+    // more lines than the buffer holds: process batches, remove them and continue
+    CStringBuffer<32, 3> buffer;
+    char content[1000];
+    int length = 0;
+    for (int i = 0; i < 100; ++i) {
+        length += snprintf(content + length, sizeof(content) - length, "line %d\n", i);
+    }
+    int fd = pipeWithContent(content, length);
+    CStringLineReader<CStringBuffer<32, 3>> reader(buffer, fd);
+
+    int expected = 0;
+    while (true) {
+        CString line = reader.readLine();
+        if (line.isInvalid()) {
+            if (reader.isEof() || reader.isError() || buffer.numstrings() == 0) {
+                break;
+            }
+            buffer.removeAll();
+            continue;
+        }
+
+        char expectedLine[16];
+        snprintf(expectedLine, sizeof(expectedLine), "line %d", expected++);
+        TEST_ASSERT_EQUAL_STRING(expectedLine, line.raw());
+    }
+
+    TEST_ASSERT_EQUAL_INT(100, expected);
+    TEST_ASSERT_EQUAL_INT(true, reader.isEof());
+    close(fd);
+}
+
+void testPopReclaimsSpace() {
+    CStringBuffer<16, 2> buffer;
+    const char content[] = "abcdef\nghijkl\nmnopqr\n";
+    int fd = pipeWithContent(content, sizeof(content) - 1);
+    CStringLineReader<CStringBuffer<16, 2>> reader(buffer, fd);
+
+    for (const char *expected : {"abcdef", "ghijkl", "mnopqr"}) {
+        CString line = reader.readLine();
+        TEST_ASSERT_EQUAL_STRING(expected, line.raw());
+        TEST_ASSERT_EQUAL_INT(true, buffer.getRawString(0) == line.raw());
+        buffer.pop();
+    }
+    TEST_ASSERT_EQUAL_INT(true, reader.readLine().isInvalid());
+    TEST_ASSERT_EQUAL_INT(true, reader.isEof());
+    close(fd);
+}
+
+void testLineTooLong() {
+    CStringBuffer<8, 2> buffer;
+    const char content[] = "abcdefghij\n";
+    int fd = pipeWithContent(content, sizeof(content) - 1);
+    CStringLineReader<CStringBuffer<8, 2>> reader(buffer, fd);
+
+    TEST_ASSERT_EQUAL_INT(true, reader.readLine().isInvalid());
+    TEST_ASSERT_EQUAL_INT(false, reader.isEof());
+    TEST_ASSERT_EQUAL_INT(true, reader.isLineTooLong());
+    TEST_ASSERT_EQUAL_INT(0, buffer.numstrings());
+    TEST_ASSERT_EQUAL_INT(7, reader.pendingBytes());
+    close(fd);
+}
+
+void testSkipLineTooLong() {
+    CStringBuffer<8, 2> buffer;
+    const char content[] = "abcdefghijklmnopq\nxy\nlong line without line feed";
+    int fd = pipeWithContent(content, sizeof(content) - 1);
+    CStringLineReader<CStringBuffer<8, 2>> reader(buffer, fd);
+
+    // batch loop: terminates and skips lines that are too long
+    int lines = 0;
+    int skipped = 0;
+    while (true) {
+        CString line = reader.readLine();
+        if (!line.isInvalid()) {
+            TEST_ASSERT_EQUAL_STRING("xy", line.raw());
+            lines++;
+            continue;
+        }
+        if (reader.isEof() || reader.isError()) {
+            break;
+        }
+        if (reader.isLineTooLong()) {
+            TEST_ASSERT_EQUAL_INT(true, reader.skipLine());
+            TEST_ASSERT_EQUAL_INT(false, reader.isLineTooLong());
+            skipped++;
+        }
+        buffer.removeAll();
+    }
+
+    TEST_ASSERT_EQUAL_INT(1, lines);
+    TEST_ASSERT_EQUAL_INT(2, skipped);
+    TEST_ASSERT_EQUAL_INT(0, reader.pendingBytes());
+    close(fd);
+}
+
+void testReadError() {
+    CStringBuffer<8, 2> buffer;
+    CStringLineReader<CStringBuffer<8, 2>> reader(buffer, -1);
+
+    TEST_ASSERT_EQUAL_INT(true, reader.readLine().isInvalid());
+    TEST_ASSERT_EQUAL_INT(true, reader.isError());
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(testReadLines);
+    RUN_TEST(testReadLinesInBatches);
+    RUN_TEST(testPopReclaimsSpace);
+    RUN_TEST(testLineTooLong);
+    RUN_TEST(testSkipLineTooLong);
+    RUN_TEST(testReadError);
+
+    return UNITY_END();
+}
@@ -0,0 +1,165 @@
+#include "CStringMap.h"
+#include <unity.h>
+
+void testInsertAndFind() {
+    CStringBuffer<100, 10> buffer;
+    CStringMap<CStringBuffer<100, 10>, 8> map(buffer);
+
+    CString value = map.insert("Host", "example.org");
+    map.insert("Accept", "*/*");
+
+    TEST_ASSERT_EQUAL_INT(false, value.isInvalid());
+    TEST_ASSERT_EQUAL_INT(2, map.size());
+    TEST_ASSERT_EQUAL_INT(4, buffer.numstrings());
+    TEST_ASSERT_EQUAL_STRING("example.org", map.find("Host").raw());
+    TEST_ASSERT_EQUAL_STRING("*/*", map.find(std::string_view("Accept-Encoding", 6)).raw());
+    TEST_ASSERT_EQUAL_INT(true, map.find("Accept-Encoding").isInvalid());
+    TEST_ASSERT_EQUAL_INT(true, map.find("host").isInvalid());
+    TEST_ASSERT_EQUAL_INT(true, map.contains("Host"));
+    TEST_ASSERT_EQUAL_INT(false, map.contains("Hos"));
+}
+
+void testInsertReplacesValue() {
+    CStringBuffer<100, 10> buffer;
+    CStringMap<CStringBuffer<100, 10>, 8> map(buffer);
+
+    map.insert("key", "value1");
+    map.insert("other", "x");
+    map.insert("key", "value2");
+
+    TEST_ASSERT_EQUAL_INT(2, map.size());
+    TEST_ASSERT_EQUAL_INT(4, buffer.numstrings());
+    TEST_ASSERT_EQUAL_STRING("value2", map.find("key").raw());
+    TEST_ASSERT_EQUAL_STRING("x", map.find("other").raw());
+}
+
+void testInsertValueOfSameMap() {
+    CStringBuffer<100, 10> buffer;
+    CStringMap<CStringBuffer<100, 10>, 8> map(buffer);
+
+    map.insert("a", "1234");
+    map.insert("b", map.find("a"));
+    map.insert("a", map.find("a"));
+
+    TEST_ASSERT_EQUAL_STRING("1234", map.find("a").raw());
+    TEST_ASSERT_EQUAL_STRING("1234", map.find("b").raw());
+}
+
+void testErase() {
+    CStringBuffer<100, 10> buffer;
+    CStringMap<CStringBuffer<100, 10>, 8> map(buffer);
+
+    map.insert("a", "1");
+    map.insert("b", "2");
+    map.insert("c", "3");
+
+    TEST_ASSERT_EQUAL_INT(true, map.erase("a"));
+    TEST_ASSERT_EQUAL_INT(false, map.erase("a"));
+    TEST_ASSERT_EQUAL_INT(2, map.size());
+    TEST_ASSERT_EQUAL_INT(4, buffer.numstrings());
+    TEST_ASSERT_EQUAL_INT(true, map.find("a").isInvalid());
+    TEST_ASSERT_EQUAL_STRING("2", map.find("b").raw());
+    TEST_ASSERT_EQUAL_STRING("3", map.find("c").raw());
+
+    map.clear();
+    TEST_ASSERT_EQUAL_INT(0, map.size());
+    TEST_ASSERT_EQUAL_INT(0, buffer.numstrings());
+    TEST_ASSERT_EQUAL_INT(true, map.find("b").isInvalid());
+}
+
+void testCollisions() {
+    CStringBuffer<400, 64> buffer;
+    CStringMap<CStringBuffer<400, 64>, 32> map(buffer);
+    char key[16];
+    char value[16];
+
+    for (int i = 0; i < 32; ++i) {
+        snprintf(key, sizeof(key), "k%d", i);
+        snprintf(value, sizeof(value), "v%d", i);
+        TEST_ASSERT_EQUAL_INT(false, map.insert(key, value).isInvalid());
+    }
+    TEST_ASSERT_EQUAL_INT(true, map.insert("k32", "v32").isInvalid());
+    TEST_ASSERT_EQUAL_INT(64, buffer.numstrings());
+
+    for (int i = 0; i < 32; i += 2) {
+        snprintf(key, sizeof(key), "k%d", i);
+        TEST_ASSERT_EQUAL_INT(true, map.erase(key));
+    }
+    for (int i = 0; i < 32; ++i) {
+        snprintf(key, sizeof(key), "k%d", i);
+        snprintf(value, sizeof(value), "v%d", i);
+        if (i % 2 == 0) {
+            TEST_ASSERT_EQUAL_INT(true, map.find(key).isInvalid());
+        } else {
+            TEST_ASSERT_EQUAL_STRING(value, map.find(key).raw());
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(false, map.contains("k32"));
+}
+
+void testSurvivesRelocation() {
+    CStringBuffer<100, 10> buffer;
+    CStringMap<CStringBuffer<100, 10>, 8> map(buffer);
+
+    CString a = map.insert("a", "1");
+    map.insert("b", "2");
+    CString other = buffer.push("other");
+
+    a.append("23");
+    buffer.moveToTop(map.find("b"));
+    other.deallocate();
+
+    TEST_ASSERT_EQUAL_STRING("123", map.find("a").raw());
+    TEST_ASSERT_EQUAL_STRING("2", map.find("b").raw());
+    TEST_ASSERT_EQUAL_INT(true, map.erase("a"));
+    TEST_ASSERT_EQUAL_STRING("2", map.find("b").raw());
+}
+
+void testInsertBufferFull() {
+    CStringBuffer<10, 10> buffer;
+    CStringMap<CStringBuffer<10, 10>, 8> map(buffer);
+
+    TEST_ASSERT_EQUAL_INT(false, map.insert("a", "1").isInvalid());
+    TEST_ASSERT_EQUAL_INT(true, map.insert("b", "23456").isInvalid());
+    TEST_ASSERT_EQUAL_INT(1, map.size());
+    TEST_ASSERT_EQUAL_INT(2, buffer.numstrings());
+    TEST_ASSERT_EQUAL_INT(true, map.insert("a", "234567").isInvalid());
+    TEST_ASSERT_EQUAL_STRING("1", map.find("a").raw());
+}
+
+void testForEach() {
+    CStringBuffer<100, 10> buffer;
+    CStringMap<CStringBuffer<100, 10>, 8> map(buffer);
+
+    map.insert("a", "1");
+    map.insert("b", "2");
+
+    int count = 0;
+    map.forEach([&count](const CString &key, CString &value) {
+        count++;
+        value.append('!');
+    });
+
+    TEST_ASSERT_EQUAL_INT(2, count);
+    TEST_ASSERT_EQUAL_STRING("1!", map.find("a").raw());
+    TEST_ASSERT_EQUAL_STRING("2!", map.find("b").raw());
+}
+
+void setUp() {};
+void tearDown() {};
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(testInsertAndFind);
+    RUN_TEST(testInsertReplacesValue);
+    RUN_TEST(testInsertValueOfSameMap);
+    RUN_TEST(testErase);
+    RUN_TEST(testCollisions);
+    RUN_TEST(testSurvivesRelocation);
+    RUN_TEST(testInsertBufferFull);
+    RUN_TEST(testForEach);
+
+    return UNITY_END();
+}
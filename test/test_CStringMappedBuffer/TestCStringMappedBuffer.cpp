@@ -0,0 +1,168 @@
+#include "CStringMappedBuffer.h"
+#include <unity.h>
+
+#ifdef CSTRING_HAS_MMAP
+char path[] = "/tmp/TestCStringMappedBufferXXXXXX";
+
+void testCreateAndReopen() {
+    CStringMappedBuffer buffer;
+    TEST_ASSERT_EQUAL_INT(true, buffer.create(path, 64, 4));
+    TEST_ASSERT_EQUAL_INT(true, buffer.isOpen());
+    TEST_ASSERT_EQUAL_INT(64, buffer.capacity());
+
+    buffer.push("first");
+    CString second = buffer.push("second");
+    second += " string";
+    buffer.pushFormat("%d", 3);
+    TEST_ASSERT_EQUAL_INT(true, buffer.sync());
+    buffer.close();
+    TEST_ASSERT_EQUAL_INT(false, buffer.isOpen());
+    TEST_ASSERT_EQUAL_INT(false, second.isAllocated());
+
+    CStringMappedBuffer reopened;
+    TEST_ASSERT_EQUAL_INT(true, reopened.open(path));
+    TEST_ASSERT_EQUAL_INT(3, reopened.numstrings());
+    TEST_ASSERT_EQUAL_INT(6 + 14 + 2, reopened.allocatedBytes());
+    TEST_ASSERT_EQUAL_STRING("first", reopened.getRawString(0));
+    TEST_ASSERT_EQUAL_STRING("second string", reopened.getCString(1).raw());
+    TEST_ASSERT_EQUAL_STRING("3", reopened.peek().raw());
+
+    // modifications continue where the previous process stopped
+    CString first = reopened.getCString(0);
+    first.toUpper();
+    first += "!";
+    TEST_ASSERT_EQUAL_STRING("FIRST!", first.raw());
+    TEST_ASSERT_EQUAL_INT(2, reopened.getIndex(first));
+    TEST_ASSERT_EQUAL_STRING("second string", reopened.getRawString(0));
+}
+
+void testRemoveAndMoveToTop() {
+    CStringMappedBuffer buffer;
+    TEST_ASSERT_EQUAL_INT(true, buffer.create(path, 32, 4));
+    CString a = buffer.push("a");
+    CString b = buffer.push("bb");
+    CString c = buffer.push("ccc");
+
+    TEST_ASSERT_EQUAL_INT(true, buffer.moveToTop(a));
+    TEST_ASSERT_EQUAL_INT(2, a.bufferIndex());
+    TEST_ASSERT_EQUAL_INT(0, b.bufferIndex());
+    TEST_ASSERT_EQUAL_INT(1, c.bufferIndex());
+
+    TEST_ASSERT_EQUAL_INT(true, buffer.remove(b));
+    TEST_ASSERT_EQUAL_INT(false, b.isAllocated());
+    TEST_ASSERT_EQUAL_STRING("ccc", c.raw());
+    TEST_ASSERT_EQUAL_STRING("a", a.raw());
+    TEST_ASSERT_EQUAL_INT(6, buffer.allocatedBytes());
+
+    // handles survive reopening
+    buffer.close();
+    TEST_ASSERT_EQUAL_INT(true, buffer.open(path));
+    c = buffer.getCString(0);
+    a = buffer.getCString(1);
+    TEST_ASSERT_EQUAL_INT(true, buffer.pop());
+    TEST_ASSERT_EQUAL_INT(false, a.isAllocated());
+    TEST_ASSERT_EQUAL_STRING("ccc", c.raw());
+    TEST_ASSERT_EQUAL_STRING("d", buffer.push("d").raw());
+
+    TEST_ASSERT_EQUAL_INT(true, buffer.removeAll());
+    TEST_ASSERT_EQUAL_INT(0, buffer.numstrings());
+    TEST_ASSERT_EQUAL_INT(32, buffer.unallocatedBytes());
+}
+
+void testCapacityLimits() {
+    CStringMappedBuffer buffer;
+    TEST_ASSERT_EQUAL_INT(true, buffer.create(path, 8, 2));
+
+    TEST_ASSERT_EQUAL_INT(true, buffer.push("12345678").isInvalid());
+    CString first = buffer.push("1234");
+    TEST_ASSERT_EQUAL_INT(true, first.append("5678").isInvalid());
+    TEST_ASSERT_EQUAL_STRING("1234", first.raw());
+    TEST_ASSERT_EQUAL_INT(3, buffer.unallocatedBytes());
+
+    CString second = buffer.allocateRemaining();
+    TEST_ASSERT_EQUAL_INT(3, second.rawCapacity());
+    TEST_ASSERT_EQUAL_INT(0, buffer.unallocatedBytes());
+    TEST_ASSERT_EQUAL_INT(true, buffer.push("").isInvalid());
+
+    buffer.pop();
+    TEST_ASSERT_EQUAL_STRING("12", buffer.push("12").raw());
+    TEST_ASSERT_EQUAL_INT(true, buffer.push("").isInvalid());
+    TEST_ASSERT_EQUAL_INT(0, buffer.remainingStrings());
+}
+
+void testOpenRejectsInvalidFiles() {
+    CStringMappedBuffer buffer;
+    TEST_ASSERT_EQUAL_INT(false, buffer.open("/nonexistent/TestCStringMappedBuffer"));
+    TEST_ASSERT_EQUAL_INT(ENOENT, errno);
+
+    // too short
+    TEST_ASSERT_EQUAL_INT(false, buffer.open(path));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+
+    TEST_ASSERT_EQUAL_INT(true, buffer.create(path, 64, 4));
+    buffer.push("content");
+    buffer.close();
+
+    // truncated
+    struct stat stat;
+    ::stat(path, &stat);
+    TEST_ASSERT_EQUAL_INT(0, truncate(path, stat.st_size - 1));
+    TEST_ASSERT_EQUAL_INT(false, buffer.open(path));
+    TEST_ASSERT_EQUAL_INT(0, truncate(path, stat.st_size));
+    TEST_ASSERT_EQUAL_INT(true, buffer.open(path));
+    buffer.close();
+
+    // other format version
+    int fd = open(path, O_RDWR);
+    uint32_t version = CStringMappedBuffer::formatVersion + 1;
+    TEST_ASSERT_EQUAL_INT(sizeof(version), pwrite(fd, &version, sizeof(version), 8));
+    close(fd);
+    TEST_ASSERT_EQUAL_INT(false, buffer.open(path));
+    TEST_ASSERT_EQUAL_INT(false, buffer.isOpen());
+    TEST_ASSERT_EQUAL_INT(true, buffer.push("x").isInvalid());
+}
+
+void testClosedBuffer() {
+    CStringMappedBuffer buffer;
+    TEST_ASSERT_EQUAL_INT(false, buffer.isOpen());
+    TEST_ASSERT_EQUAL_INT(false, buffer.sync());
+    TEST_ASSERT_EQUAL_INT(0, buffer.capacity());
+    TEST_ASSERT_EQUAL_INT(0, buffer.numstrings());
+    TEST_ASSERT_EQUAL_INT(0, buffer.remainingStrings());
+    TEST_ASSERT_EQUAL_INT(true, buffer.push("x").isInvalid());
+    TEST_ASSERT_EQUAL_INT(true, buffer.allocate().isInvalid());
+    TEST_ASSERT_EQUAL_INT(true, buffer.peek().isInvalid());
+    TEST_ASSERT_EQUAL_INT(false, buffer.pop());
+    TEST_ASSERT_EQUAL_INT(false, buffer.removeAll());
+    TEST_ASSERT_EQUAL_INT(true, buffer.resizeTopmost(4).isInvalid());
+    TEST_ASSERT_EQUAL_PTR(nullptr, buffer.getRawString(0));
+}
+#endif
+
+void setUp() {
+#ifdef CSTRING_HAS_MMAP
+    strcpy(path + sizeof(path) - 7, "XXXXXX");
+    close(mkstemp(path));
+#endif
+}
+
+void tearDown() {
+#ifdef CSTRING_HAS_MMAP
+    unlink(path);
+#endif
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+
+#ifdef CSTRING_HAS_MMAP
+    RUN_TEST(testCreateAndReopen);
+    RUN_TEST(testRemoveAndMoveToTop);
+    RUN_TEST(testCapacityLimits);
+    RUN_TEST(testOpenRejectsInvalidFiles);
+    RUN_TEST(testClosedBuffer);
+#endif
+
+    return UNITY_END();
+}
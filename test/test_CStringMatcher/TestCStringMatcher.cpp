@@ -0,0 +1,160 @@
+#include "CStringMatcher.h"
+#include <unity.h>
+
+void testIndexOfAnyPattern() {
+    CStringMatcher<64, 16> matcher{"error", "warn", "fatal"};
+    CStringBuffer<80, 3> buffer;
+    CString s1 = buffer.push("2024-01-01 warn: disk almost full");
+    CString s2 = buffer.push("info: all fine");
+    CString s3 = buffer.push("fatal error");
+
+    TEST_ASSERT_EQUAL_INT(false, matcher.isInvalid());
+    TEST_ASSERT_EQUAL_INT(3, matcher.numPatterns());
+    TEST_ASSERT_EQUAL_INT(11, s1.indexOfAnyPattern(matcher));
+    TEST_ASSERT_EQUAL_INT(-1, s2.indexOfAnyPattern(matcher));
+    TEST_ASSERT_EQUAL_INT(0, s3.indexOfAnyPattern(matcher));
+    TEST_ASSERT_EQUAL_INT(6, s3.indexOfAnyPattern(matcher, 1));
+    TEST_ASSERT_EQUAL_INT(-1, s3.indexOfAnyPattern(matcher, 7));
+    TEST_ASSERT_EQUAL_INT(-1, s3.indexOfAnyPattern(matcher, -1));
+    TEST_ASSERT_EQUAL_INT(-1, CString::INVALID.indexOfAnyPattern(matcher));
+}
+
+void testIndexOfAnyPatternReportsMatch() {
+    CStringMatcher<64, 16> matcher{"bc", "abcd", "c"};
+    CStringBuffer<20, 1> buffer;
+    CString s1 = buffer.push("xabcde");
+
+    CStringMatch match{};
+    TEST_ASSERT_EQUAL_INT(1, s1.indexOfAnyPattern(matcher, 0, match));
+    TEST_ASSERT_EQUAL_INT(1, match.patternId);
+    TEST_ASSERT_EQUAL_INT(1, match.index);
+    TEST_ASSERT_EQUAL_INT(4, match.length);
+
+    TEST_ASSERT_EQUAL_INT(2, s1.indexOfAnyPattern(matcher, 2, match));
+    TEST_ASSERT_EQUAL_INT(0, match.patternId);
+    TEST_ASSERT_EQUAL_INT(2, match.length);
+}
+
+void testSearchStopsAtEndOfString() {
+    CStringMatcher<64, 16> matcher{"abc"};
+    CStringBuffer<20, 1> buffer;
+    CString s1 = buffer.push("xxabcxx");
+    s1[2] = '\0';
+
+    TEST_ASSERT_EQUAL_INT(-1, s1.indexOfAnyPattern(matcher));
+}
+
+void testFindAllReportsOverlappingMatches() {
+    CStringMatcher<64, 16> matcher{"he", "she", "his", "hers"};
+    CStringBuffer<20, 1> buffer;
+    CString s1 = buffer.push("ushers");
+
+    auto matches = matcher.findAll(s1);
+    CStringMatch match{};
+
+    TEST_ASSERT_EQUAL_INT(true, matches.next(match));
+    TEST_ASSERT_EQUAL_INT(1, match.patternId);
+    TEST_ASSERT_EQUAL_INT(1, match.index);
+    TEST_ASSERT_EQUAL_INT(true, matches.next(match));
+    TEST_ASSERT_EQUAL_INT(0, match.patternId);
+    TEST_ASSERT_EQUAL_INT(2, match.index);
+    TEST_ASSERT_EQUAL_INT(true, matches.next(match));
+    TEST_ASSERT_EQUAL_INT(3, match.patternId);
+    TEST_ASSERT_EQUAL_INT(2, match.index);
+    TEST_ASSERT_EQUAL_INT(4, match.length);
+    TEST_ASSERT_EQUAL_INT(false, matches.next(match));
+    TEST_ASSERT_EQUAL_INT(false, matches.next(match));
+}
+
+void testMatchesBruteForce() {
+    const char *patterns[] = {"a", "ab", "bab", "bc", "bca", "c", "caa", "abcab", "cc"};
+    CStringMatcher<64, 8> matcher;
+    for (const char *pattern : patterns) {
+        matcher.addPattern(pattern);
+    }
+    matcher.build();
+
+    const char *text = "abccabcabaabcaaccbabcbcabcabab";
+    int textLength = strlen(text);
+    auto matches = matcher.findAll(text, textLength);
+    CStringMatch match{};
+
+    for (int end = 1; end <= textLength; ++end) {
+        // matches ending at the same index are reported longest first
+        for (int len = end; len > 0; --len) {
+            for (int id = 0; id < 9; ++id) {
+                if ((int)strlen(patterns[id]) == len && strncmp(text + end - len, patterns[id], len) == 0) {
+                    TEST_ASSERT_EQUAL_INT(true, matches.next(match));
+                    TEST_ASSERT_EQUAL_INT(id, match.patternId);
+                    TEST_ASSERT_EQUAL_INT(end - len, match.index);
+                }
+            }
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(false, matches.next(match));
+}
+
+void testBuildAtCompileTime() {
+    static constexpr CStringMatcher<16, 8> matcher{"GET", "PUT"};
+    static_assert(!matcher.isInvalid());
+    static_assert(matcher.numStates() == 7);
+
+    CStringMatch match{};
+    TEST_ASSERT_EQUAL_INT(true, matcher.find("x PUT /", 7, match));
+    TEST_ASSERT_EQUAL_INT(1, match.patternId);
+    TEST_ASSERT_EQUAL_INT(2, match.index);
+}
+
+void testCapacityExceeded() {
+    CStringMatcher<4, 8> tooFewStates{"abcd"};
+    TEST_ASSERT_EQUAL_INT(true, tooFewStates.isInvalid());
+
+    CStringMatcher<16, 3> tooFewClasses{"abc"};
+    TEST_ASSERT_EQUAL_INT(true, tooFewClasses.isInvalid());
+
+    CStringMatcher<16, 8> emptyPattern{"a", ""};
+    TEST_ASSERT_EQUAL_INT(true, emptyPattern.isInvalid());
+
+    CStringMatch match{};
+    TEST_ASSERT_EQUAL_INT(false, tooFewStates.find("abcd", 4, match));
+    TEST_ASSERT_EQUAL_INT(false, tooFewStates.findAll("abcd", 4).next(match));
+}
+
+void testDuplicatePatternRetainsId() {
+    CStringMatcher<16, 8> matcher;
+    TEST_ASSERT_EQUAL_INT(0, matcher.addPattern("ab"));
+    TEST_ASSERT_EQUAL_INT(1, matcher.addPattern("b"));
+    TEST_ASSERT_EQUAL_INT(0, matcher.addPattern("ab"));
+    TEST_ASSERT_EQUAL_INT(2, matcher.addPattern("a"));
+    matcher.build();
+    TEST_ASSERT_EQUAL_INT(3, matcher.numPatterns());
+
+    auto matches = matcher.findAll("ab", 2);
+    CStringMatch match{};
+    TEST_ASSERT_EQUAL_INT(true, matches.next(match));
+    TEST_ASSERT_EQUAL_INT(2, match.patternId);
+    TEST_ASSERT_EQUAL_INT(true, matches.next(match));
+    TEST_ASSERT_EQUAL_INT(0, match.patternId);
+    TEST_ASSERT_EQUAL_INT(true, matches.next(match));
+    TEST_ASSERT_EQUAL_INT(1, match.patternId);
+    TEST_ASSERT_EQUAL_INT(false, matches.next(match));
+}
+
+void setUp() {};
+void tearDown() {};
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(testIndexOfAnyPattern);
+    RUN_TEST(testIndexOfAnyPatternReportsMatch);
+    RUN_TEST(testSearchStopsAtEndOfString);
+    RUN_TEST(testFindAllReportsOverlappingMatches);
+    RUN_TEST(testMatchesBruteForce);
+    RUN_TEST(testBuildAtCompileTime);
+    RUN_TEST(testCapacityExceeded);
+    RUN_TEST(testDuplicatePatternRetainsId);
+
+    return UNITY_END();
+}
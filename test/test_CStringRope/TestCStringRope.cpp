@@ -0,0 +1,174 @@
+#include "CStringRope.h"
+#include "CStringSegmentedBuffer.h"
+#include <unity.h>
+
+void testAppendExtendsTopmostSegment() {
+    CStringBuffer<64, 8> buffer;
+    CStringRope<4, 1> rope;
+    TEST_ASSERT_EQUAL_INT(true, rope.addBuffer(buffer));
+    TEST_ASSERT_EQUAL_INT(false, rope.addBuffer(buffer));
+
+    TEST_ASSERT_EQUAL_INT(true, rope.append("HTTP/1.1 "));
+    TEST_ASSERT_EQUAL_INT(true, rope.append("200 OK"));
+    TEST_ASSERT_EQUAL_INT(1, rope.numSegments());
+    TEST_ASSERT_EQUAL_STRING("HTTP/1.1 200 OK", rope.segment(0).raw());
+
+    // the segment is not topmost anymore: a new segment is pushed, earlier content stays in place
+    const char *first = rope.segment(0).raw();
+    CString other = buffer.push("other");
+    TEST_ASSERT_EQUAL_INT(true, rope.append("\r\n", 1));
+    TEST_ASSERT_EQUAL_INT(2, rope.numSegments());
+    TEST_ASSERT_EQUAL_PTR(first, rope.segment(0).raw());
+    TEST_ASSERT_EQUAL_INT(16, rope.length());
+    TEST_ASSERT_EQUAL_INT(true, rope.segment(2).isInvalid());
+
+    TEST_ASSERT_EQUAL_INT(true, rope.appendSegment(other));
+    TEST_ASSERT_EQUAL_INT(3, rope.numSegments());
+    TEST_ASSERT_EQUAL_INT(21, rope.length());
+
+    int length = 0;
+    for (const CString &segment : rope) {
+        length += segment.length();
+    }
+    TEST_ASSERT_EQUAL_INT(21, length);
+
+    rope.clear();
+    TEST_ASSERT_EQUAL_INT(0, rope.numSegments());
+    TEST_ASSERT_EQUAL_INT(0, buffer.numstrings());
+}
+
+void testAppendContinuesInNextBuffer() {
+    CStringBuffer<16, 4> small;
+    CStringSegmentedBuffer<8, 4, 8> segmented;
+    CStringRope<8, 2> rope;
+    rope.addBuffer(small);
+    rope.addBuffer(segmented);
+
+    TEST_ASSERT_EQUAL_INT(true, rope.append("0123456789abcdefghijklmnopqrstuvwxyz"));
+    TEST_ASSERT_EQUAL_INT(36, rope.length());
+    TEST_ASSERT_EQUAL_INT(1, small.numstrings());
+    TEST_ASSERT_EQUAL_STRING("0123456789abcde", rope.segment(0).raw());
+    // chunks of the segmented buffer hold 7 characters each
+    TEST_ASSERT_EQUAL_INT(4, rope.numSegments());
+    TEST_ASSERT_EQUAL_STRING("fghijkl", rope.segment(1).raw());
+    TEST_ASSERT_EQUAL_STRING("mnopqrs", rope.segment(2).raw());
+    TEST_ASSERT_EQUAL_STRING("tuvwxyz", rope.segment(3).raw());
+
+    // exhausted: the part that fits is appended
+    TEST_ASSERT_EQUAL_INT(false, rope.append("0123456789"));
+    TEST_ASSERT_EQUAL_INT(43, rope.length());
+    TEST_ASSERT_EQUAL_INT(false, rope.append("x"));
+}
+
+void testAppendRelocatesLastSegment() {
+    CStringSegmentedBuffer<8, 4, 8> segmented;
+    CStringRope<8, 1> rope;
+    rope.addBuffer(segmented);
+
+    // the chunk holding the last segment is full: extending it moves it into a new chunk
+    CString preceding = segmented.push("xy");
+    TEST_ASSERT_EQUAL_INT(true, rope.append("abcd"));
+    const char *before = rope.segment(0).raw();
+    TEST_ASSERT_EQUAL_INT(true, rope.append("e"));
+    TEST_ASSERT_EQUAL_INT(1, rope.numSegments());
+    TEST_ASSERT_EQUAL_STRING("abcde", rope.segment(0).raw());
+    TEST_ASSERT_NOT_EQUAL(before, rope.segment(0).raw());
+    TEST_ASSERT_EQUAL_STRING("xy", preceding.raw());
+}
+
+void testSearchAcrossSegments() {
+    CStringBuffer<128, 16> buffer;
+    CStringRope<8, 1> rope;
+    rope.addBuffer(buffer);
+    const char *parts[] = {"Content-", "Ty", "p", "e: text/html\r", "\n\r\n"};
+    for (const char *part : parts) {
+        rope.append(part);
+        buffer.push("");
+    }
+    TEST_ASSERT_EQUAL_INT(5, rope.numSegments());
+
+    TEST_ASSERT_EQUAL_INT(0, rope.indexOf("Content"));
+    TEST_ASSERT_EQUAL_INT(8, rope.indexOf("Type"));
+    TEST_ASSERT_EQUAL_INT(5, rope.indexOf("nt-Type:"));
+    TEST_ASSERT_EQUAL_INT(23, rope.indexOf("\r\n\r\n"));
+    TEST_ASSERT_EQUAL_INT(25, rope.indexOf("\r\n", 24));
+    TEST_ASSERT_EQUAL_INT(-1, rope.indexOf("\r\n\r\n\r"));
+    TEST_ASSERT_EQUAL_INT(-1, rope.indexOf("Type", 9));
+    TEST_ASSERT_EQUAL_INT(10, rope.indexOf('p'));
+    TEST_ASSERT_EQUAL_INT(5, rope.indexOf("", 5));
+    TEST_ASSERT_EQUAL_INT('y', rope.charAt(9));
+    TEST_ASSERT_EQUAL_INT('\0', rope.charAt(27));
+
+    TEST_ASSERT_EQUAL_INT(true, rope.startsWith("Content-Type: "));
+    TEST_ASSERT_EQUAL_INT(false, rope.startsWith("Content-Length"));
+    TEST_ASSERT_EQUAL_INT(true, rope.endsWith("html\r\n\r\n"));
+    TEST_ASSERT_EQUAL_INT(false, rope.endsWith("html\r\n"));
+}
+
+void testFlatten() {
+    CStringBuffer<128, 8> buffer;
+    CStringRope<8, 1> rope;
+    rope.addBuffer(buffer);
+    for (const char *part : {"a", "bc", "def"}) {
+        rope.append(part);
+        buffer.push("-");
+    }
+    TEST_ASSERT_EQUAL_INT(3, rope.numSegments());
+
+    CString flat = rope.flatten();
+    TEST_ASSERT_EQUAL_STRING("abcdef", flat.raw());
+    TEST_ASSERT_EQUAL_INT(1, rope.numSegments());
+    TEST_ASSERT_EQUAL_INT(6, rope.length());
+    TEST_ASSERT_EQUAL_INT(4, buffer.numstrings());
+
+    // a single segment is not copied
+    TEST_ASSERT_EQUAL_PTR(flat.raw(), rope.flatten().raw());
+    TEST_ASSERT_EQUAL_INT(true, rope.append("g"));
+    TEST_ASSERT_EQUAL_INT(5, rope.indexOf("fg"));
+}
+
+#ifdef CSTRING_HAS_WRITEV
+void testWriteTo() {
+    CStringBuffer<256, 8> buffer;
+    CStringRope<8, 1> rope;
+    rope.addBuffer(buffer);
+    for (const char *part : {"HTTP/1.1 200 OK\r\n", "", "Content-Length: 2\r\n\r\n", "ok"}) {
+        rope.append(part);
+        buffer.push("");
+    }
+
+    int fds[2];
+    TEST_ASSERT_EQUAL_INT(0, pipe(fds));
+    TEST_ASSERT_EQUAL_INT(rope.length(), rope.writeTo(fds[1]));
+    char received[64] = {};
+    TEST_ASSERT_EQUAL_INT(rope.length(), read(fds[0], received, sizeof(received)));
+    TEST_ASSERT_EQUAL_STRING("HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok", received);
+    close(fds[0]);
+    close(fds[1]);
+
+    iovec iov[2];
+    TEST_ASSERT_EQUAL_INT(-1, rope.toIovec(iov, 2));
+}
+#endif
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(testAppendExtendsTopmostSegment);
+    RUN_TEST(testAppendContinuesInNextBuffer);
+    RUN_TEST(testAppendRelocatesLastSegment);
+    RUN_TEST(testSearchAcrossSegments);
+    RUN_TEST(testFlatten);
+#ifdef CSTRING_HAS_WRITEV
+    RUN_TEST(testWriteTo);
+#endif
+
+    return UNITY_END();
+}
@@ -0,0 +1,131 @@
+#include "CStringSearcher.h"
+#include <unity.h>
+#include <random>
+
+void testIndexOfSearcher() {
+    CStringSearcher searcher("--boundary");
+    CStringBuffer<120, 3> buffer;
+    CString s1 = buffer.push("preamble\r\n--boundary\r\nfirst part\r\n--boundary--");
+    CString s2 = buffer.push("no delimiter here");
+    CString s3 = buffer.push("--boundar");
+
+    TEST_ASSERT_EQUAL_INT(10, searcher.needleLength());
+    TEST_ASSERT_EQUAL_INT(10, s1.indexOf(searcher));
+    TEST_ASSERT_EQUAL_INT(34, s1.indexOf(searcher, 11));
+    TEST_ASSERT_EQUAL_INT(-1, s1.indexOf(searcher, 35));
+    TEST_ASSERT_EQUAL_INT(-1, s1.indexOf(searcher, -1));
+    TEST_ASSERT_EQUAL_INT(-1, s2.indexOf(searcher));
+    TEST_ASSERT_EQUAL_INT(-1, s3.indexOf(searcher));
+    TEST_ASSERT_EQUAL_INT(-1, CString::INVALID.indexOf(searcher));
+}
+
+void testFindShortNeedles() {
+    CStringSearcher empty("");
+    CStringSearcher single("x");
+    CStringSearcher pair("ab");
+
+    TEST_ASSERT_EQUAL_INT(0, empty.find("abc", 3));
+    TEST_ASSERT_EQUAL_INT(2, single.find("abxab", 5));
+    TEST_ASSERT_EQUAL_INT(-1, single.find("abab", 4));
+    TEST_ASSERT_EQUAL_INT(3, pair.find("aaaab", 5));
+    TEST_ASSERT_EQUAL_INT(-1, pair.find("aaaab", 4));
+    TEST_ASSERT_EQUAL_INT(-1, pair.find(nullptr, 4));
+}
+
+void testFindMatchesStringView() {
+    // covers both the vectorized prefilter and the scalar tail for various needles and lengths
+    std::mt19937 random(42);
+    char data[300];
+    const char *needles[] = {"aab", "abab", "ba", "aaaaaaaa", "abcabcabd", "ccccccccccccccccccccb"};
+
+    for (int round = 0; round < 200; ++round) {
+        int length = random() % sizeof(data);
+        for (int i = 0; i < length; ++i) {
+            data[i] = "abc"[random() % 3];
+        }
+
+        for (const char *needle : needles) {
+            CStringSearcher searcher(needle);
+            std::string_view::size_type expected = std::string_view(data, length).find(needle);
+            int actual = searcher.find(data, length);
+            TEST_ASSERT_EQUAL_INT(expected == std::string_view::npos ? -1 : (int)expected, actual);
+        }
+    }
+}
+
+void testSearchStreamFindsMatchWithinChunk() {
+    CStringSearcher searcher("--b");
+    CStringSearchStream stream(searcher);
+    CStringBuffer<40, 2> buffer;
+    CString c1 = buffer.push("data data");
+    CString c2 = buffer.push("xy--b--b");
+
+    TEST_ASSERT_EQUAL_INT(-1, (int)stream.find(c1));
+    TEST_ASSERT_EQUAL_INT(11, (int)stream.find(c2));
+    TEST_ASSERT_EQUAL_INT(17, (int)stream.position());
+    TEST_ASSERT_EQUAL_INT(-1, (int)stream.find(CString::INVALID));
+    TEST_ASSERT_EQUAL_INT(17, (int)stream.position());
+}
+
+void testSearchStreamFindsMatchSpanningChunks() {
+    CStringSearcher searcher("abac");
+    CStringSearchStream stream(searcher);
+
+    // "ab|a|bac": the first partial match "aba" does not continue, but its border "ab" does
+    TEST_ASSERT_EQUAL_INT(-1, (int)stream.find("xab", 3));
+    TEST_ASSERT_EQUAL_INT(-1, (int)stream.find("a", 1));
+    TEST_ASSERT_EQUAL_INT(3, (int)stream.find("bac", 3));
+
+    stream.reset();
+    TEST_ASSERT_EQUAL_INT(0, (int)stream.position());
+    TEST_ASSERT_EQUAL_INT(-1, (int)stream.find("a", 1));
+    TEST_ASSERT_EQUAL_INT(-1, (int)stream.find("b", 1));
+    TEST_ASSERT_EQUAL_INT(-1, (int)stream.find("", 0));
+    TEST_ASSERT_EQUAL_INT(-1, (int)stream.find("a", 1));
+    TEST_ASSERT_EQUAL_INT(0, (int)stream.find("c", 1));
+}
+
+void testSearchStreamMatchesWholeInput() {
+    std::mt19937 random(7);
+    char data[200];
+    CStringSearcher searcher("abaab");
+
+    for (int round = 0; round < 500; ++round) {
+        for (char &c : data) {
+            c = "ab"[random() % 2];
+        }
+
+        // expected: first match ending within each chunk
+        CStringSearchStream stream(searcher);
+        std::string_view whole(data, sizeof(data));
+        for (int pos = 0; pos < (int)sizeof(data);) {
+            int length = std::min((int)(random() % 12), (int)sizeof(data) - pos);
+            std::string_view::size_type expected = whole.find("abaab", pos < 4 ? 0 : pos - 4);
+            bool endsWithinChunk = expected != std::string_view::npos && (int)expected + 5 <= pos + length;
+
+            int64_t actual = stream.find(data + pos, length);
+            TEST_ASSERT_EQUAL_INT(endsWithinChunk ? (int)expected : -1, (int)actual);
+            pos += length;
+        }
+    }
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(testIndexOfSearcher);
+    RUN_TEST(testFindShortNeedles);
+    RUN_TEST(testFindMatchesStringView);
+    RUN_TEST(testSearchStreamFindsMatchWithinChunk);
+    RUN_TEST(testSearchStreamFindsMatchSpanningChunks);
+    RUN_TEST(testSearchStreamMatchesWholeInput);
+
+    return UNITY_END();
+}
@@ -0,0 +1,179 @@
+#include "CStringSegmentedBuffer.h"
+#include <unity.h>
+#include <stdlib.h>
+
+void testPushPlacesStringsInChunks() {
+    CStringSegmentedBuffer<16, 3, 8> buffer;
+    TEST_ASSERT_EQUAL_INT(48, buffer.capacity());
+    TEST_ASSERT_EQUAL_INT(0, buffer.usedChunks());
+
+    CString a = buffer.push("0123456");
+    CString b = buffer.push("abcdef");
+    TEST_ASSERT_EQUAL_INT(1, buffer.usedChunks());
+    TEST_ASSERT_EQUAL_PTR(a.raw() + 8, b.raw());
+    TEST_ASSERT_EQUAL_INT(48 - 15, buffer.unallocatedBytes());
+
+    // does not fit into the rest of the first chunk
+    CString c = buffer.push("xy");
+    TEST_ASSERT_EQUAL_INT(2, buffer.usedChunks());
+    TEST_ASSERT_EQUAL_STRING("xy", c.raw());
+    TEST_ASSERT_EQUAL_INT(32 - 3, buffer.unallocatedBytes());
+    TEST_ASSERT_EQUAL_INT(2, c.bufferIndex());
+
+    // strings are limited to the chunk size
+    TEST_ASSERT_EQUAL_INT(true, buffer.push("0123456789abcdef").isInvalid());
+    TEST_ASSERT_EQUAL_STRING("0123456789abcde", buffer.push("0123456789abcdef", 15).raw());
+    TEST_ASSERT_EQUAL_INT(3, buffer.usedChunks());
+    TEST_ASSERT_EQUAL_INT(true, buffer.push("too long").isInvalid());
+    TEST_ASSERT_EQUAL_INT(true, buffer.allocate().isInvalid());
+    TEST_ASSERT_EQUAL_INT(true, buffer.allocateRemaining().isInvalid());
+}
+
+void testAppendRelocatesTopmostString() {
+    CStringSegmentedBuffer<16, 3, 8> buffer;
+    CString a = buffer.push("aaaa");
+    CString b = buffer.push("bbbb");
+    b += "cc";
+    TEST_ASSERT_EQUAL_INT(1, buffer.usedChunks());
+
+    // only b is copied: a stays in place
+    const char *aRaw = a.raw();
+    b += "dddddd";
+    TEST_ASSERT_EQUAL_STRING("bbbbccdddddd", b.raw());
+    TEST_ASSERT_EQUAL_PTR(aRaw, a.raw());
+    TEST_ASSERT_EQUAL_INT(2, buffer.usedChunks());
+    TEST_ASSERT_EQUAL_INT(16 + 16 - 13, buffer.unallocatedBytes());
+
+    // appending to a moves it to the top
+    a += "!";
+    TEST_ASSERT_EQUAL_STRING("aaaa!", a.raw());
+    TEST_ASSERT_EQUAL_INT(1, a.bufferIndex());
+    TEST_ASSERT_EQUAL_INT(2, buffer.usedChunks());
+    TEST_ASSERT_EQUAL_STRING("bbbbccdddddd", buffer.getRawString(0));
+
+    TEST_ASSERT_EQUAL_STRING("b=12", buffer.pushFormat("b=%d", b.length()).raw());
+    TEST_ASSERT_EQUAL_INT(true, b.append("0123").isInvalid());
+}
+
+void testRemoveReleasesChunks() {
+    CStringSegmentedBuffer<16, 4, 8> buffer;
+    CString a = buffer.push("0123456789");
+    CString b = buffer.push("0123456789");
+    CString c = buffer.push("0123456789");
+    TEST_ASSERT_EQUAL_INT(3, buffer.usedChunks());
+
+    TEST_ASSERT_EQUAL_INT(true, buffer.remove(b));
+    TEST_ASSERT_EQUAL_INT(false, b.isAllocated());
+    TEST_ASSERT_EQUAL_INT(2, buffer.usedChunks());
+    TEST_ASSERT_EQUAL_INT(1, c.bufferIndex());
+
+    TEST_ASSERT_EQUAL_INT(true, buffer.pop());
+    TEST_ASSERT_EQUAL_INT(1, buffer.usedChunks());
+    TEST_ASSERT_EQUAL_INT(64 - 11, buffer.unallocatedBytes());
+    TEST_ASSERT_EQUAL_STRING("abcd", buffer.push("abcd").raw());
+    TEST_ASSERT_EQUAL_PTR(a.raw() + 11, buffer.peek().raw());
+
+    TEST_ASSERT_EQUAL_INT(true, buffer.removeAll());
+    TEST_ASSERT_EQUAL_INT(0, buffer.usedChunks());
+    TEST_ASSERT_EQUAL_INT(64, buffer.unallocatedBytes());
+    TEST_ASSERT_EQUAL_INT(false, a.isAllocated());
+}
+
+void testMoveToTop() {
+    CStringSegmentedBuffer<16, 3, 8> buffer;
+    CString a = buffer.push("aaaaa");
+    CString b = buffer.push("bbbbb");
+    CString c = buffer.push("ccc");
+
+    // no room in the topmost chunk: rotated within the chunk
+    TEST_ASSERT_EQUAL_INT(true, buffer.moveToTop(a));
+    TEST_ASSERT_EQUAL_INT(1, buffer.usedChunks());
+    TEST_ASSERT_EQUAL_STRING("bbbbb", buffer.getRawString(0));
+    TEST_ASSERT_EQUAL_STRING("ccc", buffer.getRawString(1));
+    TEST_ASSERT_EQUAL_STRING("aaaaa", buffer.getRawString(2));
+    TEST_ASSERT_EQUAL_INT(6, buffer.getRawStringCapacity(a));
+
+    // copied to the topmost chunk or a new one, the source chunk is released once empty
+    CString d = buffer.push("ddddddddd");
+    TEST_ASSERT_EQUAL_INT(2, buffer.usedChunks());
+    TEST_ASSERT_EQUAL_INT(true, buffer.moveToTop(c));
+    TEST_ASSERT_EQUAL_INT(true, buffer.moveToTop(b));
+    TEST_ASSERT_EQUAL_INT(3, buffer.usedChunks());
+    TEST_ASSERT_EQUAL_INT(true, buffer.moveToTop(a));
+    TEST_ASSERT_EQUAL_INT(2, buffer.usedChunks());
+    TEST_ASSERT_EQUAL_STRING("ddddddddd", buffer.getRawString(0));
+    TEST_ASSERT_EQUAL_STRING("ccc", buffer.getRawString(1));
+    TEST_ASSERT_EQUAL_STRING("bbbbb", buffer.getRawString(2));
+    TEST_ASSERT_EQUAL_STRING("aaaaa", buffer.getRawString(3));
+    TEST_ASSERT_EQUAL_STRING("aaaaa", a.raw());
+    TEST_ASSERT_EQUAL_INT(3, a.bufferIndex());
+    TEST_ASSERT_EQUAL_STRING("ddddddddd", d.raw());
+    TEST_ASSERT_EQUAL_INT(0, d.bufferIndex());
+}
+
+void testSameSemanticsAsCStringBuffer() {
+    CStringBuffer<1024, 8> expected;
+    CStringSegmentedBuffer<64, 16, 8> actual;
+    CString expectedStrings[8];
+    CString actualStrings[8];
+
+    srand(42);
+    for (int step = 0; step < 5000; ++step) {
+        int slot = rand() % 8;
+        char text[24];
+        snprintf(text, sizeof(text), "%.*s", rand() % 20, "abcdefghijklmnopqrstuvwxyz");
+        switch (rand() % 5) {
+            case 0:
+                expectedStrings[slot] = expected.push(text);
+                actualStrings[slot] = actual.push(text);
+                break;
+            case 1:
+                // strings are limited to the chunk size
+                if (expectedStrings[slot].length() + strlen(text) < 64) {
+                    expectedStrings[slot].append(text);
+                    actualStrings[slot].append(text);
+                }
+                break;
+            case 2:
+                expected.remove(expectedStrings[slot]);
+                actual.remove(actualStrings[slot]);
+                break;
+            case 3:
+                expectedStrings[slot].trimStart("abc");
+                actualStrings[slot].trimStart("abc");
+                break;
+            default:
+                expected.moveToTop(expectedStrings[slot]);
+                actual.moveToTop(actualStrings[slot]);
+        }
+
+        TEST_ASSERT_EQUAL_INT(expected.numstrings(), actual.numstrings());
+        TEST_ASSERT_EQUAL_INT(true, actual.usedChunks() <= actual.numstrings());
+        for (int i = 0; i < expected.numstrings(); ++i) {
+            TEST_ASSERT_EQUAL_STRING(expected.getRawString(i), actual.getRawString(i));
+            TEST_ASSERT_EQUAL_INT(expected.getRawStringCapacity(i), actual.getRawStringCapacity(i));
+        }
+        for (int i = 0; i < 8; ++i) {
+            TEST_ASSERT_EQUAL_INT(expectedStrings[i].isAllocated(), actualStrings[i].isAllocated());
+        }
+    }
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(testPushPlacesStringsInChunks);
+    RUN_TEST(testAppendRelocatesTopmostString);
+    RUN_TEST(testRemoveReleasesChunks);
+    RUN_TEST(testMoveToTop);
+    RUN_TEST(testSameSemanticsAsCStringBuffer);
+
+    return UNITY_END();
+}
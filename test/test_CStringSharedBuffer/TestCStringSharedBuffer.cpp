@@ -0,0 +1,162 @@
+#include "CStringSharedBuffer.h"
+#include <unity.h>
+
+#ifdef CSTRING_HAS_SHM
+#include <sys/wait.h>
+
+char name[64];
+
+void testCreateAndRead() {
+    CStringSharedBuffer writer;
+    TEST_ASSERT_EQUAL_INT(true, writer.create(name, 64, 4));
+    TEST_ASSERT_EQUAL_INT(true, writer.isWritable());
+    CString first = writer.push("first");
+    writer.pushFormat("%d", 2);
+    first += " string";
+    TEST_ASSERT_EQUAL_INT(0, writer.sequence() % 2);
+
+    CStringSharedBuffer reader;
+    TEST_ASSERT_EQUAL_INT(true, reader.open(name));
+    TEST_ASSERT_EQUAL_INT(false, reader.isWritable());
+    TEST_ASSERT_EQUAL_INT(true, reader.push("x").isInvalid());
+
+    const char *strings[4];
+    int lengths[4];
+    int count = 0;
+    TEST_ASSERT_EQUAL_INT(true, reader.read([&](uint8_t index, const char *string, int length) {
+        strings[index] = string;
+        lengths[index] = length;
+        count++;
+    }));
+    TEST_ASSERT_EQUAL_INT(2, count);
+    TEST_ASSERT_EQUAL_STRING("2", strings[0]);
+    TEST_ASSERT_EQUAL_STRING("first string", strings[1]);
+    TEST_ASSERT_EQUAL_INT(12, lengths[1]);
+
+    // read in place: reader and writer map the same memory
+    TEST_ASSERT_EQUAL_INT(true, strings[1] != first.raw());
+    uint32_t sequence = reader.sequence();
+    writer.remove(first);
+    TEST_ASSERT_EQUAL_INT(sequence + 2, reader.sequence());
+    count = 0;
+    TEST_ASSERT_EQUAL_INT(true, reader.read([&](uint8_t index, const char *string, int length) { count++; }));
+    TEST_ASSERT_EQUAL_INT(1, count);
+
+    TEST_ASSERT_EQUAL_INT(true, CStringSharedBuffer::unlink(name));
+}
+
+void testInPlaceModification() {
+    CStringSharedBuffer writer;
+    TEST_ASSERT_EQUAL_INT(true, writer.create(name, 64, 4));
+    CString string = writer.push("Mixed Case");
+    CStringSharedBuffer reader;
+    TEST_ASSERT_EQUAL_INT(true, reader.open(name));
+
+    auto ignore = [](uint8_t index, const char *string, int length) {};
+    writer.beginWrite();
+    string.toLower();
+    writer.beginWrite();
+    string.append("!");
+    writer.endWrite();
+    TEST_ASSERT_EQUAL_INT(false, reader.read(ignore));
+    writer.endWrite();
+    TEST_ASSERT_EQUAL_INT(true, reader.read([&](uint8_t index, const char *string, int length) {
+        TEST_ASSERT_EQUAL_STRING("mixed case!", string);
+    }));
+
+    // unbalanced endWrite() is ignored
+    writer.endWrite();
+    TEST_ASSERT_EQUAL_INT(0, reader.sequence() % 2);
+
+    TEST_ASSERT_EQUAL_INT(true, CStringSharedBuffer::unlink(name));
+}
+
+void testOpenRejectsInvalidSegments() {
+    CStringSharedBuffer reader;
+    TEST_ASSERT_EQUAL_INT(false, reader.open(name));
+
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_TRUNC, 0600);
+    TEST_ASSERT_EQUAL_INT(0, ftruncate(fd, 8));
+    close(fd);
+    TEST_ASSERT_EQUAL_INT(false, reader.open(name));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+
+    fd = shm_open(name, O_RDWR | O_CREAT | O_TRUNC, 0600);
+    TEST_ASSERT_EQUAL_INT(0, ftruncate(fd, 4096));
+    close(fd);
+    TEST_ASSERT_EQUAL_INT(false, reader.open(name));
+    TEST_ASSERT_EQUAL_INT(false, reader.isOpen());
+    TEST_ASSERT_EQUAL_INT(false, reader.read([](uint8_t index, const char *string, int length) {}));
+
+    TEST_ASSERT_EQUAL_INT(false, reader.create(name, 0));
+    TEST_ASSERT_EQUAL_INT(true, CStringSharedBuffer::unlink(name));
+}
+
+void testConcurrentWriterProcess() {
+    constexpr int numSteps = 1000000;
+    CStringSharedBuffer writer;
+    TEST_ASSERT_EQUAL_INT(true, writer.create(name, 1024, 16));
+    CStringSharedBuffer reader;
+    TEST_ASSERT_EQUAL_INT(true, reader.open(name));
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        // the child writes using the inherited mapping: each string is "n:3n", strings are moved and removed while
+        // the parent reads
+        for (int n = 0; n < numSteps; ++n) {
+            if (writer.remainingStrings() == 0 || writer.unallocatedBytes() < 32) {
+                writer.remove(n % writer.numstrings());
+                writer.moveToTop(writer.getCString(0));
+            }
+            writer.pushFormat("%d:%d", n, 3 * n);
+        }
+        _exit(0);
+    }
+
+    int consistentReads = 0;
+    int status = -1;
+    do {
+        bool isConsistent = true;
+        bool isRead = reader.read([&](uint8_t index, const char *string, int length) {
+            char *end;
+            long n = strtol(string, &end, 10);
+            isConsistent &= *end == ':' && strtol(end + 1, &end, 10) == 3 * n && *end == '\0';
+        });
+        if (isRead) {
+            TEST_ASSERT_EQUAL_INT(true, isConsistent);
+            consistentReads++;
+        }
+    } while (waitpid(pid, &status, WNOHANG) == 0);
+    TEST_ASSERT_EQUAL_INT(0, status);
+    TEST_ASSERT_EQUAL_INT(true, consistentReads > 0);
+    TEST_ASSERT_EQUAL_INT(true, reader.read([&](uint8_t index, const char *string, int length) {}));
+
+    TEST_ASSERT_EQUAL_INT(true, CStringSharedBuffer::unlink(name));
+}
+#endif
+
+void setUp() {
+#ifdef CSTRING_HAS_SHM
+    snprintf(name, sizeof(name), "/TestCStringSharedBuffer%d", (int)getpid());
+#endif
+}
+
+void tearDown() {
+#ifdef CSTRING_HAS_SHM
+    shm_unlink(name);
+#endif
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+
+#ifdef CSTRING_HAS_SHM
+    RUN_TEST(testCreateAndRead);
+    RUN_TEST(testInPlaceModification);
+    RUN_TEST(testOpenRejectsInvalidSegments);
+    RUN_TEST(testConcurrentWriterProcess);
+#endif
+
+    return UNITY_END();
+}
@@ -0,0 +1,167 @@
+#include "CStringThreadPool.h"
+#include <unity.h>
+
+#ifdef CSTRING_HAS_THREADS
+typedef CStringBuffer<4096, 80> Buffer;
+
+void fill(Buffer &buffer) {
+    for (int i = 0; i < 64; ++i) {
+        buffer.pushFormat("  Line %d: HELLO World hello  ", i);
+    }
+}
+
+void testRunEachTaskOnce() {
+    CStringThreadPool<4> pool(4);
+    TEST_ASSERT_EQUAL_INT(4, pool.numThreads());
+
+    std::atomic<int> runs[100]{};
+    for (int job = 0; job < 10; ++job) {
+        pool.run(100, [&](int task) { runs[task]++; });
+    }
+    for (std::atomic<int> &run : runs) {
+        TEST_ASSERT_EQUAL_INT(10, run.load());
+    }
+
+    // no tasks
+    pool.run(0, [&](int task) { runs[0]++; });
+    TEST_ASSERT_EQUAL_INT(10, runs[0].load());
+}
+
+void testNumThreadsLimited() {
+    TEST_ASSERT_EQUAL_INT(1, CStringThreadPool<4>(0).numThreads());
+    TEST_ASSERT_EQUAL_INT(4, CStringThreadPool<4>(100).numThreads());
+
+    CStringThreadPool<1> single;
+    int sum = 0;
+    single.run(4, [&](int task) { sum += task; });
+    TEST_ASSERT_EQUAL_INT(6, sum);
+}
+
+void testForEachParallel() {
+    static Buffer buffer;
+    fill(buffer);
+    CStringThreadPool<4> pool(4);
+
+    buffer.forEachParallel(pool, [](CString &string) { string.toUpper(); });
+    for (int i = 0; i < buffer.numstrings(); ++i) {
+        char expected[64];
+        snprintf(expected, sizeof(expected), "  LINE %d: HELLO WORLD HELLO  ", i);
+        TEST_ASSERT_EQUAL_STRING(expected, buffer.getRawString(i));
+    }
+
+    // strings passed by handle
+    CString top = buffer.peek();
+    buffer.forEachParallel(pool, [&](CString &string) {
+        if (string.raw() == top.raw()) {
+            string.clear();
+        }
+    });
+    TEST_ASSERT_EQUAL_STRING("", top.raw());
+}
+
+void testForEachParallelSharedAreas() {
+    static Buffer buffer;
+    fill(buffer);
+    CStringThreadPool<4> pool(4);
+    CString first = buffer.getCString(0);
+    CString clone = first.cloneShared();
+    CString clone2 = first.cloneShared();
+    TEST_ASSERT_EQUAL_INT(64, buffer.numstrings());
+
+    // shared areas are copied before fn is invoked, each CString is passed once
+    std::atomic<int> invocations{0};
+    TEST_ASSERT_EQUAL_INT(true, buffer.forEachParallel(pool, [&](CString &string) {
+        invocations++;
+        if (string.raw() == clone.raw()) {
+            string.toLower();
+        }
+    }));
+    TEST_ASSERT_EQUAL_INT(66, invocations.load());
+    TEST_ASSERT_EQUAL_INT(66, buffer.numstrings());
+    TEST_ASSERT_EQUAL_STRING("  line 0: hello world hello  ", clone.raw());
+    TEST_ASSERT_EQUAL_STRING("  Line 0: HELLO World hello  ", first.raw());
+    TEST_ASSERT_EQUAL_STRING("  Line 0: HELLO World hello  ", clone2.raw());
+
+    // without capacity to copy, fn is not invoked
+    CStringBuffer<16, 4> full;
+    CString shared = full.push("ABCDEFGHIJ");
+    CString sharedClone = shared.cloneShared();
+    TEST_ASSERT_EQUAL_INT(false, full.forEachParallel(pool, [&](CString &string) { invocations++; }));
+    TEST_ASSERT_EQUAL_INT(66, invocations.load());
+    TEST_ASSERT_EQUAL_PTR(shared.raw(), sharedClone.raw());
+
+    // in-place bulk operations convert a shared area once for all sharers
+    full.toLowerAll(pool);
+    TEST_ASSERT_EQUAL_STRING("abcdefghij", shared.raw());
+    TEST_ASSERT_EQUAL_STRING("abcdefghij", sharedClone.raw());
+    TEST_ASSERT_EQUAL_INT(1, full.countMatches(pool, "abc"));
+}
+
+void testToLowerAll() {
+    static Buffer buffer;
+    fill(buffer);
+    buffer.push("ÄBC@[`{");
+    CStringThreadPool<4> pool(4);
+
+    buffer.toLowerAll(pool);
+    TEST_ASSERT_EQUAL_STRING("  line 0: hello world hello  ", buffer.getRawString(0));
+    TEST_ASSERT_EQUAL_STRING("  line 17: hello world hello  ", buffer.getRawString(17));
+    TEST_ASSERT_EQUAL_STRING("Äbc@[`{", buffer.getRawString(64));
+}
+
+void testTrimAll() {
+    static Buffer buffer;
+    fill(buffer);
+    CStringThreadPool<4> pool(4);
+    CString line = buffer.pushFormat("\t line \n");
+    int unallocated = buffer.unallocatedBytes();
+
+    TEST_ASSERT_EQUAL_INT(64 * 4 + 4, buffer.trimAll(pool));
+    TEST_ASSERT_EQUAL_INT(unallocated + 64 * 4 + 4, buffer.unallocatedBytes());
+    TEST_ASSERT_EQUAL_STRING("Line 0: HELLO World hello", buffer.getRawString(0));
+    TEST_ASSERT_EQUAL_STRING("Line 63: HELLO World hello", buffer.getRawString(63));
+    TEST_ASSERT_EQUAL_STRING("line", line.raw());
+    TEST_ASSERT_EQUAL_INT(5, line.rawCapacity());
+}
+
+void testCountMatches() {
+    static Buffer buffer;
+    fill(buffer);
+    buffer.push("aaaa");
+    CStringThreadPool<4> pool(4);
+
+    TEST_ASSERT_EQUAL_INT(64, buffer.countMatches(pool, "hello"));
+    TEST_ASSERT_EQUAL_INT(64, buffer.countMatches(pool, "LLO"));
+    TEST_ASSERT_EQUAL_INT(1, buffer.countMatches(pool, "Line 42:"));
+    TEST_ASSERT_EQUAL_INT(2, buffer.countMatches(pool, "aa"));
+    TEST_ASSERT_EQUAL_INT(0, buffer.countMatches(pool, "xyz"));
+    TEST_ASSERT_EQUAL_INT(0, buffer.countMatches(pool, ""));
+    TEST_ASSERT_EQUAL_INT(0, buffer.countMatches(pool, nullptr));
+
+    Buffer empty;
+    TEST_ASSERT_EQUAL_INT(0, empty.countMatches(pool, "hello"));
+}
+#endif
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+
+#ifdef CSTRING_HAS_THREADS
+    RUN_TEST(testRunEachTaskOnce);
+    RUN_TEST(testNumThreadsLimited);
+    RUN_TEST(testForEachParallel);
+    RUN_TEST(testForEachParallelSharedAreas);
+    RUN_TEST(testToLowerAll);
+    RUN_TEST(testTrimAll);
+    RUN_TEST(testCountMatches);
+#endif
+
+    return UNITY_END();
+}